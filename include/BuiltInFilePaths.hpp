@@ -1,6 +1,7 @@
 namespace BuiltInFilePaths {
     inline auto AIN_MEM="ainmem.ain";
     inline auto AIN_IO="ainio.ain";
+    inline auto AIN_IN="ainin.ain";
     inline auto CHARS_ITERATOR="chars_iterator.ain";
     inline auto MATH_FREXP="math/frexp.ain";
     inline auto MATH_FREXP10="math/frexp10.ain";
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SharedPtrTypes.hpp"
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -28,6 +29,9 @@ namespace Assembler {
             PUSH,
             POP,
             MOV,
+            MOVSX,
+            MOVZX,
+            MOVSXD,
             LEA,
             ADD,
             SUB,
@@ -81,10 +85,13 @@ namespace Assembler {
             CDQE,
             CWD,
             CDQ,
+            CQO,
             CMOVZ,
             CMOVNZ,
             CMOVS,
             CMOVG,
+            BSWAP,
+            XCHG,
             // SIMD
             MOVQ,
             MOVD,
@@ -106,6 +113,59 @@ namespace Assembler {
             DIVSS,
             ROUNDSD,
             ROUNDSS,
+            // Packed SIMD
+            MOVDQU,
+            MOVDQA,
+            PSHUFD,
+            PSRLDQ,
+            PADDB,
+            PADDW,
+            PADDD,
+            PADDQ,
+            PSUBB,
+            PSUBW,
+            PSUBD,
+            PSUBQ,
+            PAND,
+            POR,
+            PXOR,
+            ADDPS,
+            SUBPS,
+            MULPS,
+            DIVPS,
+            ADDPD,
+            SUBPD,
+            MULPD,
+            DIVPD,
+            // AVX2, the packed operations are in the order of their SSE forms and take the destination and two sources
+            VMOVDQU,
+            VPADDB,
+            VPADDW,
+            VPADDD,
+            VPADDQ,
+            VPSUBB,
+            VPSUBW,
+            VPSUBD,
+            VPSUBQ,
+            VPAND,
+            VPOR,
+            VPXOR,
+            VADDPS,
+            VSUBPS,
+            VMULPS,
+            VDIVPS,
+            VADDPD,
+            VSUBPD,
+            VMULPD,
+            VDIVPD,
+            VPBROADCASTD,
+            VPBROADCASTQ,
+            VEXTRACTI128,
+            VZEROUPPER,
+            REP_MOVSB,
+            REP_STOSB,
+            PCMPEQB,
+            PMOVMSKB,
         };
 
         enum InstructionSize{
@@ -120,6 +180,9 @@ namespace Assembler {
         InstructionSize size=IMPLICIT;
         std::vector<AsmOperand> operands;
         std::wstring comment=L"";
+        const char* getName();
+        // Writes the text in UTF-8 without building the whole text first
+        void writeAsmText(std::ostream& out, bool showComment=true);
         std::wstring getAsmText(bool showComment=true);
 
     };
@@ -130,7 +193,16 @@ namespace Assembler {
         std::wstring comment=L"";
         void operator+=(AsmInstruction instruction);
         void operator+=(std::vector<AsmInstruction> instructions);
-        std::wstring getAsmText();
+        void writeAsmText(std::ostream& out);
+    };
+
+    // A labeled array of values in the data section, or of reserved values in the bss section when it has no values
+    struct AsmData{
+        std::wstring label;
+        AsmInstruction::InstructionSize size; // of each value
+        std::vector<long long> values;
+        int reservedSize=0; // The count of the reserved values
+        void writeAsmText(std::ostream& out);
     };
 
     AsmInstruction localLabel(std::wstring label, std::wstring comment=L"");
@@ -139,6 +211,10 @@ namespace Assembler {
     AsmInstruction push(AsmOperand op, std::wstring comment=L"");
     AsmInstruction pop(AsmOperand op, std::wstring comment=L"");
     AsmInstruction mov(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
+    // The size of movsx, movzx and movsxd is the size of the source
+    AsmInstruction movsx(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
+    AsmInstruction movzx(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
+    AsmInstruction movsxd(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
     AsmInstruction lea(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
     AsmInstruction add(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
     AsmInstruction sub(AsmOperand d, AsmOperand s, std::wstring comment=L"");
@@ -162,13 +238,19 @@ namespace Assembler {
     AsmInstruction jns(AsmOperand label, std::wstring comment=L"");
     AsmInstruction jl(AsmOperand label, std::wstring comment=L"");
     AsmInstruction jge(AsmOperand label, std::wstring comment=L"");
+    AsmInstruction jg(AsmOperand label, std::wstring comment=L"");
+    AsmInstruction jle(AsmOperand label, std::wstring comment=L"");
+    AsmInstruction ja(AsmOperand label, std::wstring comment=L"");
+    AsmInstruction jae(AsmOperand label, std::wstring comment=L"");
     AsmInstruction jb(AsmOperand label, std::wstring comment=L"");
+    AsmInstruction jbe(AsmOperand label, std::wstring comment=L"");
     AsmInstruction inc(AsmOperand d, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
     AsmInstruction dec(AsmOperand d, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
     AsmInstruction neg(AsmOperand d, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
     AsmInstruction _not(AsmOperand d, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
     AsmInstruction mul(AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
     AsmInstruction imul(AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
+    AsmInstruction imul(AsmOperand d, AsmOperand s, std::wstring comment=L"");
     AsmInstruction div(AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
     AsmInstruction idiv(AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
     AsmInstruction setz(AsmOperand s, std::wstring comment=L"");
@@ -188,10 +270,13 @@ namespace Assembler {
     AsmInstruction cdqe(std::wstring comment=L"");
     AsmInstruction cwd(std::wstring comment=L"");
     AsmInstruction cdq(std::wstring comment=L"");
+    AsmInstruction cqo(std::wstring comment=L"");
     AsmInstruction cmovz(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
     AsmInstruction cmovnz(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
     AsmInstruction cmovs(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
     AsmInstruction cmovg(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
+    AsmInstruction bswap(AsmOperand d, std::wstring comment=L"");
+    AsmInstruction xchg(AsmOperand d, AsmOperand s, std::wstring comment=L"");
 
     // SIMD
     AsmInstruction movq(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size=AsmInstruction::IMPLICIT, std::wstring comment=L"");
@@ -215,6 +300,27 @@ namespace Assembler {
     AsmInstruction roundsd(AsmOperand d, AsmOperand s, int roundingMode, std::wstring comment=L"");
     AsmInstruction roundss(AsmOperand d, AsmOperand s, int roundingMode, std::wstring comment=L"");
 
+    // Packed SIMD
+    AsmInstruction movdqu(AsmOperand d, AsmOperand s, std::wstring comment=L"");
+    AsmInstruction movdqa(AsmOperand d, AsmOperand s, std::wstring comment=L"");
+    AsmInstruction pshufd(AsmOperand d, AsmOperand s, int order, std::wstring comment=L"");
+    // Shifts the whole register right by bytes
+    AsmInstruction psrldq(AsmOperand d, int bytes, std::wstring comment=L"");
+    // One of the packed arithmetic operations from PADDB to DIVPD, or PCMPEQB
+    AsmInstruction packed(AsmInstruction::InstructionType type, AsmOperand d, AsmOperand s, std::wstring comment=L"");
+
+    // AVX2
+    AsmInstruction vmovdqu(AsmOperand d, AsmOperand s, std::wstring comment=L"");
+    // One of the packed arithmetic operations from VPADDB to VDIVPD
+    AsmInstruction vpacked(AsmInstruction::InstructionType type, AsmOperand d, AsmOperand s1, AsmOperand s2, std::wstring comment=L"");
+    AsmInstruction vpbroadcastd(AsmOperand d, AsmOperand s, std::wstring comment=L"");
+    AsmInstruction vpbroadcastq(AsmOperand d, AsmOperand s, std::wstring comment=L"");
+    AsmInstruction vextracti128(AsmOperand d, AsmOperand s, int half, std::wstring comment=L"");
+    AsmInstruction vzeroupper(std::wstring comment=L"");
+    AsmInstruction repMovsb(std::wstring comment=L"");
+    AsmInstruction repStosb(std::wstring comment=L"");
+    AsmInstruction pmovmskb(AsmOperand d, AsmOperand s, std::wstring comment=L"");
+
     AsmInstruction reserveSpaceOnStack(int size, std::wstring comment=L"");
     AsmInstruction removeReservedSpaceFromStack(int size, std::wstring comment=L"");
     std::vector<AsmInstruction> exit(int errorCode, std::wstring comment=L"");
@@ -226,6 +332,8 @@ namespace Assembler {
 
     AsmOperand XMM0();
     AsmOperand XMM1();
+    AsmOperand XMM(int number);
+    AsmOperand YMM(int number);
     AsmOperand RAX(int size=AsmInstruction::QWORD);
     AsmOperand RBX(int size=AsmInstruction::QWORD);
     AsmOperand RCX(int size=AsmInstruction::QWORD);
@@ -238,6 +346,10 @@ namespace Assembler {
     AsmOperand R9(int size=AsmInstruction::QWORD);
     AsmOperand R10(int size=AsmInstruction::QWORD);
     AsmOperand R11(int size=AsmInstruction::QWORD);
+    AsmOperand R12(int size=AsmInstruction::QWORD);
+    AsmOperand R13(int size=AsmInstruction::QWORD);
+    AsmOperand R14(int size=AsmInstruction::QWORD);
+    AsmOperand R15(int size=AsmInstruction::QWORD);
     AsmOperand brk_end();
 
     AsmInstruction::InstructionSize size(int size);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include "ASTVisitor.hpp"
@@ -40,38 +41,56 @@
 #include "ThisVarAccessExpression.hpp"
 #include "ThisFunInvokeExpression.hpp"
 #include "Assembler.hpp"
+#include "IRCompiler.hpp"
 
 class BuiltInFunScope;
 
 class Compiler:public ASTVisitor{
+    friend class IRCompiler;
+    friend class LoopVectorizer;
     private:
         int funLabelsSize=0; // for numbering labels for functions
         int constructorLabelsSize=0; // for numbering labels for constructors
         int methodLabelsSize=0; // for numbering labels for methods in all classes
         int currentLoopLabelsSize=0; // for numbering labels for loops in a function
         int currentLogicalShortcutsLabelsSize=0; // for numbering labels for logical shortcuts in a bool expression
-        std::wstring dataAsm=
-            L"section .data\n"
-            L"\tbrk_end dq 0\n";
-        std::wstring bssAsm=L"";
-        std::wstring textAsm=
-            L"section .text\n"
-            L"\tglobal _start"  // new line will be added in getAssemblyFile()
+        std::vector<Assembler::AsmData> rodataAsm;
+        std::unordered_map<std::wstring, std::wstring> stringLiteralsLabels; // The label of each string literal in the read-only data
+        std::unordered_map<NewArrayExpression*, std::wstring> constantArraysLabels; // The label of each constant array in the read-only data
+        std::vector<Assembler::AsmData> dataAsm={
+            Assembler::AsmData{.label=L"brk_end", .size=Assembler::AsmInstruction::QWORD, .values={0}}
+        };
+        std::vector<Assembler::AsmData> bssAsm;
+        const char* textAsm=
+            "section .text\n"
+            "\tglobal _start"  // new line will be added in writeAssemblyFile()
         ;
 
         std::unordered_map<StmListScope*, Assembler::AsmLabel> labelsAsm; // first of pair is for label name, second for the full label's text
+        std::unordered_map<FunScope*, Assembler::AsmLabel> stackArgsLabelsAsm; // The entries of the functions for the hand-written calls that pass the args on the stack
+
+        std::vector<std::unique_ptr<IRCompiler>> irCompilers; // The functions compiled from the IR, their asm is generated in parallel by getFinalLabels()
 
         std::unordered_map<Variable*, void*> inUseGlobalVariables; // The global variable that are accessed in the user code, we count them to optimize the asm
 
         FunScope* AIN_ALLOC=NULL;
         FunScope* AIN_REALLOC=NULL;
-        FunScope* AIN_MEMCPY=NULL;
         FunScope* AIN_ALLOCATE_ARRAY=NULL;
+        FunScope* AIN_WRITE=NULL;
+        FunScope* AIN_WRITE_LINE=NULL;
+        FunScope* AIN_EXIT=NULL;
+        FunScope* AIN_READ=NULL;
+        FunScope* AIN_READ_LINE=NULL;
 
         Assembler::AsmLabel* currentAsmLabel=NULL;
         Assembler::AsmLabel* startAsmLabel=NULL;
         Assembler::AsmLabel* initAsmLabel=NULL;
+        std::vector<Assembler::AsmLabel> finalLabels;
         
+        // Adds the init to the start, compiles the functions from the IR and optimizes the labels, only the first call compiles them
+        std::vector<Assembler::AsmLabel>& getFinalLabels();
+        // Adds the global variable to the bss section the first time it's accessed
+        void useGlobalVariable(Variable* var);
         int getVariableSize(Variable* var);
         int getVariablesSize(SharedMap<std::wstring, SharedVariable> vars);
         void optimizeConditionalJumpInstruction(IExpression* condition, Assembler::AsmOperand label, std::wstring comment=L"");
@@ -85,6 +104,11 @@ class Compiler:public ASTVisitor{
         void addInstructionToConvertBetweenDataTypes(int fromSize, int toSize, bool isUnsigned);
 
         void callFunAsm(FunScope* fun, SharedVector<SharedIExpression> args, bool insideCall=false);
+        // Evaluating the arg changes only RAX and doesn't depend on the other args
+        bool isRegisterSafeArg(IExpression* ex);
+        int getStackParamsSize(FunScope* fun);
+        // The label to call the function with all the args on the stack, it moves the register params from the stack first
+        std::wstring getStackArgsLabel(FunScope* fun);
 
         void invokeNonStaticFun(NonStaticFunInvokeExpression* ex);
         void invokeNonStaticBuiltInFun(NonStaticFunInvokeExpression* ex);
@@ -93,6 +117,11 @@ class Compiler:public ASTVisitor{
         void leftAssign(IExpression* ex);
         void rightAssign(IExpression* ex);
 
+        // Writes the elements of the constant array in the read-only data and returns its label
+        std::wstring addConstantArrayData(NewArrayExpression* ex);
+        // The bytes of the literal as they are in memory
+        static unsigned long long getLiteralBits(LiteralExpression* ex);
+
         void addArrayGetOpAsm(int arrayElementSize);
         void addArraySetOpAsm(int arrayElementSize);
 
@@ -115,8 +144,13 @@ class Compiler:public ASTVisitor{
 
         std::wstring addAinAllocAsm();
         std::wstring addAinReAllocAsm();
-        std::wstring addAinMemcpyAsm();
         std::wstring addAinAllocateArrayAsm();
+        // The output is buffered in ainio.ain, every exit of the program goes through أنه_البرنامج that flushes it
+        std::wstring addAinWriteAsm(bool isLine=false);
+        std::wstring addAinExitAsm();
+        std::vector<Assembler::AsmInstruction> exitAsm(int errorCode, std::wstring comment=L"");
+        // The input is read from the buffer of ainin.ain, the functions return the address of a new string
+        std::wstring addAinReadAsm(bool isLine=false);
 
         void visit(PackageScope* scope)override;
         void visit(FileScope* scope)override;
@@ -150,8 +184,12 @@ class Compiler:public ASTVisitor{
         void visit(ThisVarAccessExpression* ex)override;
         void visit(ThisFunInvokeExpression* ex)override;
 
-        std::wstring getAssemblyFile();
+        // Streams the asm in UTF-8 label by label, so the whole file isn't built in memory
+        void writeAssemblyFile(std::ostream& out);
+        std::string getExecutableFile();
 
         std::unordered_map<Variable*, CompilerVarsOffsetSetter::Offset> offsets;
 
+        bool isAvx2Enabled=false; // The vectorized loops use the 256 bits registers instead of SSE2
+
 };
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "WhileStatement.hpp"
 #include "DoWhileStatement.hpp"
 #include <string>
+#include <vector>
 class CompilerVarsOffsetSetter:public ASTVisitor{
     public:
         struct Offset{
@@ -17,6 +18,14 @@ class CompilerVarsOffsetSetter:public ASTVisitor{
             Assembler::AsmOperand reg;
             int value=0;
         };
+        using Register=Assembler::AsmOperand(*)(int size);
+
+        // The first params are passed in these registers and the rest on the stack, the callee saves them in its frame
+        static const std::vector<Register> PARAMS_REGISTERS;
+
+        // The built-in functions and the ones that use inline asm read all their params from the stack
+        static bool hasRegisterParams(FunScope* scope);
+
         std::unordered_map<Variable*, Offset>* offsets;
         CompilerVarsOffsetSetter(
             std::unordered_map<Variable*, Offset>* offsets
@@ -25,6 +34,7 @@ class CompilerVarsOffsetSetter:public ASTVisitor{
         int stmListScopeOffset;
         int globalVarsCounter=0; // 1st address in data segment
         void offsetStmListScope(StmListScope* scope);
+        static bool hasInlineAsm(StmListScope* scope);
         void visit(PackageScope* scope)override;
         void visit(FileScope* scope)override;
         void visit(ClassScope* scope)override;
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Writes static x86-64 executables without section headers.
+ * The text is loaded at TEXT_ADDRESS, the read-only data and the data are loaded each in the pages after the previous one,
+ * and the bss follows the data.
+*/
+namespace Elf {
+
+    struct Image{
+        std::vector<uint8_t> text;
+        std::vector<uint8_t> rodata;
+        std::vector<uint8_t> data;
+        uint64_t bssSize=0;
+        uint64_t entry=0; // The address of the first instruction to run
+    };
+
+    const uint64_t BASE_ADDRESS=0x400000;
+    const uint64_t PAGE_SIZE=0x1000;
+    const uint64_t TEXT_ADDRESS=BASE_ADDRESS+PAGE_SIZE;
+
+    // The read-only data starts at the first page after the text
+    uint64_t getRodataAddress(uint64_t textSize);
+
+    // The data starts at the first page after the read-only data
+    uint64_t getDataAddress(uint64_t textSize, uint64_t rodataSize);
+
+    // The bytes of the executable file
+    std::string getExecutable(Image& image);
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Assembler.hpp"
+#include "Elf.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Encodes the labels to x86-64 machine code and lays out the read-only data, the data and the bss after it,
+ * the symbols are resolved to their addresses in the executable, so the image is written as it's without linking.
+ * The inline asm is parsed to instructions first, so it can use only the supported instructions.
+*/
+class Encoder{
+    public:
+        Encoder(
+            std::vector<Assembler::AsmLabel>* labels,
+            std::vector<Assembler::AsmData>* rodata,
+            std::vector<Assembler::AsmData>* data,
+            std::vector<Assembler::AsmData>* bss
+        );
+        Elf::Image encode();
+
+        // Parses the lines of the asm, a line ending with a colon is a label
+        static std::vector<Assembler::AsmInstruction> parse(std::wstring _asm);
+
+    private:
+        struct Operand;
+        class InstructionBuilder;
+
+        // A value that is known after the layout, written in the bytes of an instruction
+        struct Fixup{
+            int offset; // From the start of the instruction
+            int size;
+            bool isRelative; // To the end of the instruction
+            std::wstring symbol;
+            int64_t addend;
+        };
+
+        // An encoded instruction, or a label when the bytes are empty
+        struct Chunk{
+            std::wstring label;
+            std::vector<uint8_t> bytes;
+            std::vector<Fixup> fixups;
+            // The jumps to labels are encoded after the layout, in 2 bytes when the target is near
+            bool isJump=false;
+            int condition=-1; // The condition code, or -1 for jmp
+            std::wstring target;
+            bool isNear=true;
+            uint64_t address=0;
+            int getSize();
+        };
+
+        std::vector<Assembler::AsmLabel>* labels;
+        std::vector<Assembler::AsmData>* rodata;
+        std::vector<Assembler::AsmData>* data;
+        std::vector<Assembler::AsmData>* bss;
+        std::vector<Chunk> chunks;
+        std::unordered_map<std::wstring, uint64_t> symbols;
+
+        // The labels are encoded in parallel, each in its own chunks
+        std::vector<Chunk> encodeLabel(Assembler::AsmLabel& label);
+        // The local labels belong to [currentLabel], it changes when a global label is in the inline asm
+        void addInstruction(Assembler::AsmInstruction instruction, std::vector<Chunk>& chunks, std::wstring& currentLabel);
+        Chunk encodeInstruction(Assembler::AsmInstruction instruction, std::wstring& currentLabel);
+        Operand parseOperand(Assembler::AsmOperand operand, std::wstring& currentLabel);
+        // Gives the chunks their addresses, the far jumps are found until none is added
+        void layout();
+        void layoutData(Elf::Image& image, uint64_t textSize);
+        // Writes the values of the entries to the bytes that are loaded at the address
+        void layoutValues(std::vector<Assembler::AsmData>& entries, std::vector<uint8_t>& bytes, uint64_t address);
+        void writeChunk(Chunk& chunk, std::vector<uint8_t>& text);
+        // The local labels are prefixed with the label they belong to
+        static std::wstring getSymbol(std::wstring name, std::wstring& currentLabel);
+        uint64_t getAddress(std::wstring symbol);
+};
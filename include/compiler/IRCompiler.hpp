@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Assembler.hpp"
+#include "IR.hpp"
+#include "SharedPtrTypes.hpp"
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Compiler;
+class Variable;
+
+/*
+ * Generates the asm of a function lowered to the IR to its label.
+ * The changes to the compiler are done by prepare(), so compile() only writes to the label and the functions are compiled in parallel.
+ * The values are kept in the registers given by RegisterAllocator and the rest are spilled to 8 bytes slots in the frame,
+ * the params and the calls use the same registers and stack layout of the AST code generator, so the functions compiled by both can call each other.
+ * RAX, RCX and RDX are left for the instructions that need them.
+*/
+class IRCompiler{
+    public:
+        IRCompiler(Compiler* compiler, std::unique_ptr<IR::Function> fun, Assembler::AsmLabel* asmLabel);
+        // Returns false without changing the compiler if the function can't be compiled from the IR,
+        // otherwise generates the callees, adds the used globals and generates the asm of the built-in callees
+        bool prepare();
+        // Only writes to the label of the function, so it can run in parallel with the other functions
+        void compile();
+
+    private:
+        using Register=Assembler::AsmOperand(*)(int size);
+
+        // The registers that may be changed by a call come first, the called functions don't change the rest
+        static const std::vector<Register> REGISTERS;
+        static const int SCRATCH_REGISTERS_SIZE=6;
+
+        Compiler* compiler;
+        std::unique_ptr<IR::Function> fun;
+        Assembler::AsmLabel* asmLabel;
+        std::vector<IR::BasicBlock*> order;
+        std::unordered_map<IR::Instruction*, Register> registers;
+        std::unordered_map<IR::Instruction*, int> slots; // The offsets of the spilled values from RBP
+        std::vector<std::pair<Register, int>> savedRegisters; // The preserved registers used by the function and their slots
+        std::unordered_map<IR::Instruction*, int> usesCount;
+        std::unordered_set<Variable*> registerParams; // Moved from their registers at the start of the function
+        std::unordered_map<IR::Instruction*, std::vector<Assembler::AsmInstruction>> builtInsAsm; // The asm of the calls to the built-in functions
+
+        void emit(Assembler::AsmInstruction instruction);
+        void emit(std::vector<Assembler::AsmInstruction> instructions);
+
+        void countUses();
+        // The compare is emitted with the branch that uses it instead of being saved
+        bool isFusedCompare(IR::Instruction* instruction);
+        bool needsLocation(IR::Instruction* instruction);
+        void assignLocations();
+
+        void compileRegisterParams();
+        void compileBlock(int index);
+        void compileInstruction(IR::Instruction* instruction);
+        void compileBinaryOp(IR::Instruction* instruction);
+        void compileDivOrMod(IR::Instruction* instruction);
+        void compileShift(IR::Instruction* instruction);
+        void compileCall(IR::Instruction* instruction);
+        void compileRegisterArgs(IR::Instruction* instruction);
+        void compileCompare(IR::Instruction* instruction);
+        void compilePhiCopies(IR::BasicBlock* from, IR::BasicBlock* to);
+        void compileBranch(IR::BasicBlock* block, IR::BasicBlock* next);
+        void compileReturn(IR::BasicBlock* block);
+
+        Assembler::AsmOperand getBlockLabel(IR::BasicBlock* block);
+        bool isInRegister(IR::Instruction* value);
+        Assembler::AsmOperand getLocation(IR::Instruction* value);
+        // The register of the value, or RAX if it's spilled
+        Register getResultRegister(IR::Instruction* value);
+        // The register holding the value, after loading it to RAX if it's not in a register
+        Register getValueRegister(IR::Instruction* value);
+        void move(Register reg, IR::Instruction* value);
+        // An imm if the value is a small constant, its location otherwise
+        Assembler::AsmOperand getSourceOperand(IR::Instruction* value);
+        void setResult(IR::Instruction* instruction, Register reg);
+        void emitCompare(IR::Instruction* compare);
+        // Moves to each register the value of its pair at the same time, using RAX to break the cycles
+        void emitParallelMoves(std::vector<std::pair<Register, Register>> moves);
+        // Sign or zero extends the register from the size of the type to 64 bits
+        void extend(SharedType type, Register reg);
+        void zeroExtend(int size, Register reg);
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Assembler.hpp"
+#include "IExpression.hpp"
+#include "IStatement.hpp"
+#include "OperatorFunInvokeExpression.hpp"
+#include "SharedPtrTypes.hpp"
+#include "VarAccessExpression.hpp"
+#include "WhileStatement.hpp"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Compiler;
+class Variable;
+
+/*
+ * Vectorizes the counted loops over arrays like "طالما(ن<ل){م[ن]=ب[ن]+ج ن++}",
+ * the body can only set and read the elements at the counter and add integers to variables before incrementing the counter.
+ * The vector loop is emitted before the scalar loop of the compiler and processes the full vectors,
+ * then the scalar loop continues from the counter it reached, so it runs the remaining elements.
+ * SSE2 is used by default, and AVX2 when the compiler is asked to use it.
+*/
+class LoopVectorizer{
+    public:
+        LoopVectorizer(Compiler* compiler, WhileStatement* stm, int loopNumber);
+        // Returns false without emitting anything if the loop can't be vectorized
+        bool vectorize();
+
+    private:
+        // The value of an expression in the vector registers
+        struct Value{
+            int reg;
+            bool isTemp; // Invariant values have their own registers which can't be changed
+        };
+
+        struct Reduction{
+            Variable* var;
+            SharedIExpression value;
+            int reg;
+        };
+
+        static const int REGISTERS_SIZE=16;
+        // RCX is the counter and RDX is the limit, RAX is left for the other values
+        static const std::vector<Assembler::AsmOperand(*)(int size)> ARRAY_REGISTERS;
+
+        Compiler* compiler;
+        WhileStatement* stm;
+        int loopNumber;
+        bool isAvx2;
+        VarAccessExpression* counter=nullptr;
+        SharedIExpression limit;
+        SharedType elementType;
+        std::vector<std::pair<Variable*, SharedIExpression>> stores; // The array and the value set at the counter
+        std::vector<Reduction> reductions;
+        std::vector<VarAccessExpression*> arrays; // In the order of their registers
+        std::vector<IExpression*> invariants; // Broadcast to their registers before the loop
+        std::unordered_map<IExpression*, int> invariantRegisters;
+        std::unordered_set<Variable*> assignedVars;
+        int tempsSize=0;
+
+        bool matchCondition();
+        bool matchIncrement(SharedIStatement stm);
+        bool matchStatement(SharedIStatement stm);
+        bool matchElementType(SharedType type);
+        // Checks the expression and returns the number of temporary registers needed to evaluate it, or -1 if it can't be vectorized
+        int matchValue(SharedIExpression ex);
+        bool isInvariant(IExpression* ex);
+        bool isArrayAtCounter(IExpression* ex, VarAccessExpression*& array);
+        bool isBuiltInOp(IExpression* ex, OperatorFunInvokeExpression*& opEx);
+        void addArray(VarAccessExpression* array);
+
+        void emit(Assembler::AsmInstruction instruction);
+        void emitBroadcast(int reg);
+        Value emitValue(IExpression* ex, int temp);
+        void emitHorizontalSum(Reduction& reduction);
+
+        int getElementSize();
+        int getElementsPerVector();
+        Assembler::AsmOperand getVectorRegister(int reg);
+        Assembler::AsmOperand getElementAddress(Variable* array);
+        Assembler::AsmOperand getVarAddress(Variable* var);
+        Assembler::AsmInstruction::InstructionType getPackedOp(OperatorFunInvokeExpression* ex);
+        Assembler::AsmInstruction::InstructionType getPackedAdd();
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Assembler.hpp"
+#include <string>
+#include <vector>
+
+/*
+ * Rewrites short windows of consecutive instructions of a label into cheaper ones with the same effect.
+ * The patterns never look across a local label or an inline asm unless they are about it,
+ * so the code jumped to stays the same.
+*/
+namespace Peephole {
+
+    struct Pattern{
+        std::wstring name;
+        int size; // The count of the instructions replaced
+        bool(*matches)(std::vector<Assembler::AsmInstruction>& instructions, int index);
+        std::vector<Assembler::AsmInstruction>(*rewrite)(std::vector<Assembler::AsmInstruction>& instructions, int index);
+    };
+
+    extern const std::vector<Pattern> PATTERNS;
+
+    // Applies the patterns until none of them matches
+    void optimize(Assembler::AsmLabel* label);
+
+    // The 64 bits register that contains the register, or empty if the operand isn't a general purpose register
+    std::wstring getRegisterFamily(std::wstring reg);
+    int getRegisterSize(std::wstring reg);
+    // Whether the operand is the register or uses it in its address
+    bool isUsingRegister(Assembler::AsmOperand operand, std::wstring family);
+
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include "AinException.hpp"
+#include <string>
+class NotInterpretableFunException:public AinException{
+    public:
+        NotInterpretableFunException(std::wstring funDecl):
+        AinException(
+            AinException::errorWString(
+                L"لا يمكن تنفيذ الدالة "+funDecl+
+                L" في المفسر لأنها مكتوبة بلغة التجميع فقط"
+            )
+        ){}
+};
@@ -0,0 +1,15 @@
+#pragma once
+#include "AinException.hpp"
+#include <string>
+class ReadOnlyArrayException:public AinException{
+    public:
+        ReadOnlyArrayException(
+            int lineNumber,
+            std::wstring typeName
+        ):AinException(
+            AinException::errorWString(
+                L"في السطر "+std::to_wstring(lineNumber)+L": لا يمكن تغيير عناصر المصفوفة "+
+                AinException::betweenAngleBrackets(typeName)+L"، فعناصرها ثابتة في البرنامج."
+            )
+        ){}
+};
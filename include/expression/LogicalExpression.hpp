@@ -25,6 +25,10 @@ class LogicalExpression:public IExpression{
         SharedIExpression getRight() const;
 
         Operation getLogicalOp() const;
+
+        void setLeft(SharedIExpression left);
+
+        void setRight(SharedIExpression right);
         
     private:
         SharedIExpression left;
@@ -7,12 +7,21 @@ class NewArrayExpression:public IExpression{
     private:
         // The capacity expressions for a multi-dimensional array
         std::vector<SharedIExpression>capacities;
+        // The literal elements of a constant array, it has no capacities then
+        SharedVector<SharedIExpression>values;
     public:
         NewArrayExpression(
             int lineNumber,
             std::vector<SharedIExpression>capacities,
             SharedType type
         );
+        NewArrayExpression(
+            int lineNumber,
+            SharedType type,
+            SharedVector<SharedIExpression>values
+        );
         void accept(ASTVisitor *visitor) override;
         std::vector<SharedIExpression> getCapacities() const;
+        SharedVector<SharedIExpression> getValues() const;
+        bool isConstant() const;
 };
\ No newline at end of file
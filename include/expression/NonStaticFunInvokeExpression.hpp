@@ -2,12 +2,17 @@
 #include "IExpression.hpp"
 #include "SharedPtrTypes.hpp"
 #include <string>
+
+class BuiltInFunScope;
+
 class NonStaticFunInvokeExpression:public IExpression{
     protected:
         std::wstring funName;
         SharedFunScope fun;
         SharedIExpression inside;
         SharedVector<SharedIExpression> args;
+        // Resolved once before interpreting, it's null when fun isn't a built-in fun
+        BuiltInFunScope* builtInFun=nullptr;
     public:
         NonStaticFunInvokeExpression(
             int lineNumber,
@@ -23,9 +28,15 @@ class NonStaticFunInvokeExpression:public IExpression{
 
         SharedIExpression getInside() const;
 
+        void setInside(SharedIExpression inside);
+
         SharedVector<SharedIExpression> getArgs() const;
 
         SharedFunScope getFun()const;
 
         void setFun(SharedFunScope fun);
+
+        BuiltInFunScope* getBuiltInFun()const;
+
+        void setBuiltInFun(BuiltInFunScope* builtInFun);
 };
\ No newline at end of file
@@ -7,6 +7,8 @@ class NonStaticVarAccessExpression:public IExpression{
         std::wstring varName;
         SharedIExpression inside;
         SharedVariable var;
+        // The offset of the var inside the object, resolved once before interpreting
+        int slotOffset=0;
     public:
         NonStaticVarAccessExpression(
             int lineNumber,
@@ -19,7 +21,13 @@ class NonStaticVarAccessExpression:public IExpression{
 
         SharedIExpression getInside() const;
 
+        void setInside(SharedIExpression inside);
+
         SharedVariable getVar()const;
 
         void setVar(SharedVariable var);
+
+        int getSlotOffset()const;
+
+        void setSlotOffset(int offset);
 };
\ No newline at end of file
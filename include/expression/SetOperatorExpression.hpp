@@ -34,6 +34,8 @@ class SetOperatorExpression:public IExpression{
 
         SharedIExpression getValueEx()const;
 
+        void setValueEx(SharedIExpression valueEx);
+
         SharedFunScope getFunOfSet()const;
 
         void setFunOfSet(SharedFunScope fun);
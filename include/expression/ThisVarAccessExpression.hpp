@@ -7,6 +7,9 @@ class ThisVarAccessExpression:public IExpression{
         std::wstring varName;
         SharedClassScope classScope;
         SharedVariable var;
+        // Resolved once before interpreting, so accessing the var doesn't look up the offsets map
+        int* slotReg=nullptr;
+        int slotOffset=0;
     public:
         ThisVarAccessExpression(
             int lineNumber,
@@ -22,4 +25,10 @@ class ThisVarAccessExpression:public IExpression{
         SharedVariable getVar()const;
 
         void setVar(SharedVariable var);
+
+        int* getSlotReg()const;
+
+        int getSlotOffset()const;
+
+        void setSlot(int* reg,int offset);
 };
\ No newline at end of file
@@ -7,10 +7,16 @@ class VarAccessExpression:public IExpression{
     private:
         std::wstring varName;
         SharedVariable var;
+        // Resolved once before interpreting, so accessing the var doesn't look up the offsets map
+        int* slotReg=nullptr;
+        int slotOffset=0;
     public:
         VarAccessExpression(int lineNumber,std::wstring varName,SharedVariable var);
         void accept(ASTVisitor *visitor) override;
         SharedVariable getVar() const;
         std::wstring getVarName() const;
         void setVar(SharedVariable var);
+        int* getSlotReg() const;
+        int getSlotOffset() const;
+        void setSlot(int* reg,int offset);
 };
\ No newline at end of file
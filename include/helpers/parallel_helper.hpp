@@ -0,0 +1,46 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Calls [fun] with each index in [0, count) on a pool of threads, the indices are taken in order by the free threads
+ * @throws the first exception thrown by [fun], after all threads finish
+*/
+template<typename Fun>
+void parallelFor(std::size_t count, Fun fun){
+    auto threadsCount=std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), count);
+
+    if(threadsCount<=1){
+        for(std::size_t i=0;i<count;i++)
+            fun(i);
+        return;
+    }
+
+    std::atomic<std::size_t> nextIndex=0;
+    std::vector<std::future<void>> threads;
+    for(std::size_t t=0;t<threadsCount;t++)
+        threads.push_back(std::async(std::launch::async, [&]{
+            for(auto i=nextIndex++;i<count;i=nextIndex++)
+                fun(i);
+        }));
+
+    // Waits for all of them before rethrowing, as they use the caller's variables
+    std::exception_ptr exception;
+    for(auto& thread:threads){
+        try{
+            thread.get();
+        }
+        catch(...){
+            if(!exception)
+                exception=std::current_exception();
+            nextIndex=count;
+        }
+    }
+    if(exception)
+        std::rethrow_exception(exception);
+}
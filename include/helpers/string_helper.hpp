@@ -1,4 +1,5 @@
 #pragma once
+#include <ostream>
 #include <string>
 bool startsWith(std::string str, std::string prefix);
 
@@ -22,4 +23,9 @@ wchar_t getEscapeSequenceFromCharacter(const wchar_t& c);
 
 const char* toCharPointer(const std::wstring& wstr);
 
+/**
+ * @brief Writes [wstr] to [out] encoded in UTF-8, without converting the whole string first
+*/
+void writeUtf8(std::ostream& out, const std::wstring& wstr);
+
 std::wstring toWstring(std::string str);
\ No newline at end of file
@@ -15,6 +15,7 @@
 #include "AugmentedAssignStatement.hpp"
 #include "Variable.hpp"
 #include "VarsOffsetSetter.hpp"
+#include "InterpreterProfiler.hpp"
 #include "WhileStatement.hpp"
 #include "DoWhileStatement.hpp"
 #include "BreakStatement.hpp"
@@ -39,8 +40,9 @@
 #include "RefValue.hpp"
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
-#define DATA_SIZE  64
+#define DATA_SIZE  256 // The global variables of ainstd alone need more than 64 slots
 #define HEAP_SIZE  64
 #define STACK_SIZE 64
 #define MEM_SIZE   DATA_SIZE+HEAP_SIZE+STACK_SIZE
@@ -68,12 +70,16 @@ class Interpreter:public ASTVisitor{
 
         LeftSideAssigner* lAssigner;
         RightSideAssigner* rAssigner;
+        InterpreterProfiler* profiler=nullptr; // Not null only with --profile
     private:
-        bool funReturn;
-        bool loopBreak;
-        bool loopContinue;
+        // How the last statement completed, statements that don't jump keep it NORMAL
+        enum class Completion{
+            NORMAL,BREAK,CONTINUE,RETURN
+        };
+        Completion completion=Completion::NORMAL;
 
         void runStmList(StmListScope* scope);
+        void runLoopScope(LoopScope* scope, bool& exitLoop);
         void reserveSpaceForStmListLocals(int size);
         void removeReservedSpaceForStmListLocals(int size);
         
@@ -135,7 +141,9 @@ class Interpreter:public ASTVisitor{
         int*const SP;
         const int*const DS;
         const int*const SS;
-        SharedIValue memory[MEM_SIZE];
+        // The constant arrays are added once after the stack, so they are shared like in the read-only data of the compiled program
+        std::vector<SharedIValue> memory=std::vector<SharedIValue>(MEM_SIZE);
+        std::unordered_map<NewArrayExpression*, int> constantArraysAddresses;
 };
 
 template<typename T>
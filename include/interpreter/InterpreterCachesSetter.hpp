@@ -0,0 +1,77 @@
+#pragma once
+#include "ASTVisitor.hpp"
+
+#include "PackageScope.hpp"
+#include "FileScope.hpp"
+#include "ClassScope.hpp"
+#include "FunScope.hpp"
+#include "LoopScope.hpp"
+#include "StmListScope.hpp"
+#include "VarStm.hpp"
+#include "IfStatement.hpp"
+#include "AssignStatement.hpp"
+#include "AugmentedAssignStatement.hpp"
+#include "WhileStatement.hpp"
+#include "DoWhileStatement.hpp"
+#include "BreakStatement.hpp"
+#include "ContinueStatement.hpp"
+#include "ReturnStatement.hpp"
+#include "ExpressionStatement.hpp"
+#include "VarAccessExpression.hpp"
+#include "FunInvokeExpression.hpp"
+#include "NewObjectExpression.hpp"
+#include "NewArrayExpression.hpp"
+#include "LogicalExpression.hpp"
+#include "NonStaticVarAccessExpression.hpp"
+#include "NonStaticFunInvokeExpression.hpp"
+#include "OperatorFunInvokeExpression.hpp"
+#include "SetOperatorExpression.hpp"
+#include "ThisVarAccessExpression.hpp"
+#include "ThisFunInvokeExpression.hpp"
+#include "VarsOffsetSetter.hpp"
+#include <unordered_map>
+
+/*
+ * Resolution pass that runs after VarsOffsetSetter and before the interpreter,
+ * it copies the offset of each accessed var and the built-in fun of each call into its node,
+ * so the interpreter reads them directly instead of looking them up on every access.
+ * It also marks the scopes that may be left early by a jump statement (break, continue or return).
+*/
+class InterpreterCachesSetter:public ASTVisitor{
+    public:
+        std::unordered_map<Variable*, VarsOffsetSetter::Offset>* offsets;
+        InterpreterCachesSetter(std::unordered_map<Variable*, VarsOffsetSetter::Offset>* offsets);
+    private:
+        bool hasLoopJump=false; // break or continue that affects the current loop
+        bool hasReturn=false;
+        void visitArgs(SharedVector<SharedIExpression> args);
+        void visitStmList(StmListScope* scope);
+        void visitLoopScope(SharedLoopScope scope);
+        void visit(PackageScope* scope)override;
+        void visit(FileScope* scope)override;
+        void visit(ClassScope* scope)override;
+        void visit(FunScope* scope)override;
+        void visit(LoopScope* scope)override;
+        void visit(StmListScope* scope)override;
+        void visit(VarStm* stm)override;
+        void visit(AssignStatement* stm)override;
+        void visit(AugmentedAssignStatement* stm)override;
+        void visit(IfStatement* stm)override;
+        void visit(WhileStatement* stm)override;
+        void visit(DoWhileStatement* stm)override;
+        void visit(BreakStatement* stm)override;
+        void visit(ContinueStatement* stm)override;
+        void visit(ReturnStatement* stm)override;
+        void visit(ExpressionStatement* stm)override;
+        void visit(VarAccessExpression* ex)override;
+        void visit(FunInvokeExpression* ex)override;
+        void visit(NewObjectExpression* ex)override;
+        void visit(NewArrayExpression* ex)override;
+        void visit(LogicalExpression* ex)override;
+        void visit(NonStaticVarAccessExpression* ex)override;
+        void visit(NonStaticFunInvokeExpression* ex)override;
+        void visit(OperatorFunInvokeExpression* ex)override;
+        void visit(SetOperatorExpression* ex)override;
+        void visit(ThisVarAccessExpression* ex)override;
+        void visit(ThisFunInvokeExpression* ex)override;
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include "FunScope.hpp"
+#include <atomic>
+#include <csignal>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Sampling profiler for the interpreter.
+ * A SIGPROF timer only counts the due samples, then the interpreter takes them at the next statement,
+ * so the signal handler doesn't touch the call stack while it's changing.
+*/
+class InterpreterProfiler{
+    public:
+        InterpreterProfiler(int samplingIntervalUs=1000);
+        void start();
+        void stop();
+        void enterFun(FunScope* fun);
+        void exitFun();
+        void onStatement(int lineNumber);
+        void onAllocation();
+        std::wstring getFlatReport();
+        std::wstring getCollapsedStacks();
+    private:
+        struct FunStats{
+            int calls=0;
+            int allocations=0;
+            int selfSamples=0;
+            int inclusiveSamples=0;
+            int lastSample=-1; // To count recursive calls once per sample
+        };
+        static std::atomic<int> pendingSamples; // Lock-free, so the signal handler can update it
+        static void onTimerSignal(int signal);
+        int samplingIntervalUs;
+        int samplesCount=0;
+        int currentLine=0;
+        std::vector<FunScope*> callStack;
+        std::vector<int> callersLines;
+        std::unordered_map<FunScope*, FunStats> funsStats;
+        std::map<std::pair<FunScope*, int>, int> linesSamples;
+        std::map<std::vector<FunScope*>, int> stacksSamples;
+        void takeSample();
+        std::wstring getFunName(FunScope* fun);
+        std::wstring getTime(int samples);
+};
+
+inline void InterpreterProfiler::onStatement(int lineNumber){
+    currentLine=lineNumber;
+    if(pendingSamples.load(std::memory_order_relaxed)==0)
+        return;
+    // Samples signalled while taking these are left for the next statement
+    for(int samples=pendingSamples.exchange(0);samples>0;samples--)
+        takeSample();
+}
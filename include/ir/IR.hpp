@@ -0,0 +1,104 @@
+#pragma once
+
+#include "SharedPtrTypes.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+class FunScope;
+class Variable;
+
+/*
+ * A typed mid-level IR in SSA form, functions are lowered to it from the checked AST by IRBuilder,
+ * optimized by the passes in IRPasses.hpp and then compiled to asm by IRCompiler.
+ * Every integer value is kept sign or zero extended to 64 bits according to its type.
+*/
+namespace IR {
+
+    struct BasicBlock;
+
+    enum class Op{
+        CONST, // imm
+        PARAM, // var is the param
+        PHI, // An operand for each pred of its block, in the same order
+        ADD,SUB,MUL,DIV,MOD,
+        AND,OR,XOR,
+        SHL,SHR, // SHR is logical as in the AST code generator
+        NEG,NOT,LOGICAL_NOT,
+        CONVERT, // To the instruction type from the type of the operand
+        EQ,NE,LT,LE,GT,GE,
+        LOAD_GLOBAL, // var is the global
+        STORE_GLOBAL, // var is the global, operands[0] is the stored value
+        LOAD, // operands[0] is the address, the loaded value has the size of the instruction type
+        STORE, // operands[0] is the address, operands[1] is the stored value
+        CALL, // callee is the called function, operands are the args
+    };
+
+    struct Instruction{
+        int id;
+        Op op;
+        SharedType type; // VOID if it doesn't produce a value
+        std::vector<Instruction*> operands;
+        long long imm=0;
+        Variable* var=nullptr;
+        FunScope* callee=nullptr;
+        BasicBlock* block=nullptr;
+
+        bool isPhi()const;
+        bool isCompare()const;
+        // Has no side effects and doesn't depend on the memory, so it can be merged with an equal instruction
+        bool isPure()const;
+        // Can run even if it wasn't run in the original program, like when hoisted out of a loop
+        bool isSpeculatable()const;
+        bool hasSideEffects()const;
+        bool isUnsigned()const;
+        std::wstring toString()const;
+    };
+
+    struct BasicBlock{
+        enum class Terminator{
+            NONE, // Still being built
+            JUMP, // To targets[0]
+            BRANCH, // To targets[0] if value is true, to targets[1] otherwise
+            RETURN, // value is null for void functions
+        };
+
+        int id;
+        std::vector<Instruction*> instructions; // Phis come first
+        std::vector<BasicBlock*> preds;
+        Terminator terminator=Terminator::NONE;
+        Instruction* value=nullptr;
+        BasicBlock* targets[2]={nullptr,nullptr};
+
+        std::vector<BasicBlock*> getSuccessors()const;
+        int getPredIndex(BasicBlock* pred)const;
+        // Removes the pred and its operand from the phis
+        void removePred(BasicBlock* pred);
+        std::wstring toString()const;
+    };
+
+    struct Function{
+        FunScope* scope;
+        std::vector<std::unique_ptr<BasicBlock>> blocks; // The first block is the entry
+        std::vector<std::unique_ptr<Instruction>> instructions;
+        int blocksCounter=0;
+        int instructionsCounter=0;
+
+        Function(FunScope* scope);
+        BasicBlock* getEntry()const;
+        BasicBlock* newBlock();
+        Instruction* newInstruction(Op op, SharedType type, std::vector<Instruction*> operands={});
+        void addEdge(BasicBlock* from, BasicBlock* to);
+        void replaceAllUses(Instruction* of, Instruction* with);
+        void removeBlocks(std::vector<BasicBlock*> blocks);
+        std::wstring toString()const;
+    };
+
+    std::wstring getOpName(Op op);
+    bool isSupportedType(SharedType type);
+    bool isIntegerType(SharedType type);
+    bool isUnsignedType(SharedType type);
+    // Truncates the value to the size of the type then extends it back to 64 bits
+    long long canonicalize(long long value, SharedType type);
+
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include "ASTVisitor.hpp"
+#include "IR.hpp"
+
+#include "FunScope.hpp"
+#include "LoopScope.hpp"
+#include "SharedPtrTypes.hpp"
+#include "StmListScope.hpp"
+#include "VarStm.hpp"
+#include "IfStatement.hpp"
+#include "AssignStatement.hpp"
+#include "AugmentedAssignStatement.hpp"
+#include "WhileStatement.hpp"
+#include "DoWhileStatement.hpp"
+#include "BreakStatement.hpp"
+#include "ContinueStatement.hpp"
+#include "ReturnStatement.hpp"
+#include "ExpressionStatement.hpp"
+#include "VarAccessExpression.hpp"
+#include "FunInvokeExpression.hpp"
+#include "NewObjectExpression.hpp"
+#include "NewArrayExpression.hpp"
+#include "LiteralExpression.hpp"
+#include "VoidExpression.hpp"
+#include "LogicalExpression.hpp"
+#include "NonStaticVarAccessExpression.hpp"
+#include "NonStaticFunInvokeExpression.hpp"
+#include "OperatorFunInvokeExpression.hpp"
+#include "SetOperatorExpression.hpp"
+#include "ThisExpression.hpp"
+#include "ThisVarAccessExpression.hpp"
+#include "ThisFunInvokeExpression.hpp"
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+class BuiltInFunScope;
+
+/*
+ * Lowers a global function from the checked AST to SSA form, the variables are renamed while the blocks are built
+ * as described in "Simple and Efficient Construction of Static Single Assignment Form" by Braun et al.
+ * Only integer, bool and char values are supported for now, the functions using anything else are left
+ * to the AST code generator.
+*/
+class IRBuilder:public ASTVisitor{
+    public:
+        // Returns null if the function uses something that isn't supported by the IR
+        static std::unique_ptr<IR::Function> build(FunScope* scope);
+
+        void visit(LoopScope* scope)override;
+        void visit(StmListScope* scope)override;
+
+        void visit(VarStm* stm)override;
+        void visit(AssignStatement* stm)override;
+        void visit(AugmentedAssignStatement* stm)override;
+        void visit(IfStatement* stm)override;
+        void visit(WhileStatement* stm)override;
+        void visit(DoWhileStatement* stm)override;
+        void visit(BreakStatement* stm)override;
+        void visit(ContinueStatement* stm)override;
+        void visit(ReturnStatement* stm)override;
+        void visit(ExpressionStatement* stm)override;
+
+        void visit(VarAccessExpression* ex)override;
+        void visit(FunInvokeExpression* ex)override;
+        void visit(NewObjectExpression* ex)override;
+        void visit(NewArrayExpression* ex)override;
+        void visit(LiteralExpression* ex)override;
+        void visit(VoidExpression* ex)override;
+        void visit(LogicalExpression* ex)override;
+        void visit(NonStaticVarAccessExpression* ex)override;
+        void visit(NonStaticFunInvokeExpression* ex)override;
+        void visit(OperatorFunInvokeExpression* ex)override;
+        void visit(SetOperatorExpression* ex)override;
+        void visit(ThisExpression* ex)override;
+        void visit(ThisVarAccessExpression* ex)override;
+        void visit(ThisFunInvokeExpression* ex)override;
+
+    private:
+        struct LoopTargets{
+            IR::BasicBlock* continueTarget;
+            IR::BasicBlock* breakTarget;
+        };
+
+        std::unique_ptr<IR::Function> fun;
+        bool supported=true;
+        IR::BasicBlock* currentBlock=nullptr;
+        IR::Instruction* result=nullptr; // The value of the last visited expression
+        std::unordered_set<Variable*> locals;
+        std::vector<LoopTargets> loops;
+        std::unordered_map<Variable*, std::unordered_map<IR::BasicBlock*, IR::Instruction*>> currentDefs;
+        std::unordered_map<IR::BasicBlock*, std::vector<std::pair<Variable*, IR::Instruction*>>> incompletePhis;
+        std::unordered_set<IR::BasicBlock*> sealedBlocks;
+
+        IRBuilder(FunScope* scope);
+        void unsupported();
+        void collectLocals(StmListScope* scope);
+        void lowerStmList(StmListScope* scope);
+        IR::Instruction* lower(SharedIExpression ex);
+        void lowerCondition(SharedIExpression condition, IR::BasicBlock* trueTarget, IR::BasicBlock* falseTarget);
+        // Short circuits to the targets
+        void lowerLogicalCondition(LogicalExpression* ex, IR::BasicBlock* trueTarget, IR::BasicBlock* falseTarget);
+        // The reads and writes of an address are lowered to loads and stores instead of calls, returns null for the other functions
+        IR::Instruction* lowerMemoryAccess(BuiltInFunScope* fun, FunInvokeExpression* ex);
+        IR::Instruction* lowerBuiltInOp(OperatorFunInvokeExpression* ex);
+        IR::Instruction* lowerIncOrDec(OperatorFunInvokeExpression* ex);
+        IR::Instruction* constant(long long value, SharedType type);
+        IR::Instruction* append(IR::Op op, SharedType type, std::vector<IR::Instruction*> operands={});
+        IR::Instruction* readVar(Variable* var);
+        void writeVar(Variable* var, IR::Instruction* value);
+
+        void jump(IR::BasicBlock* target);
+        void branch(IR::Instruction* condition, IR::BasicBlock* trueTarget, IR::BasicBlock* falseTarget);
+        // Starts a block that can't be reached after a jump statement, so the statements after it are still lowered
+        void startUnreachableBlock();
+
+        // SSA construction
+        void writeVariable(Variable* var, IR::BasicBlock* block, IR::Instruction* value);
+        IR::Instruction* readVariable(Variable* var, IR::BasicBlock* block);
+        IR::Instruction* readVariableRecursive(Variable* var, IR::BasicBlock* block);
+        IR::Instruction* newPhi(Variable* var, IR::BasicBlock* block);
+        void addPhiOperands(Variable* var, IR::Instruction* phi);
+        void sealBlock(IR::BasicBlock* block);
+
+        static bool isBinaryOp(OperatorFunInvokeExpression::Operator op);
+        static IR::Op toIROp(OperatorFunInvokeExpression::Operator op);
+        static IR::Op toIROp(AugmentedAssignStatement::Operator op);
+};
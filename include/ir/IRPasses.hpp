@@ -0,0 +1,33 @@
+#pragma once
+
+#include "IR.hpp"
+#include <unordered_map>
+#include <vector>
+
+namespace IR {
+
+    // Runs all the passes in order, the function stays in SSA form
+    void optimize(Function* fun);
+
+    void removeUnreachableBlocks(Function* fun);
+    // Removes the phis whose operands are all the same value or the phi itself
+    void propagateCopies(Function* fun);
+    // Merges the pure instructions computing the same value where one dominates the other
+    void eliminateCommonSubexpressions(Function* fun);
+    // Moves the instructions that compute the same value in each iteration to the preheader of the loop
+    void hoistLoopInvariants(Function* fun);
+    // Replaces the additions of a loop invariant to a multiple of an induction variable, like the addresses of the elements,
+    // by values of their own that are incremented with the induction variable
+    void reduceInductionVariables(Function* fun);
+    void eliminateDeadCode(Function* fun);
+    // Adds an empty block on each edge from a block with many successors to a block with many preds,
+    // so the phi copies have a place of their own
+    void splitCriticalEdges(Function* fun);
+
+    // The reachable blocks in reverse post order, the true target of a branch comes right after it when possible
+    std::vector<BasicBlock*> getReversePostOrder(Function* fun);
+
+    // The immediate dominator of each reachable block, the entry is its own dominator
+    std::unordered_map<BasicBlock*, BasicBlock*> getDominators(Function* fun);
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "IR.hpp"
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/*
+ * Assigns registers to the values of a function by linear scan over their live intervals, as described in
+ * "Linear Scan Register Allocation" by Poletto and Sarkar.
+ * The interval of a value is the range between the first and the last positions where it's live, the values
+ * that are live across a call can only take the registers preserved by the calls.
+ * The registers are ids chosen by the caller, a value that doesn't get one is spilled to the stack.
+*/
+class RegisterAllocator{
+    public:
+        // The blocks should be in the order they're emitted
+        RegisterAllocator(
+            std::vector<IR::BasicBlock*> order,
+            std::function<bool(IR::Instruction*)> needsLocation
+        );
+
+        // The registers are taken in the given order, the scratch registers are tried first for the values that aren't live across a call
+        void allocate(std::vector<int> scratchRegisters, std::vector<int> preservedRegisters);
+
+        // Returns -1 if the value is spilled
+        int getRegister(IR::Instruction* value);
+
+        std::vector<int> getUsedPreservedRegisters();
+
+    private:
+        struct Interval{
+            IR::Instruction* value;
+            int start;
+            int end;
+            bool isLiveAcrossCall=false;
+        };
+
+        std::vector<IR::BasicBlock*> order;
+        std::function<bool(IR::Instruction*)> needsLocation;
+        std::unordered_map<IR::Instruction*, int> positions;
+        std::unordered_map<IR::BasicBlock*, int> blocksStarts;
+        std::unordered_map<IR::BasicBlock*, int> blocksEnds;
+        std::vector<int> callsPositions;
+        std::unordered_map<IR::BasicBlock*, std::unordered_set<IR::Instruction*>> liveIns;
+        std::unordered_map<IR::BasicBlock*, std::unordered_set<IR::Instruction*>> liveOuts;
+        std::unordered_map<IR::Instruction*, Interval> intervals;
+        std::unordered_map<IR::Instruction*, int> registers;
+        std::vector<int> usedPreservedRegisters;
+
+        void numberInstructions();
+        void computeLiveness();
+        void buildIntervals();
+        void extendInterval(IR::Instruction* value, int position);
+};
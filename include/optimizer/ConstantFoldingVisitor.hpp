@@ -0,0 +1,85 @@
+#pragma once
+#include "ASTVisitor.hpp"
+
+#include "IValue.hpp"
+#include "PackageScope.hpp"
+#include "FileScope.hpp"
+#include "ClassScope.hpp"
+#include "FunScope.hpp"
+#include "LoopScope.hpp"
+#include "SharedPtrTypes.hpp"
+#include "StmListScope.hpp"
+#include "VarStm.hpp"
+#include "IfStatement.hpp"
+#include "AssignStatement.hpp"
+#include "AugmentedAssignStatement.hpp"
+#include "WhileStatement.hpp"
+#include "DoWhileStatement.hpp"
+#include "ReturnStatement.hpp"
+#include "ExpressionStatement.hpp"
+#include "VarAccessExpression.hpp"
+#include "FunInvokeExpression.hpp"
+#include "NewObjectExpression.hpp"
+#include "NewArrayExpression.hpp"
+#include "LogicalExpression.hpp"
+#include "NonStaticFunInvokeExpression.hpp"
+#include "OperatorFunInvokeExpression.hpp"
+#include "SetOperatorExpression.hpp"
+#include "ThisFunInvokeExpression.hpp"
+#include <unordered_map>
+
+/*
+ * Runs after SemanticsChecksVisitor, it folds built-in operators of primitives when their operands are literals
+ * or immutable globals initialized with literals, simplifies logical expressions and drops unreachable if arms.
+*/
+class ConstantFoldingVisitor:public ASTVisitor{
+    public:
+        void visit(PackageScope* scope)override;
+        void visit(FileScope* scope)override;
+        void visit(ClassScope* scope)override;
+        void visit(FunScope* scope)override;
+        void visit(LoopScope* scope)override;
+        void visit(StmListScope* scope)override;
+
+        void visit(VarStm* stm)override;
+        void visit(AssignStatement* stm)override;
+        void visit(AugmentedAssignStatement* stm)override;
+        void visit(IfStatement* stm)override;
+        void visit(WhileStatement* stm)override;
+        void visit(DoWhileStatement* stm)override;
+        void visit(ReturnStatement* stm)override;
+        void visit(ExpressionStatement* stm)override;
+
+        void visit(VarAccessExpression* ex)override;
+        void visit(FunInvokeExpression* ex)override;
+        void visit(NewObjectExpression* ex)override;
+        void visit(NewArrayExpression* ex)override;
+        void visit(LogicalExpression* ex)override;
+        void visit(NonStaticFunInvokeExpression* ex)override;
+        void visit(OperatorFunInvokeExpression* ex)override;
+        void visit(SetOperatorExpression* ex)override;
+        void visit(ThisFunInvokeExpression* ex)override;
+
+    private:
+        // An integer value with its bits sign or zero extended to 64 bits
+        struct IntegerValue{
+            unsigned long long bits;
+            bool isUnsigned;
+        };
+        SharedIExpression replacement; // The folded expression of the last visited expression, if any
+        bool removeStatement=false; // The last visited statement is unreachable
+        std::unordered_map<Variable*, SharedIValue> constantGlobals;
+        SharedIExpression fold(SharedIExpression ex);
+        void foldArgs(SharedVector<SharedIExpression> args);
+        void foldStmList(StmListScope* scope);
+        bool foldGlobals(PackageScope* scope);
+        static bool isBoolLiteral(SharedIExpression ex, bool value);
+        static bool toInteger(SharedIValue value, IntegerValue& integer);
+        static SharedIValue toValue(SharedType type, unsigned long long bits);
+        static SharedIValue foldBuiltInOp(
+            OperatorFunInvokeExpression::Operator op,
+            SharedIValue insideValue,
+            SharedIValue argValue,
+            SharedType returnType
+        );
+};
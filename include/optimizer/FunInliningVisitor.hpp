@@ -0,0 +1,101 @@
+#pragma once
+#include "ASTVisitor.hpp"
+
+#include "PackageScope.hpp"
+#include "FileScope.hpp"
+#include "ClassScope.hpp"
+#include "FunScope.hpp"
+#include "LoopScope.hpp"
+#include "SharedPtrTypes.hpp"
+#include "StmListScope.hpp"
+#include "VarStm.hpp"
+#include "IfStatement.hpp"
+#include "AssignStatement.hpp"
+#include "AugmentedAssignStatement.hpp"
+#include "WhileStatement.hpp"
+#include "DoWhileStatement.hpp"
+#include "ReturnStatement.hpp"
+#include "ExpressionStatement.hpp"
+#include "FunInvokeExpression.hpp"
+#include "NewObjectExpression.hpp"
+#include "LogicalExpression.hpp"
+#include "NonStaticVarAccessExpression.hpp"
+#include "NonStaticFunInvokeExpression.hpp"
+#include "OperatorFunInvokeExpression.hpp"
+#include "SetOperatorExpression.hpp"
+#include "ThisFunInvokeExpression.hpp"
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/*
+ * Runs after SemanticsChecksVisitor and before ConstantFoldingVisitor, it replaces calls to small global functions
+ * whose body is a single return statement with a copy of the returned expression, the params are substituted
+ * with the args when that doesn't change the evaluation order of side effects.
+*/
+class FunInliningVisitor:public ASTVisitor{
+    public:
+        // The max cost of the returned expression of an inlined function
+        static constexpr int MAX_INLINE_COST=24;
+        // The added cost of calling a function that isn't built-in in the returned expression
+        static constexpr int CALL_COST=8;
+
+        void visit(PackageScope* scope)override;
+        void visit(FileScope* scope)override;
+        void visit(ClassScope* scope)override;
+        void visit(FunScope* scope)override;
+        void visit(LoopScope* scope)override;
+        void visit(StmListScope* scope)override;
+
+        void visit(VarStm* stm)override;
+        void visit(AssignStatement* stm)override;
+        void visit(AugmentedAssignStatement* stm)override;
+        void visit(IfStatement* stm)override;
+        void visit(WhileStatement* stm)override;
+        void visit(DoWhileStatement* stm)override;
+        void visit(ReturnStatement* stm)override;
+        void visit(ExpressionStatement* stm)override;
+
+        void visit(FunInvokeExpression* ex)override;
+        void visit(NewObjectExpression* ex)override;
+        void visit(LogicalExpression* ex)override;
+        void visit(NonStaticVarAccessExpression* ex)override;
+        void visit(NonStaticFunInvokeExpression* ex)override;
+        void visit(OperatorFunInvokeExpression* ex)override;
+        void visit(SetOperatorExpression* ex)override;
+        void visit(ThisFunInvokeExpression* ex)override;
+
+    private:
+        struct InlineCandidate{
+            FunScope* fun;
+            SharedIExpression body; // The returned expression
+            std::vector<Variable*> params;
+            std::vector<int> paramsUses; // The times each param is accessed in the body
+            std::vector<bool> paramsUsedAfterSideEffects;
+            bool hasSideEffects; // The body calls functions, accesses globals or reads from the heap
+        };
+        SharedIExpression replacement; // The inlined expression of the last visited call, if any
+        bool globalsCollected=false;
+        std::unordered_set<Variable*> globals;
+        std::unordered_set<FunScope*> visitedFuns;
+        std::unordered_set<FunScope*> funsInProgress;
+        std::unordered_map<FunScope*, std::shared_ptr<InlineCandidate>> candidates;
+        SharedIExpression inlineCalls(SharedIExpression ex);
+        void inlineCallsInArgs(SharedVector<SharedIExpression> args);
+        void collectGlobals(PackageScope* scope);
+        std::shared_ptr<InlineCandidate> getCandidate(SharedFunScope fun);
+        bool analyze(SharedIExpression ex, InlineCandidate& candidate, int& cost, int useWeight);
+        bool canSubstitute(InlineCandidate& candidate, SharedVector<SharedIExpression> args);
+        bool isTrivial(SharedIExpression ex);
+        // Args narrower than 8 bytes were truncated when stored on the stack, the generated code may rely on
+        // the upper bits of RAX being the same as if the param was loaded, which only holds for loads and non negative literals
+        bool keepsUpperBits(SharedIExpression ex);
+        bool isPure(SharedIExpression ex);
+        SharedIExpression clone(
+            SharedIExpression ex,
+            std::unordered_map<Variable*, SharedIExpression>& args,
+            int lineNumber
+        );
+        static bool isIncOrDec(OperatorFunInvokeExpression::Operator op);
+};
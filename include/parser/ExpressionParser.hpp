@@ -52,6 +52,8 @@ class ExpressionParser:public BaseParser<SharedIExpression>{
 
         SharedVector<SharedIExpression> expectFunArgs();
 
+        SharedVector<SharedIExpression> expectArrayValues();
+
         void next();
 
         bool nextMatch(LexerToken expected);
@@ -27,6 +27,7 @@ class Type{
         static SharedWString STRING_NAME;
         static SharedWString BOOL_NAME;
         static SharedWString ARRAY_NAME;
+        static SharedWString READ_ONLY_NAME; // After the array type, as in [م8] ثابتة
         static SharedType VOID;
         static SharedType CHAR;
         static SharedType BYTE;
@@ -61,8 +62,10 @@ class Type{
 class Type::Array:public Type{
     private:
         SharedType type;
+        bool readOnly; // The constant arrays are in the read-only data, so their elements can't be set
     public:
-        Array(SharedType type);
+        Array(SharedType type, bool readOnly=false);
         SharedType getType()const;
+        bool isReadOnly()const;
         SharedClassScope getClassScope()override;
 };
\ No newline at end of file
@@ -8,6 +8,8 @@ class StmListScope:public BaseScope{
     protected:
         SharedMap<std::wstring, SharedVariable> locals;
         SharedStmList stmList;
+        // Whether a break, continue or return may stop running this scope before its end
+        bool jumpStatements=true;
 
     public:
         StmListScope(int lineNumber,std::wstring name,SharedBaseScope parentScope);
@@ -16,4 +18,6 @@ class StmListScope:public BaseScope{
         SharedStmList getStmList();
         SharedVariable getVarByName(std::wstring varName)override;
         SharedVariable getLocalByName(std::wstring varName);
+        bool hasJumpStatements();
+        void setHasJumpStatements(bool jumpStatements);
 };
\ No newline at end of file
@@ -41,6 +41,18 @@ class BuiltInFunScope:public FunScope{
         static void addBuiltInFunctionsToStringClass();
         static void addBuiltInFunctionsToVoidClass();
         static void addBuiltInFunctionsToArrayClass();
+        // Copy and fill the memory by the args on the stack and remove them, the copy leaves RDI after the last copied byte
+        static std::vector<Assembler::AsmInstruction> getMemcpyAsm(Compiler* compiler);
+        static std::vector<Assembler::AsmInstruction> getMemsetAsm(Compiler* compiler);
+        // Returns the index of the first byte with the value in RAX, or the size if it's not found
+        static std::vector<Assembler::AsmInstruction> getMemchrAsm(Compiler* compiler);
+        static std::vector<Assembler::AsmInstruction> getPrintAsm(Compiler* compiler, bool isLine);
+        // Both operands are already converted to the size of the type, the divisor is popped from RAX and the dividend from the stack
+        // The quotient is left in RAX and the remainder in RDX, and their bits above the size of the type aren't defined
+        static std::vector<Assembler::AsmInstruction> getDivAsm(SharedType type);
+        // Right shift in the size of the type, so the bits above it are cleared before shifting like the IR compiler does
+        static std::vector<Assembler::AsmInstruction> getShrAsm(SharedType type);
+        static const int REP_STRING_MIN_SIZE=512; // The sizes that are copied or filled all with "rep movsb" or "rep stosb"
         void accept(ASTVisitor *visitor) override;
 
         template <typename PrimitiveType, typename ParamValue, typename ReturnValue>
@@ -243,6 +255,12 @@ class BuiltInFunScope:public FunScope{
         static const inline auto INLINE_ASM_NAME=L"أسيمبلي";
         static const inline auto SYSCALL_NAME=L"استدعاء";
         static const inline auto BRK_NAME=L"إزاحة_الذاكرة";
+        static const inline auto MEMCPY_NAME=L"انسخ_الذاكرة";
+        static const inline auto MEMSET_NAME=L"املأ_الذاكرة";
+        static const inline auto MEMCHR_NAME=L"ابحث_في_الذاكرة";
+        static const inline auto MUL_HIGH_NAME=L"ضرب_أعلى";
+        static const inline auto STRING_ADDRESS_NAME=L"عنوان_النص";
+        static const inline auto ARRAY_AT_ADDRESS_NAME=L"مصفوفة_في_العنوان";
         static const inline auto WRITE_TO_ADDRESS_NAME=L"اكتب";
         static const inline auto READ_LONG_FROM_ADDRESS_NAME=L"اقرأ_كبير";
         static const inline auto READ_INT_FROM_ADDRESS_NAME=L"اقرأ_بايت";
@@ -275,13 +293,14 @@ class BuiltInFunScope:public FunScope{
         static const inline auto TOCNT_NAME=L"آحاد_اليمين";
         static const inline auto IS_EMPTY_NAME=L"فارغة";
         static const inline auto IS_NOT_EMPTY_NAME=L"ليست_فارغة";
+        static const inline auto ELEMENTS_ADDRESS_NAME=L"عنوان_العناصر";
 
     public:
         BuiltInFunScope(
             std::wstring name,
             SharedType returnType,
             std::vector<std::pair<std::wstring, SharedType>> params,
-            std::function<void(Interpreter*)> invokeOnInterpreterFun,
+            std::function<void(Interpreter*)> invokeOnInterpreterFun, // nullptr if the built-in is only implemented in asm
             bool isOperator=false,
             std::function<std::vector<Assembler::AsmInstruction>(Compiler* compiler)> onGenerateAsm=[](Compiler* compiler){
                 return std::vector<Assembler::AsmInstruction>{};
@@ -294,6 +313,10 @@ class BuiltInFunScope:public FunScope{
 
         std::vector<Assembler::AsmInstruction> getGeneratedAsm(Compiler* compiler);
 
+        // The functions that read from an address or write to it, they're lowered to loads and stores by the IR
+        bool isReadFromAddress();
+        bool isWriteToAddress();
+
         static void addBuiltInFunctionsTo(SharedFileScope fileScope);
 
         static void addBuiltInFunctionsToBuiltInClasses();
@@ -409,14 +432,7 @@ inline std::shared_ptr<BuiltInFunScope> BuiltInFunScope::getDivFun(
         },
         true,
         [=](Compiler* compiler){
-            return std::vector{
-                Assembler::zero(Assembler::RDX()),
-                Assembler::mov(Assembler::RCX(), Assembler::RAX()),
-                Assembler::pop(Assembler::RAX()), 
-                (*returnType==*Type::UBYTE||*returnType==*Type::UINT||*returnType==*Type::ULONG)
-                    ?Assembler::div(Assembler::RCX())
-                    :idiv(Assembler::RCX())
-            };
+            return getDivAsm(returnType);
         }
     );
 }
@@ -439,20 +455,14 @@ inline std::shared_ptr<BuiltInFunScope> BuiltInFunScope::getModFun(
         },
         true,
         [=](Compiler* compiler){
-            return std::vector{
-                Assembler::zero(Assembler::RDX()),
-                Assembler::mov(Assembler::RCX(), Assembler::RAX()),
-                Assembler::pop(Assembler::RAX()), 
-                (*returnType==*Type::UBYTE||*returnType==*Type::UINT||*returnType==*Type::ULONG)
-                    ?Assembler::div(Assembler::RCX())
-                    :idiv(Assembler::RCX()),
-                Assembler::mov(
-                    Assembler::RAX(),
-                    Assembler::RDX(),
-                    Assembler::AsmInstruction::IMPLICIT,
-                    L"باقي القسمة"
-                )
-            };
+            auto instructions=getDivAsm(returnType);
+            instructions.push_back(Assembler::mov(
+                Assembler::RAX(),
+                Assembler::RDX(),
+                Assembler::AsmInstruction::IMPLICIT,
+                L"باقي القسمة"
+            ));
+            return instructions;
         }
     );
 }
@@ -510,12 +520,8 @@ inline std::shared_ptr<BuiltInFunScope> BuiltInFunScope::getShrFun(
             interpreter->AX=std::make_shared<ParamValue>(a>>b);
         },
         true,
-        [](Compiler* compiler){
-            return std::vector{
-                Assembler::mov(Assembler::RCX(), Assembler::RAX()),
-                Assembler::pop(Assembler::RAX()),
-                Assembler::shr(Assembler::RAX(), Assembler::RCX(Assembler::AsmInstruction::BYTE))
-            };
+        [=](Compiler* compiler){
+            return getShrAsm(returnType);
         }
     );
 }
@@ -18,6 +18,8 @@ class AssignStatement:public IStatement{
         SharedIExpression getLeft()const;
 
         SharedIExpression getRight()const;
+
+        void setRight(SharedIExpression right);
     
     private:
         SharedIExpression left;
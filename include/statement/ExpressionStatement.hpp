@@ -14,5 +14,7 @@ class ExpressionStatement:public IStatement{
         void accept(ASTVisitor *visitor) override;
 
         SharedIExpression getEx()const;
+
+        void setEx(SharedIExpression ex);
     
 };
\ No newline at end of file
@@ -25,4 +25,10 @@ class IfStatement:public IStatement
         SharedStmListScope getIfScope()const;
 
         SharedStmListScope getElseScope()const;
+
+        void setIfCondition(SharedIExpression ifCondition);
+
+        void setIfScope(SharedStmListScope ifScope);
+
+        void setElseScope(SharedStmListScope elseScope);
 };
\ No newline at end of file
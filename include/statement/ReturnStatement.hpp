@@ -16,4 +16,6 @@ class ReturnStatement:public IStatement
         void accept(ASTVisitor *visitor) override;
 
         SharedIExpression getEx()const;
+
+        void setEx(SharedIExpression ex);
 };
\ No newline at end of file
@@ -6,6 +6,9 @@ class VarStm:public IStatement{
     private:
         SharedVariable var;
         SharedIExpression ex;
+        // Resolved once before interpreting, so initializing the var doesn't look up the offsets map
+        int* slotReg=nullptr;
+        int slotOffset=0;
     public:
 
         VarStm(
@@ -20,4 +23,12 @@ class VarStm:public IStatement{
         SharedVariable getVar()const;
 
         SharedIExpression getEx()const;
+
+        void setEx(SharedIExpression ex);
+
+        int* getSlotReg()const;
+
+        int getSlotOffset()const;
+
+        void setSlot(int* reg,int offset);
 };
\ No newline at end of file
@@ -21,4 +21,6 @@ class WhileStatement:public IStatement
         SharedIExpression getCondition()const;
 
         SharedLoopScope getLoopScope()const;
+
+        void setCondition(SharedIExpression condition);
 };
\ No newline at end of file
@@ -1,201 +1,344 @@
 #include "Assembler.hpp"
+#include "string_helper.hpp"
 #include <algorithm>
 #include <iterator>
+#include <sstream>
 #include <string>
 
 namespace Assembler {
 
-    std::wstring AsmInstruction::getAsmText(bool showComment){
-        std::wstring text;
+    const char* AsmInstruction::getName(){
         switch (this->type) {
             case LOCAL_LABEL:
             case INLINE_ASM:
-                return operands[0].value;
+                return "";
             case NOP:
-                text=L"nop";break;
+                return "nop";
             case PUSH:
-                text=L"push";break;
-            case POP
-                :text=L"pop";break;
+                return "push";
+            case POP:
+                return "pop";
             case MOV:
-                text=L"mov";break;
+                return "mov";
+            case MOVSX:
+                return "movsx";
+            case MOVZX:
+                return "movzx";
+            case MOVSXD:
+                return "movsxd";
             case LEA:
-                text=L"lea";break;
+                return "lea";
             case ADD:
-                text=L"add";break;
+                return "add";
             case SUB:
-                text=L"sub";break;
+                return "sub";
             case BSR:
-                text=L"bsr";break;
+                return "bsr";
             case BSF:
-                text=L"bsf";break;
+                return "bsf";
             case XOR:
-                text=L"xor";break;
+                return "xor";
             case OR:
-                text=L"or";break;
+                return "or";
             case AND:
-                text=L"and";break;
+                return "and";
             case SHR:
-                text=L"shr";break;
+                return "shr";
             case SHL:
-                text=L"shl";break;
+                return "shl";
             case CALL:
-                text=L"call";break;
+                return "call";
             case RET:
-                text=L"ret";break;
+                return "ret";
             case SYSCALL:
-                text=L"syscall";break;
+                return "syscall";
             case CMP:
-                text=L"cmp";break;
+                return "cmp";
             case TEST:
-                text=L"test";break;
+                return "test";
             case JMP:
-                text=L"jmp";break;
+                return "jmp";
             case JZ:
-                text=L"jz";break;
+                return "jz";
             case JNZ:
-                text=L"jnz";break;
+                return "jnz";
             case JS:
-                text=L"js";break;
+                return "js";
             case JNS:
-                text=L"jns";break;
+                return "jns";
             case JG:
-                text=L"jg";break;
+                return "jg";
             case JGE:
-                text=L"jge";break;
+                return "jge";
             case JL:
-                text=L"jl";break;
+                return "jl";
             case JLE:
-                text=L"jle";break;
+                return "jle";
             case JA:
-                text=L"ja";break;
+                return "ja";
             case JAE:
-                text=L"jae";break;
+                return "jae";
             case JB:
-                text=L"jb";break;
+                return "jb";
             case JBE:
-                text=L"jbe";break;
+                return "jbe";
             case INC:
-                text=L"inc";break;
+                return "inc";
             case DEC:
-                text=L"dec";break;
+                return "dec";
             case NEG:
-                text=L"neg";break;
+                return "neg";
             case NOT:
-                text=L"not";break;
+                return "not";
             case MUL:
-                text=L"mul";break;
+                return "mul";
             case IMUL:
-                text=L"imul";break;
+                return "imul";
             case DIV:
-                text=L"div";break;
+                return "div";
             case IDIV:
-                text=L"idiv";break;
+                return "idiv";
             case SETZ:
-                text=L"setz";break;
+                return "setz";
             case SETNZ:
-                text=L"setnz";break;
+                return "setnz";
             case SETS:
-                text=L"sets";break;
+                return "sets";
             case SETNS:
-                text=L"setns";break;
+                return "setns";
             case SETG:
-                text=L"setg";break;
+                return "setg";
             case SETGE:
-                text=L"setge";break;
+                return "setge";
             case SETL:
-                text=L"setl";break;
+                return "setl";
             case SETLE:
-                text=L"setle";break;
+                return "setle";
             case SETA:
-                text=L"seta";break;
+                return "seta";
             case SETAE:
-                text=L"setae";break;
+                return "setae";
             case SETB:
-                text=L"setb";break;
+                return "setb";
             case SETBE:
-                text=L"setbe";break;
+                return "setbe";
             case CBW:
-                text=L"cbw";break;
+                return "cbw";
             case CWDE:
-                text=L"cwde";break;
+                return "cwde";
             case CDQE:
-                text=L"cdqe";break;
+                return "cdqe";
             case CWD:
-                text=L"cwd";break;
+                return "cwd";
             case CDQ:
-                text=L"cdq";break;
+                return "cdq";
+            case CQO:
+                return "cqo";
             case CMOVZ:
-                text=L"cmovz";break;
+                return "cmovz";
             case CMOVNZ:
-                text=L"cmovnz";break;
+                return "cmovnz";
             case CMOVS:
-                text=L"cmovs";break;
+                return "cmovs";
             case CMOVG:
-                text=L"cmovg";break;
+                return "cmovg";
+            case BSWAP:
+                return "bswap";
+            case XCHG:
+                return "xchg";
             // SIMD
             case MOVQ:
-                text=L"movq";break;
+                return "movq";
             case MOVD:
-                text=L"movd";break;
+                return "movd";
             case MOVSD:
-                text=L"movsd";break;
+                return "movsd";
             case MOVSS:
-                text=L"movss";break;
+                return "movss";
             case CVTSI2SD:
-                text=L"cvtsi2sd";break;
+                return "cvtsi2sd";
             case CVTSD2SI:
-                text=L"cvtsd2si";break;
+                return "cvtsd2si";
             case CVTSS2SD:
-                text=L"cvtss2sd";break;
+                return "cvtss2sd";
             case CVTSD2SS:
-                text=L"cvtsd2ss";break;
+                return "cvtsd2ss";
             case CVTSI2SS:
-                text=L"cvtsi2ss";break;
+                return "cvtsi2ss";
             case CVTSS2SI:
-                text=L"cvtss2si";break;
+                return "cvtss2si";
             case ADDSD:
-                text=L"addsd";break;
+                return "addsd";
             case SUBSD:
-                text=L"subsd";break;
+                return "subsd";
             case MULSD:
-                text=L"mulsd";break;
+                return "mulsd";
             case DIVSD:
-                text=L"divsd";break;
+                return "divsd";
             case ADDSS:
-                text=L"addss";break;
+                return "addss";
             case SUBSS:
-                text=L"subss";break;
+                return "subss";
             case MULSS:
-                text=L"mulss";break;
+                return "mulss";
             case DIVSS:
-                text=L"divss";break;
+                return "divss";
             case ROUNDSD:
-                text=L"roundsd";break;
+                return "roundsd";
             case ROUNDSS:
-                text=L"roundss";break;
+                return "roundss";
+            // Packed SIMD
+            case MOVDQU:
+                return "movdqu";
+            case MOVDQA:
+                return "movdqa";
+            case PSHUFD:
+                return "pshufd";
+            case PSRLDQ:
+                return "psrldq";
+            case PADDB:
+                return "paddb";
+            case PADDW:
+                return "paddw";
+            case PADDD:
+                return "paddd";
+            case PADDQ:
+                return "paddq";
+            case PSUBB:
+                return "psubb";
+            case PSUBW:
+                return "psubw";
+            case PSUBD:
+                return "psubd";
+            case PSUBQ:
+                return "psubq";
+            case PAND:
+                return "pand";
+            case POR:
+                return "por";
+            case PXOR:
+                return "pxor";
+            case ADDPS:
+                return "addps";
+            case SUBPS:
+                return "subps";
+            case MULPS:
+                return "mulps";
+            case DIVPS:
+                return "divps";
+            case ADDPD:
+                return "addpd";
+            case SUBPD:
+                return "subpd";
+            case MULPD:
+                return "mulpd";
+            case DIVPD:
+                return "divpd";
+            // AVX2
+            case VMOVDQU:
+                return "vmovdqu";
+            case VPADDB:
+                return "vpaddb";
+            case VPADDW:
+                return "vpaddw";
+            case VPADDD:
+                return "vpaddd";
+            case VPADDQ:
+                return "vpaddq";
+            case VPSUBB:
+                return "vpsubb";
+            case VPSUBW:
+                return "vpsubw";
+            case VPSUBD:
+                return "vpsubd";
+            case VPSUBQ:
+                return "vpsubq";
+            case VPAND:
+                return "vpand";
+            case VPOR:
+                return "vpor";
+            case VPXOR:
+                return "vpxor";
+            case VADDPS:
+                return "vaddps";
+            case VSUBPS:
+                return "vsubps";
+            case VMULPS:
+                return "vmulps";
+            case VDIVPS:
+                return "vdivps";
+            case VADDPD:
+                return "vaddpd";
+            case VSUBPD:
+                return "vsubpd";
+            case VMULPD:
+                return "vmulpd";
+            case VDIVPD:
+                return "vdivpd";
+            case VPBROADCASTD:
+                return "vpbroadcastd";
+            case VPBROADCASTQ:
+                return "vpbroadcastq";
+            case VEXTRACTI128:
+                return "vextracti128";
+            case VZEROUPPER:
+                return "vzeroupper";
+            case REP_MOVSB:
+                return "rep movsb";
+            case REP_STOSB:
+                return "rep stosb";
+            case PCMPEQB:
+                return "pcmpeqb";
+            case PMOVMSKB:
+                return "pmovmskb";
+        }
+        return "";
+    }
+
+    void AsmInstruction::writeAsmText(std::ostream& out, bool showComment){
+        if(type==LOCAL_LABEL||type==INLINE_ASM){
+            writeUtf8(out, operands[0].value);
+            return;
         }
 
+        out<<getName();
+
+        const char* sizeText="";
         switch (size) {
             case IMPLICIT:;break;
             case BYTE:
-                text+=L" BYTE";break;
+                sizeText="BYTE";break;
             case WORD:
-                text+=L" WORD";break;
+                sizeText="WORD";break;
             case DWORD:
-                text+=L" DWORD";break;
+                sizeText="DWORD";break;
             case QWORD:
-                text+=L" QWORD";break;
+                sizeText="QWORD";break;
         }
 
+        auto isSourceSized=type==MOVSX||type==MOVZX||type==MOVSXD;
+
+        if(size!=IMPLICIT&&!isSourceSized)
+            out<<' '<<sizeText;
+
         auto i=0;
         for (auto &operand : this->operands) {
-            text+=((i==0)?L" ":L", ")+operand.value;
+            out<<((i==0)?" ":", ");
+            if(i==1&&isSourceSized&&size!=IMPLICIT)
+                out<<sizeText<<' ';
+            writeUtf8(out, operand.value);
             i++;
         }
-        if(!this->comment.empty()&&showComment)
-            text+=L"\t; "+comment;
-        return text;
+        if(!this->comment.empty()&&showComment){
+            out<<"\t; ";
+            writeUtf8(out, comment);
+        }
+    }
+
+    std::wstring AsmInstruction::getAsmText(bool showComment){
+        std::ostringstream out;
+        writeAsmText(out, showComment);
+        return toWstring(out.str());
     }
 
     void AsmLabel::operator+=(AsmInstruction instruction){
@@ -213,19 +356,49 @@ namespace Assembler {
         );
     }
 
-    std::wstring AsmLabel::getAsmText(){
-        auto text=this->label+L":";
-        if(!this->comment.empty())
-            text+=L"\t; "+comment;
+    void AsmLabel::writeAsmText(std::ostream& out){
+        writeUtf8(out, label);
+        out<<':';
+        if(!this->comment.empty()){
+            out<<"\t; ";
+            writeUtf8(out, comment);
+        }
         for (auto& instruction : this->instructions) {
-            text+=L"\n";
+            out<<'\n';
             if(instruction.type==AsmInstruction::LOCAL_LABEL)
-                text+=L"\n";
+                out<<'\n';
             else
-                text+=L"\t";
-            text+=instruction.getAsmText();
+                out<<'\t';
+            instruction.writeAsmText(out);
+        }
+    }
+
+    void AsmData::writeAsmText(std::ostream& out){
+        const char* reserveText;
+        const char* defineText;
+        switch (size) {
+            case AsmInstruction::BYTE:
+                reserveText="RESB";defineText="db";break;
+            case AsmInstruction::WORD:
+                reserveText="RESW";defineText="dw";break;
+            case AsmInstruction::DWORD:
+                reserveText="RESD";defineText="dd";break;
+            default:
+                reserveText="RESQ";defineText="dq";break;
         }
-        return text;
+
+        out<<'\t';
+        writeUtf8(out, label);
+
+        if(values.empty()){
+            out<<":\t"<<reserveText<<' '<<reservedSize;
+            return;
+        }
+
+        out<<' '<<defineText;
+        auto i=0;
+        for(auto value:values)
+            out<<((i++==0)?" ":", ")<<value;
     }
 
     AsmInstruction localLabel(std::wstring label, std::wstring comment){
@@ -277,6 +450,33 @@ namespace Assembler {
         };
     }
 
+    AsmInstruction movsx(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::MOVSX,
+            .size=size,
+            .operands={d, s},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction movzx(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::MOVZX,
+            .size=size,
+            .operands={d, s},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction movsxd(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::MOVSXD,
+            .size=size,
+            .operands={d, s},
+            .comment=comment
+        };
+    }
+
     AsmInstruction lea(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size, std::wstring comment){
         return AsmInstruction{
             .type=AsmInstruction::LEA,
@@ -457,6 +657,38 @@ namespace Assembler {
         };
     }
 
+    AsmInstruction jg(AsmOperand label, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::JG,
+            .operands={label},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction jle(AsmOperand label, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::JLE,
+            .operands={label},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction ja(AsmOperand label, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::JA,
+            .operands={label},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction jae(AsmOperand label, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::JAE,
+            .operands={label},
+            .comment=comment
+        };
+    }
+
     AsmInstruction jb(AsmOperand label, std::wstring comment){
         return AsmInstruction{
             .type=AsmInstruction::JB,
@@ -465,6 +697,14 @@ namespace Assembler {
         };
     }
 
+    AsmInstruction jbe(AsmOperand label, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::JBE,
+            .operands={label},
+            .comment=comment
+        };
+    }
+
     AsmInstruction inc(AsmOperand d, AsmInstruction::InstructionSize size, std::wstring comment){
         return AsmInstruction{
             .type=AsmInstruction::INC,
@@ -519,6 +759,14 @@ namespace Assembler {
         };
     }
 
+    AsmInstruction imul(AsmOperand d, AsmOperand s, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::IMUL,
+            .operands={d, s},
+            .comment=comment
+        };
+    }
+
     AsmInstruction div(AsmOperand s, AsmInstruction::InstructionSize size, std::wstring comment){
         return AsmInstruction{
             .type=AsmInstruction::DIV,
@@ -690,6 +938,15 @@ namespace Assembler {
         };
     }
 
+    AsmInstruction cqo(std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::CQO,
+            .size=AsmInstruction::IMPLICIT,
+            .operands={},
+            .comment=comment
+        };
+    }
+
     AsmInstruction cmovz(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size, std::wstring comment){
         return AsmInstruction{
             .type=AsmInstruction::CMOVZ,
@@ -726,6 +983,22 @@ namespace Assembler {
         };
     }
 
+    AsmInstruction bswap(AsmOperand d, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::BSWAP,
+            .operands={d},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction xchg(AsmOperand d, AsmOperand s, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::XCHG,
+            .operands={d, s},
+            .comment=comment
+        };
+    }
+
     // SIMD
     
     AsmInstruction movq(AsmOperand d, AsmOperand s, AsmInstruction::InstructionSize size, std::wstring comment){
@@ -907,6 +1180,126 @@ namespace Assembler {
         };
     }
 
+    AsmInstruction movdqu(AsmOperand d, AsmOperand s, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::MOVDQU,
+            .size=AsmInstruction::IMPLICIT,
+            .operands={d,s},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction movdqa(AsmOperand d, AsmOperand s, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::MOVDQA,
+            .size=AsmInstruction::IMPLICIT,
+            .operands={d,s},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction pshufd(AsmOperand d, AsmOperand s, int order, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::PSHUFD,
+            .size=AsmInstruction::IMPLICIT,
+            .operands={d,s, imm(std::to_wstring(order))},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction psrldq(AsmOperand d, int bytes, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::PSRLDQ,
+            .size=AsmInstruction::IMPLICIT,
+            .operands={d, imm(std::to_wstring(bytes))},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction packed(AsmInstruction::InstructionType type, AsmOperand d, AsmOperand s, std::wstring comment){
+        return AsmInstruction{
+            .type=type,
+            .size=AsmInstruction::IMPLICIT,
+            .operands={d,s},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction vmovdqu(AsmOperand d, AsmOperand s, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::VMOVDQU,
+            .size=AsmInstruction::IMPLICIT,
+            .operands={d,s},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction vpacked(AsmInstruction::InstructionType type, AsmOperand d, AsmOperand s1, AsmOperand s2, std::wstring comment){
+        return AsmInstruction{
+            .type=type,
+            .size=AsmInstruction::IMPLICIT,
+            .operands={d,s1,s2},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction vpbroadcastd(AsmOperand d, AsmOperand s, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::VPBROADCASTD,
+            .size=AsmInstruction::IMPLICIT,
+            .operands={d,s},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction vpbroadcastq(AsmOperand d, AsmOperand s, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::VPBROADCASTQ,
+            .size=AsmInstruction::IMPLICIT,
+            .operands={d,s},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction vextracti128(AsmOperand d, AsmOperand s, int half, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::VEXTRACTI128,
+            .size=AsmInstruction::IMPLICIT,
+            .operands={d,s, imm(std::to_wstring(half))},
+            .comment=comment
+        };
+    }
+
+    AsmInstruction vzeroupper(std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::VZEROUPPER,
+            .comment=comment
+        };
+    }
+
+    AsmInstruction repMovsb(std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::REP_MOVSB,
+            .comment=comment
+        };
+    }
+
+    AsmInstruction repStosb(std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::REP_STOSB,
+            .comment=comment
+        };
+    }
+
+    AsmInstruction pmovmskb(AsmOperand d, AsmOperand s, std::wstring comment){
+        return AsmInstruction{
+            .type=AsmInstruction::PMOVMSKB,
+            .size=AsmInstruction::IMPLICIT,
+            .operands={d,s},
+            .comment=comment
+        };
+    }
+
     AsmInstruction reserveSpaceOnStack(int size, std::wstring comment){
         if(size==0)
             return nop(comment);
@@ -963,6 +1356,14 @@ namespace Assembler {
         return AsmOperand{.type=AsmOperand::REG, .value=L"XMM1"};
     }
 
+    AsmOperand XMM(int number){
+        return AsmOperand{.type=AsmOperand::REG, .value=L"XMM"+std::to_wstring(number)};
+    }
+
+    AsmOperand YMM(int number){
+        return AsmOperand{.type=AsmOperand::REG, .value=L"YMM"+std::to_wstring(number)};
+    }
+
     AsmOperand RAX(int size){
         auto value=L"";
         switch (size) {
@@ -1132,7 +1533,7 @@ namespace Assembler {
         auto value=L"";
         switch (size) {
             case AsmInstruction::BYTE:
-                value=L"R11"; break;
+                value=L"R11B"; break;
             case AsmInstruction::WORD:
                 value=L"R11W"; break;
             case AsmInstruction::DWORD:
@@ -1143,6 +1544,66 @@ namespace Assembler {
         return AsmOperand{.type=AsmOperand::REG, .value=value};
     }
 
+    AsmOperand R12(int size){
+        auto value=L"";
+        switch (size) {
+            case AsmInstruction::BYTE:
+                value=L"R12B"; break;
+            case AsmInstruction::WORD:
+                value=L"R12W"; break;
+            case AsmInstruction::DWORD:
+                value=L"R12D"; break;
+            default:
+                value=L"R12"; break;
+        }
+        return AsmOperand{.type=AsmOperand::REG, .value=value};
+    }
+
+    AsmOperand R13(int size){
+        auto value=L"";
+        switch (size) {
+            case AsmInstruction::BYTE:
+                value=L"R13B"; break;
+            case AsmInstruction::WORD:
+                value=L"R13W"; break;
+            case AsmInstruction::DWORD:
+                value=L"R13D"; break;
+            default:
+                value=L"R13"; break;
+        }
+        return AsmOperand{.type=AsmOperand::REG, .value=value};
+    }
+
+    AsmOperand R14(int size){
+        auto value=L"";
+        switch (size) {
+            case AsmInstruction::BYTE:
+                value=L"R14B"; break;
+            case AsmInstruction::WORD:
+                value=L"R14W"; break;
+            case AsmInstruction::DWORD:
+                value=L"R14D"; break;
+            default:
+                value=L"R14"; break;
+        }
+        return AsmOperand{.type=AsmOperand::REG, .value=value};
+    }
+
+    AsmOperand R15(int size){
+        auto value=L"";
+        switch (size) {
+            case AsmInstruction::BYTE:
+                value=L"R15B"; break;
+            case AsmInstruction::WORD:
+                value=L"R15W"; break;
+            case AsmInstruction::DWORD:
+                value=L"R15D"; break;
+            default:
+                value=L"R15"; break;
+        }
+        return AsmOperand{.type=AsmOperand::REG, .value=value};
+    }
+
     AsmOperand brk_end(){
         return AsmOperand{.type=AsmOperand::REG, .value=L"brk_end"}; // simulate that it as a register
     }
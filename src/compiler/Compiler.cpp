@@ -14,20 +14,32 @@
 #include "IExpression.hpp"
 #include "IfStatement.hpp"
 #include "IntValue.hpp"
+#include "IRBuilder.hpp"
+#include "IRCompiler.hpp"
+#include "IRPasses.hpp"
 #include "KeywordToken.hpp"
 #include "LiteralExpression.hpp"
 #include "LongValue.hpp"
+#include "LoopVectorizer.hpp"
 #include "NonStaticFunInvokeExpression.hpp"
 #include "NonStaticVarAccessExpression.hpp"
 #include "OperatorFunInvokeExpression.hpp"
 #include "OperatorFunctions.hpp"
 #include "PackageScope.hpp"
+#include "Peephole.hpp"
+#include "Encoder.hpp"
+#include "Elf.hpp"
+#include "parallel_helper.hpp"
 #include "SetOperatorExpression.hpp"
 #include "SharedPtrTypes.hpp"
+#include "ShortValue.hpp"
 #include "StmListScope.hpp"
 #include "StringValue.hpp"
 #include "ThisVarAccessExpression.hpp"
 #include "Type.hpp"
+#include "UByteValue.hpp"
+#include "UIntValue.hpp"
+#include "UShortValue.hpp"
 #include "ULongValue.hpp"
 #include "VarAccessExpression.hpp"
 #include "Variable.hpp"
@@ -35,9 +47,13 @@
 #include "BuiltInFilePaths.hpp"
 #include "string_helper.hpp"
 #include "wchar_t_helper.hpp"
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 void Compiler::visit(PackageScope* scope){
@@ -100,18 +116,49 @@ void Compiler::visit(FunScope* scope){
     currentIfLabelsSize=0;
     currentLogicalShortcutsLabelsSize=0;
 
+    // The global functions that only use integers are optimized in the IR
+    std::unique_ptr<IR::Function> irFun;
+    if(!isConstructor&&!parentClass&&!isMain)
+        irFun=IRBuilder::build(scope);
+
+    if(irFun){
+        IR::optimize(irFun.get());
+        auto irCompiler=std::make_unique<IRCompiler>(this, std::move(irFun), currentAsmLabel);
+        if(irCompiler->prepare()){
+            irCompilers.push_back(std::move(irCompiler));
+            currentAsmLabel=prevLabelAsm;
+            currentLoopLabelsSize=prevLoopsLabelsSize;
+            currentIfLabelsSize=prevIfLabelsSize;
+            currentLogicalShortcutsLabelsSize=prevLogicalShortcutsLabelsSize;
+            return;
+        }
+    }
+
     *currentAsmLabel+=Assembler::push(Assembler::RBP());
     *currentAsmLabel+=Assembler::mov(Assembler::RBP(), Assembler::RSP());
 
-    if(isConstructor)
-        decl->returnType->getClassScope()->accept(this);
+    // locals contains params, the ones passed in registers are saved in the frame
+    auto allLocalsSize=getLocalsSize(scope)-getStackParamsSize(scope);
 
-    // locals contains params, so we don't offset params
-    auto params=scope->getParamsFromLocals();
+    *currentAsmLabel+=Assembler::reserveSpaceOnStack(allLocalsSize);
 
-    auto allLocalsSize=getLocalsSize(scope)-getVariablesSize(params);
+    if(CompilerVarsOffsetSetter::hasRegisterParams(scope)){
+        auto params=decl->params;
+        auto locals=scope->getLocals();
+        for(int i=0;i<params->size()&&i<CompilerVarsOffsetSetter::PARAMS_REGISTERS.size();i++){
+            auto var=(*locals)[*(*params)[i]->name].get();
+            auto offset=offsets[var];
+            *currentAsmLabel+=Assembler::mov(
+                Assembler::addressMov(offset.reg, offset.value),
+                CompilerVarsOffsetSetter::PARAMS_REGISTERS[i](getVariableSize(var)),
+                Assembler::AsmInstruction::IMPLICIT,
+                L"مُعامِل "+*var->getName()
+            );
+        }
+    }
 
-    *currentAsmLabel+=Assembler::reserveSpaceOnStack(allLocalsSize);
+    if(isConstructor)
+        decl->returnType->getClassScope()->accept(this);
 
     for(auto stm:*scope->getStmList()){
         stm->accept(this);
@@ -129,7 +176,7 @@ void Compiler::visit(FunScope* scope){
     *currentAsmLabel+=Assembler::pop(Assembler::RBP());
     
     if(isMain){
-        *currentAsmLabel+=Assembler::exit(0, L"إنهاء البرنامج");
+        *currentAsmLabel+=exitAsm(0, L"إنهاء البرنامج");
         startAsmLabel=currentAsmLabel;
     }
     else
@@ -256,7 +303,7 @@ void Compiler::visit(AugmentedAssignStatement* stm){
         }
 
         *currentAsmLabel+=Assembler::call(
-            Assembler::label(labelsAsm[fun].label),
+            Assembler::label(getStackArgsLabel(fun)),
             L"استدعاء دالة "+fun->getParentScope()->getName()+L"::"+fun->getDecl()->toString()
         );
 
@@ -271,6 +318,15 @@ void Compiler::visit(AugmentedAssignStatement* stm){
 
 void Compiler::visit(IfStatement* stm){
 
+    // The constant folder leaves only the taken arm when the condition is known
+    if(auto conditionLit=std::dynamic_pointer_cast<LiteralExpression>(stm->getIfCondition())){
+        auto conditionVal=std::dynamic_pointer_cast<BoolValue>(conditionLit->getValue());
+        if(conditionVal&&conditionVal->getValue()&&!stm->getElseScope()){
+            stm->getIfScope()->accept(this);
+            return;
+        }
+    }
+
     auto elseScope=stm->getElseScope().get();
 
     auto ifNumStr=std::to_wstring(++currentIfLabelsSize);
@@ -334,7 +390,7 @@ void Compiler::visit(ReturnStatement* stm){
     stm->getEx()->accept(this);
 
     if(labelsAsm[fun].label==L"_start"){
-        *currentAsmLabel+=Assembler::exit(0, L"إنهاء البرنامج");
+        *currentAsmLabel+=exitAsm(0, L"إنهاء البرنامج");
         return;
     }
 
@@ -372,21 +428,19 @@ void Compiler::visit(VarAccessExpression* ex){
         return;
 
     // The variable is global
-    
-    if(inUseGlobalVariables.find(var)==inUseGlobalVariables.end()){
-        inUseGlobalVariables[var]={};
-        bssAsm+=L"\t"+offset.reg.value+L":\t";
-        switch (varSize) {
-            case Assembler::AsmInstruction::BYTE:
-                bssAsm+=L"RESB 1\n";break;
-            case Assembler::AsmInstruction::WORD:
-                bssAsm+=L"RESW 1\n";break;
-            case Assembler::AsmInstruction::DWORD:
-                bssAsm+=L"RESD 1\n";break;
-            case Assembler::AsmInstruction::QWORD:
-                bssAsm+=L"RESQ 1\n";break;
-        }
-    }
+    useGlobalVariable(var);
+}
+
+void Compiler::useGlobalVariable(Variable* var){
+    if(inUseGlobalVariables.find(var)!=inUseGlobalVariables.end())
+        return;
+
+    inUseGlobalVariables[var]={};
+    bssAsm.push_back(Assembler::AsmData{
+        .label=offsets[var].reg.value,
+        .size=(Assembler::AsmInstruction::InstructionSize)getVariableSize(var),
+        .reservedSize=1
+    });
 }
 
 void Compiler::visit(FunInvokeExpression* ex){
@@ -465,7 +519,7 @@ void Compiler::visit(NewObjectExpression* ex){
 
     auto size=ex->getReturnType()->getClassScope()->getSize();
     *currentAsmLabel+=Assembler::push(Assembler::imm(std::to_wstring(size))); // The size arg
-    *currentAsmLabel+=Assembler::call(Assembler::label(labelsAsm[AIN_ALLOC].label)); // call ainalloc
+    *currentAsmLabel+=Assembler::call(Assembler::label(getStackArgsLabel(AIN_ALLOC))); // call ainalloc
     *currentAsmLabel+=Assembler::pop(Assembler::RDX()); // The size arg
 
     callFunAsm(
@@ -476,6 +530,16 @@ void Compiler::visit(NewObjectExpression* ex){
 }
 
 void Compiler::visit(NewArrayExpression* ex){
+    if(ex->isConstant()){
+        *currentAsmLabel+=Assembler::lea(
+            Assembler::RAX(),
+            Assembler::addressLea(addConstantArrayData(ex)),
+            Assembler::AsmInstruction::IMPLICIT,
+            L"الوصول لمصفوفة ثابتة"
+        );
+        return;
+    }
+
     addAinAllocAsm();
 
     auto capExs=ex->getCapacities();
@@ -496,7 +560,7 @@ void Compiler::visit(NewArrayExpression* ex){
 
         *currentAsmLabel+=Assembler::push(Assembler::RAX()); // push the size arg for ainalloc
 
-        *currentAsmLabel+=Assembler::call(Assembler::label(labelsAsm[AIN_ALLOC].label), L"استدعاء دالة احجز(كبير)");
+        *currentAsmLabel+=Assembler::call(Assembler::label(getStackArgsLabel(AIN_ALLOC)), L"استدعاء دالة احجز(كبير)");
 
         *currentAsmLabel+=Assembler::pop(Assembler::RDX()); // the size arg for ainalloc
         *currentAsmLabel+=Assembler::pop(Assembler::RDX()); // the user size
@@ -524,12 +588,99 @@ void Compiler::visit(NewArrayExpression* ex){
     *currentAsmLabel+=Assembler::push(Assembler::RSP(), L"مُعامل الأبعاد: [كبير]"); // The array of dimensions args
     *currentAsmLabel+=Assembler::push(Assembler::imm(std::to_wstring(elementSize)), L"مُعامل حجم_العنصر: كبير");
 
-    *currentAsmLabel+=Assembler::call(Assembler::label(labelsAsm[AIN_ALLOCATE_ARRAY].label), L"استدعاء دالة احجز_مصفوفة([كيبر]، كبير)"); // call ainallocatearray
+    *currentAsmLabel+=Assembler::call(Assembler::label(getStackArgsLabel(AIN_ALLOCATE_ARRAY)), L"استدعاء دالة احجز_مصفوفة([كيبر]، كبير)"); // call ainallocatearray
 
     *currentAsmLabel+=Assembler::removeReservedSpaceFromStack(capExs.size()*8+3*8); // remove also the args of ainalocatearray, i.e. the 3 pushed values
 
 }
 
+std::wstring Compiler::addConstantArrayData(NewArrayExpression* ex){
+    auto labelIt=constantArraysLabels.find(ex);
+    if(labelIt!=constantArraysLabels.end())
+        return labelIt->second;
+
+    auto label=L"arr"+std::to_wstring(constantArraysLabels.size()+1);
+    constantArraysLabels[ex]=label;
+
+    auto values=ex->getValues();
+    auto elementType=ex->getReturnType()->asArray()->getType();
+    auto elementSize=Type::getSize(elementType.get());
+
+    if(*elementType==*Type::STRING||elementType->asArray()||elementSize==0)
+        throw AinException(L"في السطر"+std::to_wstring(ex->getLineNumber())+L"\nعناصر المصفوفة الثابتة يجب أن تكون أعداداً أو أحرفاً أو قيماً منطقية.");
+
+    // The size property, then the elements packed in little endian qwords like the allocated arrays
+    auto data=Assembler::AsmData{.label=label, .size=Assembler::AsmInstruction::QWORD, .values={(long long)values->size()}};
+    auto elementsPerQword=8/elementSize;
+    auto elementMask=(elementSize==8)?~0ULL:(1ULL<<(elementSize*8))-1;
+
+    for(int i=0;i<values->size();i+=elementsPerQword){
+        unsigned long long bytes=0;
+        for(int j=0;j<elementsPerQword&&i+j<values->size();j++){
+            auto lit=std::dynamic_pointer_cast<LiteralExpression>((*values)[i+j]);
+            if(!lit)
+                throw AinException(L"في السطر"+std::to_wstring((*values)[i+j]->getLineNumber())+L"\nعناصر المصفوفة الثابتة يجب أن تكون قيماً محددة.");
+            bytes|=(getLiteralBits(lit.get())&elementMask)<<(j*elementSize*8);
+        }
+        data.values.push_back((long long)bytes);
+    }
+
+    rodataAsm.push_back(data);
+
+    return label;
+}
+
+unsigned long long Compiler::getLiteralBits(LiteralExpression* ex){
+    auto value=ex->getValue();
+
+    if(auto val=std::dynamic_pointer_cast<BoolValue>(value))
+        return val->getValue();
+
+    if(auto val=std::dynamic_pointer_cast<CharValue>(value)){
+        // The utf-8 bytes like the assembler makes of the char in quotes
+        auto chars=toCharPointer(val->toString());
+        auto utf8=std::string(chars);
+        delete[] chars;
+        unsigned long long bytes=0;
+        for(int i=utf8.size()-1;i>=0;i--)
+            bytes=(bytes<<8)|(unsigned char)utf8[i];
+        return bytes;
+    }
+
+    if(auto val=std::dynamic_pointer_cast<FloatValue>(value)){
+        float fVal=val->getValue();
+        unsigned int bits;
+        std::memcpy(&bits, &fVal, sizeof(bits));
+        return bits;
+    }
+
+    if(auto val=std::dynamic_pointer_cast<DoubleValue>(value)){
+        double dVal=val->getValue();
+        unsigned long long bits;
+        std::memcpy(&bits, &dVal, sizeof(bits));
+        return bits;
+    }
+
+    if(auto val=std::dynamic_pointer_cast<ByteValue>(value))
+        return (long long)val->getValue();
+    if(auto val=std::dynamic_pointer_cast<UByteValue>(value))
+        return val->getValue();
+    if(auto val=std::dynamic_pointer_cast<ShortValue>(value))
+        return (long long)val->getValue();
+    if(auto val=std::dynamic_pointer_cast<UShortValue>(value))
+        return val->getValue();
+    if(auto val=std::dynamic_pointer_cast<IntValue>(value))
+        return (long long)val->getValue();
+    if(auto val=std::dynamic_pointer_cast<UIntValue>(value))
+        return val->getValue();
+    if(auto val=std::dynamic_pointer_cast<LongValue>(value))
+        return val->getValue();
+    if(auto val=std::dynamic_pointer_cast<ULongValue>(value))
+        return val->getValue();
+
+    throw AinException(L"في السطر"+std::to_wstring(ex->getLineNumber())+L"\nعناصر المصفوفة الثابتة يجب أن تكون أعداداً أو أحرفاً أو قيماً منطقية.");
+}
+
 void Compiler::visit(LiteralExpression* ex){
 
     auto value=ex->getValue();
@@ -573,38 +724,29 @@ void Compiler::visit(LiteralExpression* ex){
         auto wstr=strVal->toString();
         auto str=std::string(toCharPointer(wstr));
 
-        addAinAllocAsm();
-        
-        *currentAsmLabel+=Assembler::push(
-            Assembler::imm(std::to_wstring(str.size()+8)), // add 8 bytes for the size property
-            L"مُعامل الحجم_بالبايت: كبير"
-        );
-        *currentAsmLabel+=Assembler::call(Assembler::label(labelsAsm[AIN_ALLOC].label), L"استدعاء دالة احجز(كبير)");
-        *currentAsmLabel+=Assembler::pop(Assembler::RDX()); // size arg
+        // The strings are immutable, so each literal is written once in the read-only data and shared by all its evaluations
+        auto labelIt=stringLiteralsLabels.find(wstr);
+        if(labelIt==stringLiteralsLabels.end()){
+            auto label=L"str"+std::to_wstring(stringLiteralsLabels.size()+1);
+            labelIt=stringLiteralsLabels.insert({wstr, label}).first;
+
+            // The size property, then the bytes in little endian qwords
+            auto data=Assembler::AsmData{.label=label, .size=Assembler::AsmInstruction::QWORD, .values={(long long)str.size()}};
+            for(auto i=0;i<str.size();i+=8){
+                uint64_t bytes=0;
+                for(int j=std::min<int>(str.size()-i, 8)-1;j>=0;j--)
+                    bytes=(bytes<<8)|(uint8_t)str[i+j];
+                data.values.push_back((long long)bytes);
+            }
+            rodataAsm.push_back(data);
+        }
 
-        *currentAsmLabel+=Assembler::mov(
-            Assembler::addressMov(Assembler::RAX()),
-            Assembler::imm(std::to_wstring(str.size())),
-            Assembler::AsmInstruction::QWORD
+        *currentAsmLabel+=Assembler::lea(
+            Assembler::RAX(),
+            Assembler::addressLea(labelIt->second),
+            Assembler::AsmInstruction::IMPLICIT,
+            L"الوصول لنص ثابت"
         );
-        for (auto i = 0; i < str.size(); i += 4) {
-            union double_bytes {
-                char cVal[4]={0};
-                int lVal;
-            } data;
-
-            auto substr=str.substr(i, 4);
-            auto j=0;
-            for(auto &c:substr)
-                data.cVal[j++]=c;
-            
-            auto subStrImm=Assembler::imm(std::to_wstring(data.lVal));
-            *currentAsmLabel+=Assembler::mov(
-                Assembler::addressMov(Assembler::RAX(), i+8),
-                subStrImm,
-                Assembler::AsmInstruction::DWORD
-            );
-        }
 
         return;
 
@@ -681,6 +823,7 @@ void Compiler::visit(NonStaticFunInvokeExpression* ex){
         auto fun=BuiltInFunScope::INT_TO_CHAR.get();
         auto comment=L"دالة "+*Type::INT_NAME+L"::"+fun->getDecl()->toString();
         if (labelsAsm.find(fun)==labelsAsm.end()){
+            auto exitLabel=addAinExitAsm(); // Added before the label, it may add other labels
             auto label=L"method"+std::to_wstring(++methodLabelsSize);
             labelsAsm[fun]=Assembler::AsmLabel{.label=label, .comment=comment};
             labelsAsm[fun]+=Assembler::inline_asm(
@@ -757,30 +900,24 @@ void Compiler::visit(NonStaticFunInvokeExpression* ex){
                 L"\n\n._ret:"
                 L"\n\tret"
                 L"\n\n.exit:"
-                L"\n\tmov RAX, 60"
-                L"\n\tmov RDI, 1"
-                L"\n\tsyscall"
+                L"\n\tpush 1"
+                L"\n\tcall "+exitLabel+L" ; إنهاء البرنامج بعد إفراغ الإخراج"
             );
             
-            dataAsm+=L"\tutf8CvtIntToChar dd 0,\n";
-            dataAsm+=L"\tkufrAndInvalidChars dd ";
-            auto i=0;
+            dataAsm.push_back(Assembler::AsmData{.label=L"utf8CvtIntToChar", .size=Assembler::AsmInstruction::DWORD, .values={0}});
+            auto kufrAndInvalidCharsData=Assembler::AsmData{.label=L"kufrAndInvalidChars", .size=Assembler::AsmInstruction::DWORD};
             for (auto c : kufrAndInvalidChars) {
-                dataAsm+=std::to_wstring((int)c)+L", ";
-                if(++i==kufrAndInvalidChars.size()/2)
-                    dataAsm+=L"\\\n\t";
+                kufrAndInvalidCharsData.values.push_back((int)c);
             }
-            dataAsm+=L"\n\tkufrAndInvalidCharsRangesMin dd ";
-            i=0;
+            rodataAsm.push_back(kufrAndInvalidCharsData);
+            auto rangesMinData=Assembler::AsmData{.label=L"kufrAndInvalidCharsRangesMin", .size=Assembler::AsmInstruction::DWORD};
+            auto rangesMaxData=Assembler::AsmData{.label=L"kufrAndInvalidCharsRangesMax", .size=Assembler::AsmInstruction::DWORD};
             for (auto p : kufrAndInvalidCharsRanges) {
-                dataAsm+=std::to_wstring((int)p.first)+L", ";
+                rangesMinData.values.push_back((int)p.first);
+                rangesMaxData.values.push_back((int)p.second);
             }
-            dataAsm+=L"\n\tkufrAndInvalidCharsRangesMax dd ";
-            i=0;
-            for (auto p : kufrAndInvalidCharsRanges) {
-                dataAsm+=std::to_wstring((int)p.second)+L", ";
-            }
-            dataAsm+=L"\n";
+            rodataAsm.push_back(rangesMinData);
+            rodataAsm.push_back(rangesMaxData);
             /* TODO: Use SIMD and AVX instructions
 
             labelsAsm[fun]+=Assembler::inline_asm(
@@ -829,9 +966,8 @@ void Compiler::visit(NonStaticFunInvokeExpression* ex){
                     L"\n\tjnz .exit"
                     L"\n\tret"
                     L"\n.exit:"
-                    L"\n\tmov RAX, 60"
-                    L"\n\tmov RDI, 1"
-                    L"\n\tsyscall"   
+                    L"\n\tpush 1"
+                    L"\n\tcall "+exitLabel   
             );
             auto d=1;
             const auto alignment=8;
@@ -1070,7 +1206,7 @@ void Compiler::visit(SetOperatorExpression* ex){
             funOfGet->accept(this);
 
         *currentAsmLabel+=Assembler::call(
-            Assembler::label(labelsAsm[funOfGet].label),
+            Assembler::label(getStackArgsLabel(funOfGet)),
             L"استدعاء دالة "+*ex->getExHasGetOp()->getReturnType()->getName()+L"::"+funOfGet->getDecl()->toString()
         );
 
@@ -1123,7 +1259,7 @@ void Compiler::visit(SetOperatorExpression* ex){
                 funOfOp->accept(this);
 
             *currentAsmLabel+=Assembler::call(
-                Assembler::label(labelsAsm[funOfOp].label),
+                Assembler::label(getStackArgsLabel(funOfOp)),
                 L"استدعاء دالة "+funOfOp->getParentScope()->getName()+L"::"+funOfOp->getDecl()->toString()
             );
             
@@ -1148,7 +1284,7 @@ void Compiler::visit(SetOperatorExpression* ex){
             funOfSet->accept(this);
 
         *currentAsmLabel+=Assembler::call(
-            Assembler::label(labelsAsm[funOfSet].label),
+            Assembler::label(getStackArgsLabel(funOfSet)),
             L"استدعاء دالة "+*ex->getExHasGetOp()->getReturnType()->getName()+L"::"+funOfSet->getDecl()->toString()
         );
 
@@ -1159,7 +1295,7 @@ void Compiler::visit(SetOperatorExpression* ex){
                 *currentAsmLabel+=Assembler::removeReservedSpaceFromStack(valueToSetSize); // remove value to set from the stack
 
             *currentAsmLabel+=Assembler::call(
-                Assembler::label(labelsAsm[funOfGet].label),
+                Assembler::label(getStackArgsLabel(funOfGet)),
                 L"استدعاء دالة "+*ex->getExHasGetOp()->getReturnType()->getName()+L"::"+funOfGet->getDecl()->toString()
             );
 
@@ -1225,10 +1361,12 @@ void Compiler::visit(ThisFunInvokeExpression* ex){
     callFunAsm(ex->getFun().get(),ex->getArgs());
 }
 
-std::wstring Compiler::getAssemblyFile(){
+std::vector<Assembler::AsmLabel>& Compiler::getFinalLabels(){
+
+    if(!finalLabels.empty())
+        return finalLabels;
 
     if(!bssAsm.empty()){
-        bssAsm=L"section .bss\n"+bssAsm+L"\n";
         initAsmLabel=&labelsAsm[NULL];
         currentAsmLabel=initAsmLabel;
         currentAsmLabel->label=L"init";
@@ -1236,26 +1374,114 @@ std::wstring Compiler::getAssemblyFile(){
         PackageScope::AIN_PACKAGE->accept(this);
     }
 
-    auto asmFile=dataAsm+L"\n"+bssAsm+textAsm;
+    // The other labels are complete, each function compiled from the IR only writes to its label
+    parallelFor(irCompilers.size(), [&](std::size_t i){
+        irCompilers[i]->compile();
+    });
 
-    for(auto labelAsmIt:labelsAsm){
+    if(initAsmLabel)
+        startAsmLabel->instructions.insert(
+            startAsmLabel->instructions.begin(),
+            initAsmLabel->instructions.begin(),
+            initAsmLabel->instructions.end()
+        );
 
-        if(initAsmLabel&&labelAsmIt.second.label==initAsmLabel->label)
-            continue;
+    std::unordered_map<std::wstring, Assembler::AsmLabel*> labelsByName;
+    for(auto& labelAsmIt:labelsAsm){
+        if(&labelAsmIt.second!=initAsmLabel)
+            labelsByName[labelAsmIt.second.label]=&labelAsmIt.second;
+    }
+    for(auto& labelAsmIt:stackArgsLabelsAsm){
+        labelsByName[labelAsmIt.second.label]=&labelAsmIt.second;
+    }
 
-        if(initAsmLabel&&labelAsmIt.second.label==startAsmLabel->label){
-            startAsmLabel->instructions.insert(
-                startAsmLabel->instructions.begin(),
-                initAsmLabel->instructions.begin(),
-                initAsmLabel->instructions.end()
-            );
-            asmFile+=L"\n\n"+startAsmLabel->getAsmText();
+    // The labels are ordered by walking the calls from the start, callers before callees,
+    // so the output doesn't depend on the addresses of the scopes that key the maps
+    std::unordered_set<std::wstring> visitedLabels;
+    std::vector<Assembler::AsmLabel*> labelsToVisit;
+    if(startAsmLabel)
+        labelsToVisit.push_back(startAsmLabel);
+
+    while(!labelsToVisit.empty()){
+        auto label=labelsToVisit.back();
+        labelsToVisit.pop_back();
+
+        if(!visitedLabels.insert(label->label).second)
             continue;
+
+        finalLabels.push_back(*label);
+
+        // Pushed in reverse to visit the callees in the order of their calls
+        for(auto instructionIt=label->instructions.rbegin();instructionIt!=label->instructions.rend();instructionIt++){
+            for(auto operandIt=instructionIt->operands.rbegin();operandIt!=instructionIt->operands.rend();operandIt++){
+                if(operandIt->type!=Assembler::AsmOperand::LABEL)
+                    continue;
+                auto calleeIt=labelsByName.find(operandIt->value);
+                if(calleeIt!=labelsByName.end()&&visitedLabels.find(operandIt->value)==visitedLabels.end())
+                    labelsToVisit.push_back(calleeIt->second);
+            }
         }
+    }
 
-        asmFile+=L"\n\n"+labelAsmIt.second.getAsmText();
+    // The labels that are only used in the inline asm
+    std::vector<std::wstring> remainingLabels;
+    for(auto& labelIt:labelsByName){
+        if(visitedLabels.find(labelIt.first)==visitedLabels.end())
+            remainingLabels.push_back(labelIt.first);
+    }
+    std::sort(remainingLabels.begin(), remainingLabels.end());
+    for(auto& label:remainingLabels){
+        finalLabels.push_back(*labelsByName[label]);
     }
-    return asmFile;
+
+    // The labels don't depend on each other after the codegen
+    parallelFor(finalLabels.size(), [&](std::size_t i){
+        Peephole::optimize(&finalLabels[i]);
+    });
+
+    return finalLabels;
+}
+
+void Compiler::writeAssemblyFile(std::ostream& out){
+
+    auto& labels=getFinalLabels();
+
+    if(!rodataAsm.empty()){
+        out<<"section .rodata\n";
+        for(auto& rodata:rodataAsm){
+            rodata.writeAsmText(out);
+            out<<'\n';
+        }
+        out<<'\n';
+    }
+
+    out<<"section .data\n";
+    for(auto& data:dataAsm){
+        data.writeAsmText(out);
+        out<<'\n';
+    }
+    out<<'\n';
+
+    if(!bssAsm.empty()){
+        out<<"section .bss\n";
+        for(auto& bss:bssAsm){
+            bss.writeAsmText(out);
+            out<<'\n';
+        }
+        out<<'\n';
+    }
+
+    out<<textAsm;
+
+    for(auto& label:labels){
+        out<<"\n\n";
+        label.writeAsmText(out);
+    }
+}
+
+std::string Compiler::getExecutableFile(){
+    auto image=Encoder(&getFinalLabels(), &rodataAsm, &dataAsm, &bssAsm).encode();
+    return Elf::getExecutable(image);
 }
 
 int Compiler::getVariableSize(Variable* var){
@@ -1378,8 +1604,10 @@ void Compiler::visitLoopStm(WhileStatement *stm, bool isDoWhileStm){
     auto continueLabel=Assembler::localLabel(continueLabelStr);
     auto breakLabel=Assembler::localLabel(breakLabelStr);
 
-    if(!isDoWhileStm)
+    if(!isDoWhileStm){
+        LoopVectorizer(this, stm, currentLoopLabelsSize).vectorize();
         *currentAsmLabel+=Assembler::jmp(Assembler::label(L"."+continueLabelStr));
+    }
 
     *currentAsmLabel+=loopLabel;
 
@@ -1456,6 +1684,8 @@ void Compiler::invokeBuiltInOpFun(OperatorFunInvokeExpression* ex){
     auto isUnsigned=
         *inside->getReturnType()==*Type::UBYTE
         ||
+        *inside->getReturnType()==*Type::USHORT
+        ||
         *inside->getReturnType()==*Type::UINT
         ||
         *inside->getReturnType()==*Type::ULONG
@@ -1777,7 +2007,7 @@ void Compiler::addInstructionToConvertBetweenDataTypes(int fromSize, int toSize,
 std::wstring Compiler::addAinAllocAsm(){
 
     if(AIN_ALLOC)
-        return labelsAsm[AIN_ALLOC].label;
+        return getStackArgsLabel(AIN_ALLOC);
 
     auto decl=FunDecl(
         std::make_shared<std::wstring>(L"احجز"),
@@ -1802,18 +2032,18 @@ std::wstring Compiler::addAinAllocAsm(){
         throw AinException(L"لم يتم العثور على الملف ainmem.ain في النظام.");
 
     if(labelsAsm.find(AIN_ALLOC)!=labelsAsm.end())
-        return labelsAsm[AIN_ALLOC].label;
+        return getStackArgsLabel(AIN_ALLOC);
 
     AIN_ALLOC->accept(this);
 
 
-    return labelsAsm[AIN_ALLOC].label;
+    return getStackArgsLabel(AIN_ALLOC);
 }
 
 std::wstring Compiler::addAinReAllocAsm(){
 
     if(AIN_REALLOC)
-        return labelsAsm[AIN_REALLOC].label;
+        return getStackArgsLabel(AIN_REALLOC);
 
     auto decl=FunDecl(
         std::make_shared<std::wstring>(L"إعادة_حجز"),
@@ -1842,116 +2072,216 @@ std::wstring Compiler::addAinReAllocAsm(){
         throw AinException(L"لم يتم العثور على الملف ainmem.ain في النظام.");
 
     if(labelsAsm.find(AIN_REALLOC)!=labelsAsm.end())
-        return labelsAsm[AIN_REALLOC].label;
+        return getStackArgsLabel(AIN_REALLOC);
 
     AIN_REALLOC->accept(this);
     
-    return labelsAsm[AIN_REALLOC].label;
+    return getStackArgsLabel(AIN_REALLOC);
 }
 
-std::wstring Compiler::addAinMemcpyAsm(){
+std::wstring Compiler::addAinAllocateArrayAsm(){
 
-    if(AIN_MEMCPY)
-        return labelsAsm[AIN_MEMCPY].label;
+    if(AIN_ALLOCATE_ARRAY)
+        return getStackArgsLabel(AIN_ALLOCATE_ARRAY);
 
     auto decl=FunDecl(
-        std::make_shared<std::wstring>(L"انسخ"),
+        std::make_shared<std::wstring>(L"احجز_مصفوفة"),
         Type::LONG,
         std::make_shared<bool>(false),
         std::make_shared<std::vector<SharedFunParam>>(
             std::vector{
                 std::make_shared<FunParam>(
-                    std::make_shared<std::wstring>(L"من"),
-                    Type::LONG
-                ),
-                std::make_shared<FunParam>(
-                    std::make_shared<std::wstring>(L"إلى"),
-                    Type::LONG
+                    std::make_shared<std::wstring>(L"الأبعاد"),
+                    std::make_shared<Type>(Type::Array(Type::LONG))
                 ),
                 std::make_shared<FunParam>(
-                    std::make_shared<std::wstring>(L"العدد"),
+                    std::make_shared<std::wstring>(L"حجم_العنصر"),
                     Type::LONG
                 )
             }
         )
     );
 
-    AIN_MEMCPY=PackageScope::AIN_PACKAGE
+    AIN_ALLOCATE_ARRAY=PackageScope::AIN_PACKAGE
         ->findFileByPath(toWstring(std::string(std::getenv("AIN_STD"))+BuiltInFilePaths::AIN_MEM))
-        ->findPublicFunction(decl.toString())
+        ->findPrivateFunction(decl.toString())
         .get();
 
-    if(!AIN_MEMCPY)
+    if(!AIN_ALLOCATE_ARRAY)
         throw AinException(L"لم يتم العثور على الملف ainmem.ain في النظام.");
 
-    if(labelsAsm.find(AIN_MEMCPY)!=labelsAsm.end())
-        return labelsAsm[AIN_MEMCPY].label;
+    if(labelsAsm.find(AIN_ALLOCATE_ARRAY)!=labelsAsm.end())
+        return getStackArgsLabel(AIN_ALLOCATE_ARRAY);
 
-    AIN_MEMCPY->accept(this);
+    AIN_ALLOCATE_ARRAY->accept(this);
 
-    return labelsAsm[AIN_MEMCPY].label;
+    return getStackArgsLabel(AIN_ALLOCATE_ARRAY);
 }
 
-std::wstring Compiler::addAinAllocateArrayAsm(){
+std::wstring Compiler::addAinWriteAsm(bool isLine){
 
-    if(AIN_ALLOCATE_ARRAY)
-        return labelsAsm[AIN_ALLOCATE_ARRAY].label;
+    auto& fun=(isLine)?AIN_WRITE_LINE:AIN_WRITE;
+
+    if(fun)
+        return getStackArgsLabel(fun);
 
     auto decl=FunDecl(
-        std::make_shared<std::wstring>(L"احجز_مصفوفة"),
-        Type::LONG,
+        std::make_shared<std::wstring>((isLine)?L"اكتب_سطرا_للإخراج":L"اكتب_للإخراج"),
+        Type::VOID,
         std::make_shared<bool>(false),
         std::make_shared<std::vector<SharedFunParam>>(
             std::vector{
                 std::make_shared<FunParam>(
-                    std::make_shared<std::wstring>(L"الأبعاد"),
-                    std::make_shared<Type>(Type::Array(Type::LONG))
+                    std::make_shared<std::wstring>(L"العنوان"),
+                    Type::LONG
                 ),
                 std::make_shared<FunParam>(
-                    std::make_shared<std::wstring>(L"حجم_العنصر"),
+                    std::make_shared<std::wstring>(L"الحجم"),
                     Type::LONG
                 )
             }
         )
     );
 
-    AIN_ALLOCATE_ARRAY=PackageScope::AIN_PACKAGE
-        ->findFileByPath(toWstring(std::string(std::getenv("AIN_STD"))+BuiltInFilePaths::AIN_MEM))
-        ->findPrivateFunction(decl.toString())
+    fun=PackageScope::AIN_PACKAGE
+        ->findFileByPath(toWstring(std::string(std::getenv("AIN_STD"))+BuiltInFilePaths::AIN_IO))
+        ->findPublicFunction(decl.toString())
         .get();
 
-    if(!AIN_ALLOCATE_ARRAY)
-        throw AinException(L"لم يتم العثور على الملف ainmem.ain في النظام.");
+    if(!fun)
+        throw AinException(L"لم يتم العثور على الملف ainio.ain في النظام.");
 
-    if(labelsAsm.find(AIN_ALLOCATE_ARRAY)!=labelsAsm.end())
-        return labelsAsm[AIN_ALLOCATE_ARRAY].label;
+    if(labelsAsm.find(fun)!=labelsAsm.end())
+        return getStackArgsLabel(fun);
 
-    AIN_ALLOCATE_ARRAY->accept(this);
+    fun->accept(this);
+
+    return getStackArgsLabel(fun);
+}
+
+std::wstring Compiler::addAinExitAsm(){
+
+    if(AIN_EXIT)
+        return getStackArgsLabel(AIN_EXIT);
+
+    auto decl=FunDecl(
+        std::make_shared<std::wstring>(L"أنه_البرنامج"),
+        Type::VOID,
+        std::make_shared<bool>(false),
+        std::make_shared<std::vector<SharedFunParam>>(
+            std::vector{
+                std::make_shared<FunParam>(
+                    std::make_shared<std::wstring>(L"الرمز"),
+                    Type::LONG
+                )
+            }
+        )
+    );
+
+    AIN_EXIT=PackageScope::AIN_PACKAGE
+        ->findFileByPath(toWstring(std::string(std::getenv("AIN_STD"))+BuiltInFilePaths::AIN_IO))
+        ->findPublicFunction(decl.toString())
+        .get();
+
+    if(!AIN_EXIT)
+        throw AinException(L"لم يتم العثور على الملف ainio.ain في النظام.");
+
+    if(labelsAsm.find(AIN_EXIT)==labelsAsm.end())
+        AIN_EXIT->accept(this);
+
+    return getStackArgsLabel(AIN_EXIT);
+}
+
+std::vector<Assembler::AsmInstruction> Compiler::exitAsm(int errorCode, std::wstring comment){
+    auto exitLabel=addAinExitAsm();
+    return {
+        Assembler::push(Assembler::imm(std::to_wstring(errorCode)), L"مُعامل الرمز"),
+        Assembler::call(Assembler::label(exitLabel), comment)
+    };
+}
+
+std::wstring Compiler::addAinReadAsm(bool isLine){
+
+    auto& fun=(isLine)?AIN_READ_LINE:AIN_READ;
+
+    if(fun)
+        return labelsAsm[fun].label;
+
+    auto decl=FunDecl(
+        std::make_shared<std::wstring>((isLine)?L"أدخل_سطرا":L"أدخل_كلمة"),
+        Type::LONG,
+        std::make_shared<bool>(false),
+        std::make_shared<std::vector<SharedFunParam>>()
+    );
+
+    fun=PackageScope::AIN_PACKAGE
+        ->findFileByPath(toWstring(std::string(std::getenv("AIN_STD"))+BuiltInFilePaths::AIN_IN))
+        ->findPublicFunction(decl.toString())
+        .get();
+
+    if(!fun)
+        throw AinException(L"لم يتم العثور على الملف ainin.ain في النظام.");
+
+    if(labelsAsm.find(fun)==labelsAsm.end())
+        fun->accept(this);
 
-    return labelsAsm[AIN_ALLOCATE_ARRAY].label;
+    return labelsAsm[fun].label;
 }
 
 void Compiler::callFunAsm(FunScope* fun, SharedVector<SharedIExpression> args, bool insideCall){
 
-    auto params=fun->getParamsFromLocals();
     auto paramsDecl=fun->getDecl()->params;
-    auto argsSize=getVariablesSize(params);
+    auto argsSize=getStackParamsSize(fun);
+    auto registerArgsSize=(CompilerVarsOffsetSetter::hasRegisterParams(fun))
+        ?std::min(args->size(), CompilerVarsOffsetSetter::PARAMS_REGISTERS.size())
+        :0
+    ;
+
+    /*
+     * The args that may change the registers are evaluated first to the stack, after the args passed on the stack.
+     * Then they're moved to their registers, and the literals and the locals are evaluated directly to them
+    */
+    std::vector<int> evaluatedRegisterArgs;
+    for(auto i=0;i<registerArgsSize;i++){
+        if(!isRegisterSafeArg((*args)[i].get()))
+            evaluatedRegisterArgs.push_back(i);
+    }
+    auto reservedSize=argsSize+evaluatedRegisterArgs.size()*8;
 
     if(insideCall){
         *currentAsmLabel+=Assembler::push(Assembler::RBX()); // The old address
         *currentAsmLabel+=Assembler::push(Assembler::RAX()); // inside ex address
     }
 
-    *currentAsmLabel+=Assembler::reserveSpaceOnStack(argsSize); // for args
+    *currentAsmLabel+=Assembler::reserveSpaceOnStack(reservedSize); // for args
 
     auto offset=argsSize;
+    auto evaluatedOffset=argsSize;
 
     for(auto i=0;i<args->size();i++){
         auto argEx=(*args)[i];
+        auto isRegisterArg=i<registerArgsSize;
+
+        if(isRegisterArg&&isRegisterSafeArg(argEx.get()))
+            continue;
+
         argEx->accept(this);
+        auto comment=L"مُعامِل "+*(*paramsDecl)[i]->name;
+
+        if(isRegisterArg){
+            *currentAsmLabel+=
+                Assembler::mov(
+                    Assembler::addressMov(Assembler::RSP(), evaluatedOffset),
+                    Assembler::RAX(),
+                    Assembler::AsmInstruction::IMPLICIT,
+                    comment
+                );
+            evaluatedOffset+=8;
+            continue;
+        }
+
         auto argSize=Type::getSize(argEx->getReturnType().get());
         offset-=argSize;
-        auto comment=L"مُعامِل "+*(*paramsDecl)[i]->name;
         *currentAsmLabel+=
             Assembler::mov(
                 Assembler::addressMov(Assembler::RSP(), offset),
@@ -1961,6 +2291,29 @@ void Compiler::callFunAsm(FunScope* fun, SharedVector<SharedIExpression> args, b
             );
     }
 
+    for(auto i=0;i<evaluatedRegisterArgs.size();i++){
+        auto argIndex=evaluatedRegisterArgs[i];
+        *currentAsmLabel+=
+            Assembler::mov(
+                CompilerVarsOffsetSetter::PARAMS_REGISTERS[argIndex](Assembler::AsmInstruction::QWORD),
+                Assembler::addressMov(Assembler::RSP(), argsSize+i*8)
+            );
+    }
+
+    for(auto i=0;i<registerArgsSize;i++){
+        auto argEx=(*args)[i];
+        if(!isRegisterSafeArg(argEx.get()))
+            continue;
+        argEx->accept(this);
+        *currentAsmLabel+=
+            Assembler::mov(
+                CompilerVarsOffsetSetter::PARAMS_REGISTERS[i](Assembler::AsmInstruction::QWORD),
+                Assembler::RAX(),
+                Assembler::AsmInstruction::IMPLICIT,
+                L"مُعامِل "+*(*paramsDecl)[i]->name
+            );
+    }
+
     if (labelsAsm.find(fun)==labelsAsm.end())
         fun->accept(this);
 
@@ -1978,7 +2331,7 @@ void Compiler::callFunAsm(FunScope* fun, SharedVector<SharedIExpression> args, b
     if(insideCall)
         *currentAsmLabel+=Assembler::mov(
             Assembler::RBX(),
-            Assembler::addressMov(Assembler::RSP(),argsSize)
+            Assembler::addressMov(Assembler::RSP(),reservedSize)
         );
     
     *currentAsmLabel+=Assembler::call(
@@ -1987,9 +2340,9 @@ void Compiler::callFunAsm(FunScope* fun, SharedVector<SharedIExpression> args, b
     );
 
     if(insideCall)
-        argsSize+=8; // remove more 8 byte for the size of inside ex address
+        reservedSize+=8; // remove more 8 byte for the size of inside ex address
     
-    *currentAsmLabel+=Assembler::removeReservedSpaceFromStack(argsSize);
+    *currentAsmLabel+=Assembler::removeReservedSpaceFromStack(reservedSize);
 
     if(insideCall)
         *currentAsmLabel+=Assembler::pop(Assembler::RBX()); // The old address
@@ -1997,6 +2350,61 @@ void Compiler::callFunAsm(FunScope* fun, SharedVector<SharedIExpression> args, b
     // The returned address is on RAX
 }
 
+bool Compiler::isRegisterSafeArg(IExpression* ex){
+    if(auto literalEx=dynamic_cast<LiteralExpression*>(ex))
+        return !std::dynamic_pointer_cast<StringValue>(literalEx->getValue());
+
+    // The locals can't be changed by evaluating the other args
+    if(auto varEx=dynamic_cast<VarAccessExpression*>(ex))
+        return offsets[varEx->getVar().get()].reg.value==Assembler::RBP().value;
+
+    return false;
+}
+
+int Compiler::getStackParamsSize(FunScope* fun){
+    auto params=fun->getDecl()->params;
+    auto firstStackParam=(CompilerVarsOffsetSetter::hasRegisterParams(fun))
+        ?CompilerVarsOffsetSetter::PARAMS_REGISTERS.size()
+        :0
+    ;
+
+    auto size=0;
+    for(int i=firstStackParam;i<params->size();i++)
+        size+=Type::getSize((*params)[i]->type.get());
+    return size;
+}
+
+std::wstring Compiler::getStackArgsLabel(FunScope* fun){
+    auto params=fun->getDecl()->params;
+
+    if(!CompilerVarsOffsetSetter::hasRegisterParams(fun)||params->empty())
+        return labelsAsm[fun].label;
+
+    auto &labelAsm=stackArgsLabelsAsm[fun];
+    if(!labelAsm.label.empty())
+        return labelAsm.label;
+
+    labelAsm.label=labelsAsm[fun].label+L"_stack_args";
+    labelAsm.comment=labelsAsm[fun].comment+L" بمُعامِلات في الstack";
+
+    // The args are above the return address in the same order of the stack convention
+    auto offset=8+getVariablesSize(fun->getParamsFromLocals());
+    for(int i=0;i<params->size()&&i<CompilerVarsOffsetSetter::PARAMS_REGISTERS.size();i++){
+        auto param=(*params)[i];
+        auto paramSize=Type::getSize(param->type.get());
+        offset-=paramSize;
+        labelAsm+=Assembler::mov(
+            CompilerVarsOffsetSetter::PARAMS_REGISTERS[i](paramSize),
+            Assembler::addressMov(Assembler::RSP(), offset),
+            Assembler::AsmInstruction::IMPLICIT,
+            L"مُعامِل "+*param->name
+        );
+    }
+    labelAsm+=Assembler::jmp(Assembler::label(labelsAsm[fun].label));
+
+    return labelAsm.label;
+}
+
 void Compiler::invokeNonStaticFun(NonStaticFunInvokeExpression* ex){
     ex->getInside()->accept(this);
     callFunAsm(
@@ -2316,7 +2724,7 @@ void Compiler::compileBuiltInSetWithNonBuiltInAugOp(
                 funOfOp->accept(this);
 
             *currentAsmLabel+=Assembler::call(
-                Assembler::label(labelsAsm[funOfOp].label),
+                Assembler::label(getStackArgsLabel(funOfOp)),
                 L"استدعاء دالة "+funOfOp->getParentScope()->getName()+L"::"+funOfOp->getDecl()->toString()
             );
             if(valueSize!=8)
@@ -1,13 +1,48 @@
 #include "CompilerVarsOffsetSetter.hpp"
 #include "Assembler.hpp"
+#include "BuiltInFunScope.hpp"
 #include "ClassScope.hpp"
+#include "ExpressionStatement.hpp"
+#include "FunInvokeExpression.hpp"
 #include "LoopScope.hpp"
 #include "FunDecl.hpp"
 #include "FunParam.hpp"
 #include "Type.hpp"
 #include "Variable.hpp"
+#include <algorithm>
 #include <string>
 
+const std::vector<CompilerVarsOffsetSetter::Register> CompilerVarsOffsetSetter::PARAMS_REGISTERS={
+    Assembler::RDI, Assembler::RSI, Assembler::RDX, Assembler::RCX, Assembler::R8, Assembler::R9,
+};
+
+bool CompilerVarsOffsetSetter::hasRegisterParams(FunScope* scope){
+    if(dynamic_cast<BuiltInFunScope*>(scope))
+        return false;
+    return !hasInlineAsm(scope);
+}
+
+bool CompilerVarsOffsetSetter::hasInlineAsm(StmListScope* scope){
+    for(auto stm:*scope->getStmList()){
+        if(auto exStm=std::dynamic_pointer_cast<ExpressionStatement>(stm)){
+            auto invokeEx=std::dynamic_pointer_cast<FunInvokeExpression>(exStm->getEx());
+            if(invokeEx&&invokeEx->getFun()==BuiltInFunScope::INLINE_ASM)
+                return true;
+        }
+        else if(auto ifStm=std::dynamic_pointer_cast<IfStatement>(stm)){
+            if(hasInlineAsm(ifStm->getIfScope().get()))
+                return true;
+            if(auto elseScope=ifStm->getElseScope();elseScope&&hasInlineAsm(elseScope.get()))
+                return true;
+        }
+        else if(auto loopStm=std::dynamic_pointer_cast<WhileStatement>(stm)){
+            if(hasInlineAsm(loopStm->getLoopScope().get()))
+                return true;
+        }
+    }
+    return false;
+}
+
 CompilerVarsOffsetSetter::Offset::Offset(Assembler::AsmOperand reg, int value):
     reg(reg),
     value(value)
@@ -133,9 +168,11 @@ void CompilerVarsOffsetSetter::visit(FunScope* scope){
 
     auto nonParams=scope->getNonParamsFromLocals();
 
+    auto registerParamsSize=(hasRegisterParams(scope))?std::min(paramsVec->size(), PARAMS_REGISTERS.size()):0;
+
     stmListScopeOffset=16; // for first offset before 8-byte RBP register and return address, TODO: need to handle if the system is 32-bit
 
-    for(auto paramIt=paramsVec->rbegin();paramIt!=paramsVec->rend();paramIt++){
+    for(auto paramIt=paramsVec->rbegin();paramIt!=paramsVec->rend()-registerParamsSize;paramIt++){
 
         auto name=*paramIt->get()->name;
         auto var=(*locals)[name].get();
@@ -150,6 +187,20 @@ void CompilerVarsOffsetSetter::visit(FunScope* scope){
 
     stmListScopeOffset=0; // for first offset after 8-byte RSP register, the offset will be decreased by the variable size
 
+    // The params passed in registers are saved first in the frame
+    for(auto paramIt=paramsVec->begin();paramIt!=paramsVec->begin()+registerParamsSize;paramIt++){
+
+        auto name=*paramIt->get()->name;
+        auto var=(*locals)[name].get();
+
+        stmListScopeOffset-=Type::getSize(var->getType().get());
+
+        (*offsets)[var]=Offset(
+            Assembler::RBP(),
+            stmListScopeOffset
+        );
+    }
+
     for(auto varIt:*nonParams){
 
         auto var=varIt.second.get();
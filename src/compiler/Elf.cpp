@@ -0,0 +1,112 @@
+#include "Elf.hpp"
+
+namespace Elf {
+
+    namespace {
+
+        const int HEADER_SIZE=64;
+        const int PROGRAM_HEADER_SIZE=56;
+
+        const uint32_t PT_LOAD=1;
+        const uint32_t PT_GNU_STACK=0x6474e551;
+
+        const uint32_t PF_X=1;
+        const uint32_t PF_W=2;
+        const uint32_t PF_R=4;
+
+        uint64_t alignToPage(uint64_t value){
+            return (value+PAGE_SIZE-1)&~(PAGE_SIZE-1);
+        }
+
+        void write(std::string& file, uint64_t value, int size){
+            for(auto i=0;i<size;i++)
+                file+=(char)((value>>(8*i))&0xFF);
+        }
+
+        void writeProgramHeader(
+            std::string& file,
+            uint32_t type,
+            uint32_t flags,
+            uint64_t offset,
+            uint64_t address,
+            uint64_t fileSize,
+            uint64_t memorySize
+        ){
+            write(file, type, 4);
+            write(file, flags, 4);
+            write(file, offset, 8);
+            write(file, address, 8); // virtual address
+            write(file, address, 8); // physical address
+            write(file, fileSize, 8);
+            write(file, memorySize, 8);
+            write(file, (type==PT_LOAD)?PAGE_SIZE:16, 8); // alignment
+        }
+
+    }
+
+    uint64_t getRodataAddress(uint64_t textSize){
+        return alignToPage(TEXT_ADDRESS+textSize);
+    }
+
+    uint64_t getDataAddress(uint64_t textSize, uint64_t rodataSize){
+        return alignToPage(getRodataAddress(textSize)+rodataSize);
+    }
+
+    std::string getExecutable(Image& image){
+        auto textOffset=TEXT_ADDRESS-BASE_ADDRESS;
+        auto rodataAddress=getRodataAddress(image.text.size());
+        auto rodataOffset=rodataAddress-BASE_ADDRESS;
+        auto dataAddress=getDataAddress(image.text.size(), image.rodata.size());
+        auto dataOffset=dataAddress-BASE_ADDRESS;
+        auto hasRodata=!image.rodata.empty();
+
+        std::string file;
+
+        // The identification: magic, 64 bits, little endian, current version and System V ABI
+        file+="\x7F""ELF";
+        write(file, 2, 1);
+        write(file, 1, 1);
+        write(file, 1, 1);
+        write(file, 0, 1);
+        write(file, 0, 8);
+
+        write(file, 2, 2); // executable
+        write(file, 0x3E, 2); // x86-64
+        write(file, 1, 4); // version
+        write(file, image.entry, 8);
+        write(file, HEADER_SIZE, 8); // the offset of the program headers
+        write(file, 0, 8); // no section headers
+        write(file, 0, 4); // flags
+        write(file, HEADER_SIZE, 2);
+        write(file, PROGRAM_HEADER_SIZE, 2);
+        write(file, hasRodata?4:3, 2); // the count of the program headers
+        write(file, 0, 2);
+        write(file, 0, 2);
+        write(file, 0, 2);
+
+        writeProgramHeader(file, PT_LOAD, PF_R|PF_X, textOffset, TEXT_ADDRESS, image.text.size(), image.text.size());
+        if(hasRodata)
+            writeProgramHeader(file, PT_LOAD, PF_R, rodataOffset, rodataAddress, image.rodata.size(), image.rodata.size());
+        writeProgramHeader(
+            file,
+            PT_LOAD,
+            PF_R|PF_W,
+            dataOffset,
+            dataAddress,
+            image.data.size(),
+            image.data.size()+image.bssSize
+        );
+        // The stack isn't executable
+        writeProgramHeader(file, PT_GNU_STACK, PF_R|PF_W, 0, 0, 0, 0);
+
+        file.resize(textOffset, 0);
+        file.append(image.text.begin(), image.text.end());
+        file.resize(rodataOffset, 0);
+        file.append(image.rodata.begin(), image.rodata.end());
+        file.resize(dataOffset, 0);
+        file.append(image.data.begin(), image.data.end());
+
+        return file;
+    }
+
+}
@@ -0,0 +1,1669 @@
+#include "Encoder.hpp"
+#include "AinException.hpp"
+#include "parallel_helper.hpp"
+#include "string_helper.hpp"
+#include <algorithm>
+#include <cwctype>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+    using Assembler::AsmInstruction;
+    using Assembler::AsmOperand;
+
+    struct Register{
+        int number;
+        int size; // 16 for XMM registers and 32 for YMM registers
+        bool isHighByte=false; // AH, CH, DH and BH can't be encoded with REX
+        bool needsRex=false; // SPL, BPL, SIL and DIL can be encoded only with REX
+    };
+
+    const std::unordered_map<std::wstring, Register>& getRegisters(){
+        static const auto registers=[]{
+            std::unordered_map<std::wstring, Register> registers;
+            const wchar_t* names[][4]={
+                {L"AL", L"AX", L"EAX", L"RAX"},
+                {L"CL", L"CX", L"ECX", L"RCX"},
+                {L"DL", L"DX", L"EDX", L"RDX"},
+                {L"BL", L"BX", L"EBX", L"RBX"},
+                {L"SPL", L"SP", L"ESP", L"RSP"},
+                {L"BPL", L"BP", L"EBP", L"RBP"},
+                {L"SIL", L"SI", L"ESI", L"RSI"},
+                {L"DIL", L"DI", L"EDI", L"RDI"},
+            };
+            for(auto number=0;number<8;number++){
+                registers[names[number][0]]=Register{number, 1, false, number>=4};
+                registers[names[number][1]]=Register{number, 2};
+                registers[names[number][2]]=Register{number, 4};
+                registers[names[number][3]]=Register{number, 8};
+            }
+            for(auto number=8;number<16;number++){
+                auto name=L"R"+std::to_wstring(number);
+                registers[name+L"B"]=Register{number, 1};
+                registers[name+L"W"]=Register{number, 2};
+                registers[name+L"D"]=Register{number, 4};
+                registers[name]=Register{number, 8};
+            }
+            const wchar_t* highBytes[]={L"AH", L"CH", L"DH", L"BH"};
+            for(auto i=0;i<4;i++)
+                registers[highBytes[i]]=Register{4+i, 1, true};
+            for(auto number=0;number<16;number++){
+                registers[L"XMM"+std::to_wstring(number)]=Register{number, 16};
+                registers[L"YMM"+std::to_wstring(number)]=Register{number, 32};
+            }
+            return registers;
+        }();
+        return registers;
+    }
+
+    const std::unordered_map<std::wstring, AsmInstruction::InstructionType>& getInstructionTypes(){
+        static const auto types=[]{
+            std::unordered_map<std::wstring, AsmInstruction::InstructionType> types;
+            for(int type=AsmInstruction::NOP;type<=AsmInstruction::PMOVMSKB;type++){
+                auto instruction=AsmInstruction{.type=(AsmInstruction::InstructionType)type};
+                types[toWstring(instruction.getName())]=instruction.type;
+            }
+            // The other names of the same conditions
+            types[L"je"]=AsmInstruction::JZ;
+            types[L"jne"]=AsmInstruction::JNZ;
+            types[L"jnge"]=AsmInstruction::JL;
+            types[L"jnl"]=AsmInstruction::JGE;
+            types[L"jng"]=AsmInstruction::JLE;
+            types[L"jnle"]=AsmInstruction::JG;
+            types[L"jc"]=AsmInstruction::JB;
+            types[L"jnae"]=AsmInstruction::JB;
+            types[L"jnc"]=AsmInstruction::JAE;
+            types[L"jnb"]=AsmInstruction::JAE;
+            types[L"jna"]=AsmInstruction::JBE;
+            types[L"jnbe"]=AsmInstruction::JA;
+            types[L"sete"]=AsmInstruction::SETZ;
+            types[L"setne"]=AsmInstruction::SETNZ;
+            types[L"setnge"]=AsmInstruction::SETL;
+            types[L"setnl"]=AsmInstruction::SETGE;
+            types[L"setng"]=AsmInstruction::SETLE;
+            types[L"setnle"]=AsmInstruction::SETG;
+            types[L"setc"]=AsmInstruction::SETB;
+            types[L"setnae"]=AsmInstruction::SETB;
+            types[L"setnc"]=AsmInstruction::SETAE;
+            types[L"setnb"]=AsmInstruction::SETAE;
+            types[L"setna"]=AsmInstruction::SETBE;
+            types[L"setnbe"]=AsmInstruction::SETA;
+            types[L"cmove"]=AsmInstruction::CMOVZ;
+            types[L"cmovne"]=AsmInstruction::CMOVNZ;
+            types[L"cmovnle"]=AsmInstruction::CMOVG;
+            return types;
+        }();
+        return types;
+    }
+
+    std::wstring trim(std::wstring text){
+        auto start=text.find_first_not_of(L" \t\r");
+        if(start==std::wstring::npos)
+            return L"";
+        auto end=text.find_last_not_of(L" \t\r");
+        return text.substr(start, end-start+1);
+    }
+
+    std::wstring toUpper(std::wstring text){
+        std::transform(text.begin(), text.end(), text.begin(), ::towupper);
+        return text;
+    }
+
+    std::wstring toLower(std::wstring text){
+        std::transform(text.begin(), text.end(), text.begin(), ::towlower);
+        return text;
+    }
+
+    const Register* findRegister(std::wstring name){
+        auto& registers=getRegisters();
+        auto regIt=registers.find(toUpper(trim(name)));
+        return (regIt!=registers.end())?&regIt->second:nullptr;
+    }
+
+    // Decimal, hex with 0x, or chars between quotes stored in little endian as in nasm
+    bool parseNumber(std::wstring text, int64_t& value){
+        text=trim(text);
+        if(text.empty())
+            return false;
+
+        if(text.front()==L'\''||text.front()==L'\"'){
+            if(text.size()<2||text.back()!=text.front())
+                return false;
+            // toCharPointer changes the locale, which isn't safe in the threads of the labels
+            std::ostringstream out;
+            writeUtf8(out, text.substr(1, text.size()-2));
+            auto bytes=out.str();
+            uint64_t result=0;
+            for(int i=std::min<int>(bytes.size(), 8)-1;i>=0;i--)
+                result=(result<<8)|(uint8_t)bytes[i];
+            value=result;
+            return true;
+        }
+
+        auto isNegative=text.front()==L'-';
+        if(isNegative||text.front()==L'+')
+            text=trim(text.substr(1));
+        if(text.empty())
+            return false;
+
+        uint64_t result=0;
+        if(text.size()>2&&text[0]==L'0'&&(text[1]==L'x'||text[1]==L'X')){
+            for(auto c:text.substr(2)){
+                if(!std::iswxdigit(c))
+                    return false;
+                result=result*16+(std::iswdigit(c)?c-L'0':std::towlower(c)-L'a'+10);
+            }
+        }
+        else{
+            for(auto c:text){
+                if(!std::iswdigit(c))
+                    return false;
+                result=result*10+(c-L'0');
+            }
+        }
+        value=(int64_t)(isNegative?~result+1:result);
+        return true;
+    }
+
+    bool fitsInt8(int64_t value){
+        return value>=-128&&value<=127;
+    }
+
+    bool fitsInt32(int64_t value){
+        return value>=INT32_MIN&&value<=INT32_MAX;
+    }
+
+    // The immediates of the operations smaller than 64 bits wrap around, so 0xFF is -1 in a byte
+    int64_t signExtend(int64_t value, int size){
+        if(size>=8||size<=0)
+            return value;
+        auto shift=64-8*size;
+        return (int64_t)((uint64_t)value<<shift)>>shift;
+    }
+
+    int getScaleBits(int scale){
+        switch(scale){
+            case 1: return 0;
+            case 2: return 1;
+            case 4: return 2;
+            default: return 3;
+        }
+    }
+
+    int getConditionCode(AsmInstruction::InstructionType type){
+        switch(type){
+            case AsmInstruction::JZ: case AsmInstruction::SETZ: case AsmInstruction::CMOVZ:
+                return 0x4;
+            case AsmInstruction::JNZ: case AsmInstruction::SETNZ: case AsmInstruction::CMOVNZ:
+                return 0x5;
+            case AsmInstruction::JS: case AsmInstruction::SETS: case AsmInstruction::CMOVS:
+                return 0x8;
+            case AsmInstruction::JNS: case AsmInstruction::SETNS:
+                return 0x9;
+            case AsmInstruction::JG: case AsmInstruction::SETG: case AsmInstruction::CMOVG:
+                return 0xF;
+            case AsmInstruction::JGE: case AsmInstruction::SETGE:
+                return 0xD;
+            case AsmInstruction::JL: case AsmInstruction::SETL:
+                return 0xC;
+            case AsmInstruction::JLE: case AsmInstruction::SETLE:
+                return 0xE;
+            case AsmInstruction::JA: case AsmInstruction::SETA:
+                return 0x7;
+            case AsmInstruction::JAE: case AsmInstruction::SETAE:
+                return 0x3;
+            case AsmInstruction::JB: case AsmInstruction::SETB:
+                return 0x2;
+            case AsmInstruction::JBE: case AsmInstruction::SETBE:
+                return 0x6;
+            default:
+                return -1;
+        }
+    }
+
+    // The extension in the reg field of ModRM for the operations with an immediate
+    int getArithmeticExtension(AsmInstruction::InstructionType type){
+        switch(type){
+            case AsmInstruction::ADD: return 0;
+            case AsmInstruction::OR: return 1;
+            case AsmInstruction::AND: return 4;
+            case AsmInstruction::SUB: return 5;
+            case AsmInstruction::XOR: return 6;
+            default: return 7; // CMP
+        }
+    }
+
+    int getUnaryExtension(AsmInstruction::InstructionType type){
+        switch(type){
+            case AsmInstruction::NOT: return 2;
+            case AsmInstruction::NEG: return 3;
+            case AsmInstruction::MUL: return 4;
+            case AsmInstruction::IMUL: return 5;
+            case AsmInstruction::DIV: return 6;
+            default: return 7; // IDIV
+        }
+    }
+
+    // The mandatory prefix and the opcode after 0F of the packed operations, they are the same in the SSE and the AVX forms
+    std::pair<uint8_t, uint8_t> getPackedOpcode(AsmInstruction::InstructionType type){
+        switch(type){
+            case AsmInstruction::PADDB: case AsmInstruction::VPADDB: return {0x66, 0xFC};
+            case AsmInstruction::PADDW: case AsmInstruction::VPADDW: return {0x66, 0xFD};
+            case AsmInstruction::PADDD: case AsmInstruction::VPADDD: return {0x66, 0xFE};
+            case AsmInstruction::PADDQ: case AsmInstruction::VPADDQ: return {0x66, 0xD4};
+            case AsmInstruction::PSUBB: case AsmInstruction::VPSUBB: return {0x66, 0xF8};
+            case AsmInstruction::PSUBW: case AsmInstruction::VPSUBW: return {0x66, 0xF9};
+            case AsmInstruction::PSUBD: case AsmInstruction::VPSUBD: return {0x66, 0xFA};
+            case AsmInstruction::PSUBQ: case AsmInstruction::VPSUBQ: return {0x66, 0xFB};
+            case AsmInstruction::PAND: case AsmInstruction::VPAND: return {0x66, 0xDB};
+            case AsmInstruction::POR: case AsmInstruction::VPOR: return {0x66, 0xEB};
+            case AsmInstruction::PXOR: case AsmInstruction::VPXOR: return {0x66, 0xEF};
+            case AsmInstruction::PCMPEQB: return {0x66, 0x74};
+            case AsmInstruction::ADDPS: case AsmInstruction::VADDPS: return {0, 0x58};
+            case AsmInstruction::SUBPS: case AsmInstruction::VSUBPS: return {0, 0x5C};
+            case AsmInstruction::MULPS: case AsmInstruction::VMULPS: return {0, 0x59};
+            case AsmInstruction::DIVPS: case AsmInstruction::VDIVPS: return {0, 0x5E};
+            case AsmInstruction::ADDPD: case AsmInstruction::VADDPD: return {0x66, 0x58};
+            case AsmInstruction::SUBPD: case AsmInstruction::VSUBPD: return {0x66, 0x5C};
+            case AsmInstruction::MULPD: case AsmInstruction::VMULPD: return {0x66, 0x59};
+            default: return {0x66, 0x5E}; // DIVPD
+        }
+    }
+
+    AinException getUnsupportedException(AsmInstruction instruction){
+        return AinException(L"لا يمكن ترميز التعليمة: "+instruction.getAsmText(false));
+    }
+
+}
+
+struct Encoder::Operand{
+    enum Kind{
+        REG,
+        MEM,
+        IMM
+    };
+
+    Kind kind;
+    Register reg{};
+    int base=-1;
+    int index=-1;
+    int scale=1;
+    int64_t value=0; // The displacement of MEM or the value of IMM
+    std::wstring symbol; // Its address is added to the value
+
+    bool isXmm(){
+        return kind==REG&&reg.size==16;
+    }
+
+    bool isYmm(){
+        return kind==REG&&reg.size==32;
+    }
+
+    bool isVector(){
+        return isXmm()||isYmm();
+    }
+
+    bool isGeneral(){
+        return kind==REG&&reg.size<16;
+    }
+};
+
+// The parts of one instruction in the order they are written
+class Encoder::InstructionBuilder{
+    public:
+        std::vector<uint8_t> prefixes;
+        uint8_t rex=0;
+        bool needsRex=false;
+        bool forbidsRex=false;
+        std::vector<uint8_t> opcode;
+        bool hasModRM=false;
+        uint8_t modRM=0;
+        bool hasSib=false;
+        uint8_t sib=0;
+        int dispSize=0;
+        int64_t disp=0;
+        std::wstring dispSymbol;
+        bool isRipRelative=false;
+        int immSize=0;
+        int64_t imm=0;
+        std::wstring immSymbol;
+        bool isImmRelative=false;
+        // The VEX prefix replaces the mandatory prefix, REX and the escape bytes of the opcode
+        bool hasVex=false;
+        uint8_t vexMap=1; // 1 for 0F, 2 for 0F38 and 3 for 0F3A
+        uint8_t vexPrefix=0; // The mandatory prefix it replaces
+        bool vexL=false; // 256 bits
+        int vexV=0; // The extra source register
+
+        void setVex(uint8_t map, uint8_t prefix, int size, int v=0){
+            hasVex=true;
+            vexMap=map;
+            vexPrefix=prefix;
+            vexL=size==32;
+            vexV=v;
+        }
+
+        void setSize(int size){
+            if(size==2)
+                prefixes.push_back(0x66);
+            else if(size==8)
+                rex|=0x8;
+        }
+
+        void useRegister(Register reg){
+            needsRex|=reg.needsRex;
+            forbidsRex|=reg.isHighByte;
+        }
+
+        void setReg(Register reg){
+            hasModRM=true;
+            modRM|=(reg.number&7)<<3;
+            if(reg.number&8)
+                rex|=0x4;
+            useRegister(reg);
+        }
+
+        void setReg(int extension){
+            hasModRM=true;
+            modRM|=extension<<3;
+        }
+
+        void setRM(Operand& operand){
+            hasModRM=true;
+
+            if(operand.kind==Operand::REG){
+                modRM|=0xC0|(operand.reg.number&7);
+                if(operand.reg.number&8)
+                    rex|=0x1;
+                useRegister(operand.reg);
+                return;
+            }
+
+            disp=operand.value;
+            dispSymbol=operand.symbol;
+
+            if(operand.base<0&&operand.index<0){
+                dispSize=4;
+                if(operand.symbol.empty()){
+                    // An absolute address
+                    modRM|=0x04;
+                    hasSib=true;
+                    sib=0x25;
+                    return;
+                }
+                modRM|=0x05;
+                isRipRelative=true;
+                return;
+            }
+
+            if(operand.base<0){
+                // Only an index, with a 32 bits displacement
+                modRM|=0x04;
+                hasSib=true;
+                sib=(getScaleBits(operand.scale)<<6)|((operand.index&7)<<3)|0x5;
+                if(operand.index&8)
+                    rex|=0x2;
+                dispSize=4;
+                return;
+            }
+
+            auto mod=2;
+            if(!operand.symbol.empty())
+                dispSize=4;
+            else if(operand.value==0&&(operand.base&7)!=5){
+                mod=0;
+                dispSize=0;
+            }
+            else if(fitsInt8(operand.value)){
+                mod=1;
+                dispSize=1;
+            }
+            else
+                dispSize=4;
+
+            modRM|=mod<<6;
+            if(operand.base&8)
+                rex|=0x1;
+
+            if(operand.index<0&&(operand.base&7)!=4){
+                modRM|=operand.base&7;
+                return;
+            }
+
+            // RSP and R12 as a base need SIB
+            modRM|=0x04;
+            hasSib=true;
+            sib=(getScaleBits(operand.scale)<<6)
+                |(((operand.index<0)?4:(operand.index&7))<<3)
+                |(operand.base&7)
+            ;
+            if(operand.index>=0&&(operand.index&8))
+                rex|=0x2;
+        }
+
+        void addToOpcode(Register reg){
+            opcode.back()+=reg.number&7;
+            if(reg.number&8)
+                rex|=0x1;
+            useRegister(reg);
+        }
+
+        void setImm(Operand& operand, int size, bool isRelative=false){
+            immSize=size;
+            imm=operand.value;
+            immSymbol=operand.symbol;
+            isImmRelative=isRelative;
+        }
+
+        Chunk getChunk(AsmInstruction& instruction){
+            if(forbidsRex&&(rex||needsRex))
+                throw getUnsupportedException(instruction);
+            if(dispSymbol.empty()&&dispSize==4&&!fitsInt32(disp))
+                throw getUnsupportedException(instruction);
+            if(immSymbol.empty()&&immSize>0&&immSize<8){
+                auto max=(immSize==4&&(rex&0x8))?(int64_t)INT32_MAX:(int64_t)((1ULL<<(8*immSize))-1);
+                if(imm<-(1LL<<(8*immSize-1))||imm>max)
+                    throw getUnsupportedException(instruction);
+            }
+
+            Chunk chunk;
+            auto& bytes=chunk.bytes;
+            bytes.insert(bytes.end(), prefixes.begin(), prefixes.end());
+            if(hasVex){
+                uint8_t pp=(vexPrefix==0x66)?1:(vexPrefix==0xF3)?2:(vexPrefix==0xF2)?3:0;
+                uint8_t last=(uint8_t)((~vexV&0xF)<<3)|(vexL?0x4:0)|pp;
+                // The short form has only R, so it's used when X, B and W aren't needed
+                if(!(rex&0xB)&&vexMap==1){
+                    bytes.push_back(0xC5);
+                    bytes.push_back(((rex&0x4)?0:0x80)|last);
+                }
+                else{
+                    bytes.push_back(0xC4);
+                    bytes.push_back(((rex&0x4)?0:0x80)|((rex&0x2)?0:0x40)|((rex&0x1)?0:0x20)|vexMap);
+                    bytes.push_back(((rex&0x8)?0x80:0)|last);
+                }
+            }
+            else if(rex||needsRex)
+                bytes.push_back(0x40|rex);
+            bytes.insert(bytes.end(), opcode.begin(), opcode.end());
+            if(hasModRM)
+                bytes.push_back(modRM);
+            if(hasSib)
+                bytes.push_back(sib);
+
+            if(!dispSymbol.empty())
+                chunk.fixups.push_back(Fixup{(int)bytes.size(), 4, isRipRelative, dispSymbol, disp});
+            for(auto i=0;i<dispSize;i++)
+                bytes.push_back(dispSymbol.empty()?(disp>>(8*i))&0xFF:0);
+
+            if(!immSymbol.empty())
+                chunk.fixups.push_back(Fixup{(int)bytes.size(), immSize, isImmRelative, immSymbol, imm});
+            for(auto i=0;i<immSize;i++)
+                bytes.push_back(immSymbol.empty()?(imm>>(8*i))&0xFF:0);
+
+            return chunk;
+        }
+};
+
+int Encoder::Chunk::getSize(){
+    if(!isJump)
+        return bytes.size();
+    if(isNear)
+        return 2;
+    return (condition<0)?5:6;
+}
+
+Encoder::Encoder(
+    std::vector<Assembler::AsmLabel>* labels,
+    std::vector<Assembler::AsmData>* rodata,
+    std::vector<Assembler::AsmData>* data,
+    std::vector<Assembler::AsmData>* bss
+):
+    labels(labels),
+    rodata(rodata),
+    data(data),
+    bss(bss)
+{}
+
+Elf::Image Encoder::encode(){
+    chunks.clear();
+    symbols.clear();
+
+    std::vector<std::vector<Chunk>> labelsChunks(labels->size());
+    parallelFor(labels->size(), [&](std::size_t i){
+        labelsChunks[i]=encodeLabel(labels->at(i));
+    });
+    for(auto& labelChunks:labelsChunks)
+        chunks.insert(chunks.end(), labelChunks.begin(), labelChunks.end());
+
+    layout();
+
+    Elf::Image image;
+
+    auto textSize=(chunks.empty())?0:chunks.back().address+chunks.back().getSize()-Elf::TEXT_ADDRESS;
+    layoutData(image, textSize);
+
+    for(auto& chunk:chunks)
+        writeChunk(chunk, image.text);
+
+    image.entry=getAddress(L"_start");
+
+    return image;
+}
+
+std::vector<Assembler::AsmInstruction> Encoder::parse(std::wstring _asm){
+    std::vector<AsmInstruction> instructions;
+    auto& types=getInstructionTypes();
+
+    std::wistringstream lines(_asm);
+    std::wstring line;
+    while(std::getline(lines, line)){
+
+        auto isQuoted=false;
+        for(auto i=0;i<line.size();i++){
+            if(line[i]==L'\''||line[i]==L'\"')
+                isQuoted=!isQuoted;
+            else if(line[i]==L';'&&!isQuoted){
+                line=line.substr(0, i);
+                break;
+            }
+        }
+
+        line=trim(line);
+        if(line.empty())
+            continue;
+
+        if(line.back()==L':'){
+            instructions.push_back(AsmInstruction{
+                .type=AsmInstruction::LOCAL_LABEL,
+                .operands={Assembler::label(line)}
+            });
+            continue;
+        }
+
+        // The names with a prefix like "rep movsb" have no operands
+        auto space=line.find_first_of(L" \t");
+        auto typeIt=types.find(toLower(line));
+        if(typeIt!=types.end())
+            space=std::wstring::npos;
+        else
+            typeIt=types.find(toLower(line.substr(0, space)));
+        if(typeIt==types.end())
+            throw AinException(L"تعليمة أسيمبلي غير مدعومة: "+line);
+
+        auto instruction=AsmInstruction{.type=typeIt->second};
+
+        if(space==std::wstring::npos){
+            instructions.push_back(instruction);
+            continue;
+        }
+
+        std::vector<std::wstring> operands={L""};
+        auto depth=0;
+        isQuoted=false;
+        for(auto c:line.substr(space)){
+            if(c==L'\''||c==L'\"')
+                isQuoted=!isQuoted;
+            else if(c==L'[')
+                depth++;
+            else if(c==L']')
+                depth--;
+            else if(c==L','&&depth==0&&!isQuoted){
+                operands.push_back(L"");
+                continue;
+            }
+            operands.back()+=c;
+        }
+
+        for(auto operand:operands){
+            operand=trim(operand);
+
+            auto keywordEnd=operand.find_first_of(L" \t[");
+            if(keywordEnd!=std::wstring::npos){
+                auto keyword=toUpper(operand.substr(0, keywordEnd));
+                auto size=AsmInstruction::IMPLICIT;
+                if(keyword==L"BYTE")
+                    size=AsmInstruction::BYTE;
+                else if(keyword==L"WORD")
+                    size=AsmInstruction::WORD;
+                else if(keyword==L"DWORD")
+                    size=AsmInstruction::DWORD;
+                else if(keyword==L"QWORD")
+                    size=AsmInstruction::QWORD;
+                if(size!=AsmInstruction::IMPLICIT){
+                    instruction.size=size;
+                    operand=trim(operand.substr(keywordEnd));
+                }
+            }
+
+            int64_t value;
+            if(findRegister(operand))
+                instruction.operands.push_back(AsmOperand{.type=AsmOperand::REG, .value=toUpper(operand)});
+            else if(!operand.empty()&&operand.front()==L'[')
+                instruction.operands.push_back(AsmOperand{.type=AsmOperand::ADDRESSING, .value=operand});
+            else if(parseNumber(operand, value))
+                instruction.operands.push_back(Assembler::imm(operand));
+            else
+                instruction.operands.push_back(Assembler::label(operand));
+        }
+
+        instructions.push_back(instruction);
+    }
+
+    return instructions;
+}
+
+std::vector<Encoder::Chunk> Encoder::encodeLabel(Assembler::AsmLabel& label){
+    std::vector<Chunk> labelChunks={Chunk{.label=label.label}};
+    auto currentLabel=label.label;
+    for(auto& instruction:label.instructions)
+        addInstruction(instruction, labelChunks, currentLabel);
+    return labelChunks;
+}
+
+void Encoder::addInstruction(Assembler::AsmInstruction instruction, std::vector<Chunk>& chunks, std::wstring& currentLabel){
+    switch(instruction.type){
+        case AsmInstruction::LOCAL_LABEL:{
+            auto name=instruction.operands[0].value;
+            if(!name.empty()&&name.back()==L':')
+                name.pop_back();
+            if(!name.empty()&&name.front()!=L'.')
+                currentLabel=name;
+            chunks.push_back(Chunk{.label=getSymbol(name, currentLabel)});
+            return;
+        }
+        case AsmInstruction::INLINE_ASM:
+            for(auto& parsedInstruction:parse(instruction.operands[0].value))
+                addInstruction(parsedInstruction, chunks, currentLabel);
+            return;
+        default:
+            chunks.push_back(encodeInstruction(instruction, currentLabel));
+    }
+}
+
+Encoder::Operand Encoder::parseOperand(Assembler::AsmOperand asmOperand, std::wstring& currentLabel){
+    auto text=trim(asmOperand.value);
+    Operand operand;
+
+    if(auto reg=findRegister(text)){
+        operand.kind=Operand::REG;
+        operand.reg=*reg;
+        return operand;
+    }
+
+    auto invalidOperand=AinException(L"لا يمكن ترميز المُعامِل: "+text);
+
+    if(text.empty()||text.front()!=L'['){
+        operand.kind=Operand::IMM;
+        if(!parseNumber(text, operand.value))
+            operand.symbol=getSymbol(text, currentLabel);
+        return operand;
+    }
+
+    operand.kind=Operand::MEM;
+
+    auto addTerm=[&](std::wstring term, bool isNegative){
+        term=trim(term);
+        if(term.empty())
+            return;
+
+        auto star=term.find(L'*');
+        if(star!=std::wstring::npos){
+            auto reg=findRegister(term.substr(0, star));
+            auto scaleText=term.substr(star+1);
+            if(!reg){
+                reg=findRegister(term.substr(star+1));
+                scaleText=term.substr(0, star);
+            }
+            int64_t scale;
+            if(!reg||isNegative||operand.index>=0||!parseNumber(scaleText, scale))
+                throw invalidOperand;
+            operand.index=reg->number;
+            operand.scale=scale;
+            return;
+        }
+
+        if(auto reg=findRegister(term)){
+            if(isNegative)
+                throw invalidOperand;
+            if(operand.base<0)
+                operand.base=reg->number;
+            else if(operand.index<0)
+                operand.index=reg->number;
+            else
+                throw invalidOperand;
+            return;
+        }
+
+        int64_t value;
+        if(parseNumber(term, value)){
+            operand.value+=(isNegative)?-value:value;
+            return;
+        }
+
+        if(isNegative||!operand.symbol.empty())
+            throw invalidOperand;
+        operand.symbol=getSymbol(term, currentLabel);
+    };
+
+    std::wstring term;
+    auto isNegative=false;
+    for(auto c:text.substr(1, text.size()-2)){
+        if(c==L'+'||c==L'-'){
+            addTerm(term, isNegative);
+            term.clear();
+            isNegative=c==L'-';
+            continue;
+        }
+        term+=c;
+    }
+    addTerm(term, isNegative);
+
+    if(operand.index>=0){
+        // x*3, x*5 and x*9 are x+x*2, x+x*4 and x+x*8
+        if(operand.base<0&&(operand.scale==3||operand.scale==5||operand.scale==9)){
+            operand.base=operand.index;
+            operand.scale--;
+        }
+        if(operand.scale==1&&(operand.base<0||operand.index==4))
+            std::swap(operand.base, operand.index);
+        if(operand.scale!=1&&operand.scale!=2&&operand.scale!=4&&operand.scale!=8)
+            throw invalidOperand;
+        if(operand.index==4) // RSP can't be an index
+            throw invalidOperand;
+    }
+
+    return operand;
+}
+
+Encoder::Chunk Encoder::encodeInstruction(Assembler::AsmInstruction instruction, std::wstring& currentLabel){
+    std::vector<Operand> operands;
+    for(auto& operand:instruction.operands)
+        operands.push_back(parseOperand(operand, currentLabel));
+
+    auto type=instruction.type;
+    auto unsupported=getUnsupportedException(instruction);
+
+    auto count=operands.size();
+    auto expect=[&](int expectedCount){
+        if(count!=expectedCount)
+            throw unsupported;
+    };
+    // The size of the first general register, or the size of the instruction if there is no register
+    auto getOperationSize=[&](){
+        for(auto& operand:operands)
+            if(operand.isGeneral())
+                return operand.reg.size;
+        if(instruction.size==AsmInstruction::IMPLICIT)
+            throw unsupported;
+        return (int)instruction.size;
+    };
+    auto getSize=[&](Operand& operand){
+        if(operand.kind==Operand::REG)
+            return operand.reg.size;
+        if(instruction.size==AsmInstruction::IMPLICIT)
+            throw unsupported;
+        return (int)instruction.size;
+    };
+
+    InstructionBuilder builder;
+
+    switch(type){
+        case AsmInstruction::NOP:
+            builder.opcode={0x90};
+            break;
+
+        case AsmInstruction::RET:
+            builder.opcode={0xC3};
+            break;
+
+        case AsmInstruction::SYSCALL:
+            builder.opcode={0x0F, 0x05};
+            break;
+
+        case AsmInstruction::CBW:
+        case AsmInstruction::CWD:
+            builder.setSize(2);
+            builder.opcode={(uint8_t)((type==AsmInstruction::CBW)?0x98:0x99)};
+            break;
+
+        case AsmInstruction::CWDE:
+        case AsmInstruction::CDQ:
+            builder.opcode={(uint8_t)((type==AsmInstruction::CWDE)?0x98:0x99)};
+            break;
+
+        case AsmInstruction::CDQE:
+        case AsmInstruction::CQO:
+            builder.setSize(8);
+            builder.opcode={(uint8_t)((type==AsmInstruction::CDQE)?0x98:0x99)};
+            break;
+
+        case AsmInstruction::PUSH:{
+            expect(1);
+            auto& operand=operands[0];
+            if(operand.isGeneral()&&operand.reg.size==8){
+                builder.opcode={0x50};
+                builder.addToOpcode(operand.reg);
+            }
+            else if(operand.kind==Operand::IMM){
+                if(!fitsInt32(operand.value)) // The immediate is sign extended to 64 bits
+                    throw unsupported;
+                auto isShort=operand.symbol.empty()&&fitsInt8(operand.value);
+                builder.opcode={(uint8_t)(isShort?0x6A:0x68)};
+                builder.setImm(operand, isShort?1:4);
+            }
+            else if(operand.kind==Operand::MEM){
+                builder.opcode={0xFF};
+                builder.setReg(6);
+                builder.setRM(operand);
+            }
+            else
+                throw unsupported;
+            break;
+        }
+
+        case AsmInstruction::POP:{
+            expect(1);
+            auto& operand=operands[0];
+            if(operand.isGeneral()&&operand.reg.size==8){
+                builder.opcode={0x58};
+                builder.addToOpcode(operand.reg);
+            }
+            else if(operand.kind==Operand::MEM){
+                builder.opcode={0x8F};
+                builder.setReg(0);
+                builder.setRM(operand);
+            }
+            else
+                throw unsupported;
+            break;
+        }
+
+        case AsmInstruction::MOV:{
+            expect(2);
+            auto& d=operands[0];
+            auto& s=operands[1];
+
+            if(d.isGeneral()&&s.kind==Operand::IMM){
+                auto size=d.reg.size;
+                if(size==8&&s.symbol.empty()&&s.value>=0&&s.value<=UINT32_MAX){
+                    // Writing the lower half clears the upper half, so the shorter mov is used
+                    builder.opcode={0xB8};
+                    builder.addToOpcode(d.reg);
+                    builder.setImm(s, 4);
+                    builder.imm=(int64_t)(uint32_t)s.value;
+                }
+                else if(size==8&&(!s.symbol.empty()||fitsInt32(s.value))){
+                    builder.setSize(8);
+                    builder.opcode={0xC7};
+                    builder.setReg(0);
+                    builder.setRM(d);
+                    builder.setImm(s, 4);
+                }
+                else{
+                    builder.setSize(size);
+                    builder.opcode={(uint8_t)((size==1)?0xB0:0xB8)};
+                    builder.addToOpcode(d.reg);
+                    builder.setImm(s, size);
+                    builder.imm=signExtend(s.value, size);
+                }
+            }
+            else if(d.kind==Operand::MEM&&s.kind==Operand::IMM){
+                auto size=getSize(d);
+                builder.setSize(size);
+                builder.opcode={(uint8_t)((size==1)?0xC6:0xC7)};
+                builder.setReg(0);
+                builder.setRM(d);
+                builder.setImm(s, std::min(size, 4));
+                builder.imm=signExtend(s.value, size);
+            }
+            else if(s.isGeneral()&&(d.isGeneral()||d.kind==Operand::MEM)){
+                builder.setSize(s.reg.size);
+                builder.opcode={(uint8_t)((s.reg.size==1)?0x88:0x89)};
+                builder.setReg(s.reg);
+                builder.setRM(d);
+            }
+            else if(d.isGeneral()&&s.kind==Operand::MEM){
+                builder.setSize(d.reg.size);
+                builder.opcode={(uint8_t)((d.reg.size==1)?0x8A:0x8B)};
+                builder.setReg(d.reg);
+                builder.setRM(s);
+            }
+            else
+                throw unsupported;
+            break;
+        }
+
+        case AsmInstruction::MOVSX:
+        case AsmInstruction::MOVZX:{
+            expect(2);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            if(!d.isGeneral()||s.isXmm())
+                throw unsupported;
+            auto sourceSize=getSize(s);
+            builder.setSize(d.reg.size);
+            builder.opcode={0x0F, (uint8_t)(((type==AsmInstruction::MOVSX)?0xBE:0xB6)+((sourceSize==2)?1:0))};
+            builder.setReg(d.reg);
+            builder.setRM(s);
+            break;
+        }
+
+        case AsmInstruction::MOVSXD:
+        case AsmInstruction::LEA:
+        case AsmInstruction::BSR:
+        case AsmInstruction::BSF:
+        case AsmInstruction::CMOVZ:
+        case AsmInstruction::CMOVNZ:
+        case AsmInstruction::CMOVS:
+        case AsmInstruction::CMOVG:{
+            expect(2);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            if(!d.isGeneral()||s.isXmm())
+                throw unsupported;
+            builder.setSize((type==AsmInstruction::MOVSXD)?8:d.reg.size);
+            switch(type){
+                case AsmInstruction::MOVSXD:
+                    builder.opcode={0x63};break;
+                case AsmInstruction::LEA:
+                    if(s.kind!=Operand::MEM)
+                        throw unsupported;
+                    builder.opcode={0x8D};break;
+                case AsmInstruction::BSR:
+                    builder.opcode={0x0F, 0xBD};break;
+                case AsmInstruction::BSF:
+                    builder.opcode={0x0F, 0xBC};break;
+                default:
+                    builder.opcode={0x0F, (uint8_t)(0x40+getConditionCode(type))};break;
+            }
+            builder.setReg(d.reg);
+            builder.setRM(s);
+            break;
+        }
+
+        case AsmInstruction::ADD:
+        case AsmInstruction::OR:
+        case AsmInstruction::AND:
+        case AsmInstruction::SUB:
+        case AsmInstruction::XOR:
+        case AsmInstruction::CMP:{
+            expect(2);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            auto extension=getArithmeticExtension(type);
+            auto size=getOperationSize();
+            builder.setSize(size);
+
+            if(s.kind==Operand::IMM){
+                auto value=signExtend(s.value, size);
+                if(size==1&&d.isGeneral()&&d.reg.number==0){
+                    builder.opcode={(uint8_t)(extension*8+4)};
+                    builder.setImm(s, 1);
+                }
+                else if(size==1){
+                    builder.opcode={0x80};
+                    builder.setReg(extension);
+                    builder.setRM(d);
+                    builder.setImm(s, 1);
+                }
+                else if(s.symbol.empty()&&fitsInt8(value)){
+                    builder.opcode={0x83};
+                    builder.setReg(extension);
+                    builder.setRM(d);
+                    builder.setImm(s, 1);
+                }
+                else if(d.isGeneral()&&d.reg.number==0){
+                    builder.opcode={(uint8_t)(extension*8+5)};
+                    builder.setImm(s, (size==2)?2:4);
+                }
+                else{
+                    builder.opcode={0x81};
+                    builder.setReg(extension);
+                    builder.setRM(d);
+                    builder.setImm(s, (size==2)?2:4);
+                }
+                builder.imm=value;
+            }
+            else if(s.isGeneral()&&(d.isGeneral()||d.kind==Operand::MEM)){
+                builder.opcode={(uint8_t)(extension*8+((size==1)?0:1))};
+                builder.setReg(s.reg);
+                builder.setRM(d);
+            }
+            else if(d.isGeneral()&&s.kind==Operand::MEM){
+                builder.opcode={(uint8_t)(extension*8+((size==1)?2:3))};
+                builder.setReg(d.reg);
+                builder.setRM(s);
+            }
+            else
+                throw unsupported;
+            break;
+        }
+
+        case AsmInstruction::TEST:{
+            expect(2);
+            auto d=operands[0];
+            auto s=operands[1];
+            if(s.kind==Operand::MEM)
+                std::swap(d, s);
+            auto size=getOperationSize();
+            builder.setSize(size);
+
+            if(s.kind==Operand::IMM){
+                if(d.isGeneral()&&d.reg.number==0)
+                    builder.opcode={(uint8_t)((size==1)?0xA8:0xA9)};
+                else{
+                    builder.opcode={(uint8_t)((size==1)?0xF6:0xF7)};
+                    builder.setReg(0);
+                    builder.setRM(d);
+                }
+                builder.setImm(s, std::min(size, 4));
+                builder.imm=signExtend(s.value, size);
+            }
+            else if(s.isGeneral()){
+                builder.opcode={(uint8_t)((size==1)?0x84:0x85)};
+                builder.setReg(s.reg);
+                builder.setRM(d);
+            }
+            else
+                throw unsupported;
+            break;
+        }
+
+        case AsmInstruction::SHR:
+        case AsmInstruction::SHL:{
+            expect(2);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            auto size=getSize(d);
+            builder.setSize(size);
+            auto opcodeOffset=(size==1)?0:1;
+
+            if(s.isGeneral()){
+                if(s.reg.number!=1||s.reg.size!=1) // Only CL
+                    throw unsupported;
+                builder.opcode={(uint8_t)(0xD2+opcodeOffset)};
+            }
+            else if(s.kind==Operand::IMM&&s.symbol.empty()&&s.value==1)
+                builder.opcode={(uint8_t)(0xD0+opcodeOffset)};
+            else if(s.kind==Operand::IMM){
+                builder.opcode={(uint8_t)(0xC0+opcodeOffset)};
+                builder.setImm(s, 1);
+            }
+            else
+                throw unsupported;
+
+            builder.setReg((type==AsmInstruction::SHL)?4:5);
+            builder.setRM(d);
+            break;
+        }
+
+        case AsmInstruction::INC:
+        case AsmInstruction::DEC:{
+            expect(1);
+            auto size=getSize(operands[0]);
+            builder.setSize(size);
+            builder.opcode={(uint8_t)((size==1)?0xFE:0xFF)};
+            builder.setReg((type==AsmInstruction::INC)?0:1);
+            builder.setRM(operands[0]);
+            break;
+        }
+
+        case AsmInstruction::IMUL:
+            if(count==2){
+                auto& d=operands[0];
+                if(!d.isGeneral())
+                    throw unsupported;
+                builder.setSize(d.reg.size);
+                builder.opcode={0x0F, 0xAF};
+                builder.setReg(d.reg);
+                builder.setRM(operands[1]);
+                break;
+            }
+            if(count==3){
+                auto& d=operands[0];
+                auto& s=operands[2];
+                if(!d.isGeneral()||s.kind!=Operand::IMM)
+                    throw unsupported;
+                builder.setSize(d.reg.size);
+                auto isShort=s.symbol.empty()&&fitsInt8(s.value);
+                builder.opcode={(uint8_t)(isShort?0x6B:0x69)};
+                builder.setReg(d.reg);
+                builder.setRM(operands[1]);
+                builder.setImm(s, isShort?1:((d.reg.size==2)?2:4));
+                break;
+            }
+            [[fallthrough]];
+        case AsmInstruction::NOT:
+        case AsmInstruction::NEG:
+        case AsmInstruction::MUL:
+        case AsmInstruction::DIV:
+        case AsmInstruction::IDIV:{
+            expect(1);
+            auto size=getSize(operands[0]);
+            builder.setSize(size);
+            builder.opcode={(uint8_t)((size==1)?0xF6:0xF7)};
+            builder.setReg(getUnaryExtension(type));
+            builder.setRM(operands[0]);
+            break;
+        }
+
+        case AsmInstruction::SETZ:
+        case AsmInstruction::SETNZ:
+        case AsmInstruction::SETS:
+        case AsmInstruction::SETNS:
+        case AsmInstruction::SETG:
+        case AsmInstruction::SETGE:
+        case AsmInstruction::SETL:
+        case AsmInstruction::SETLE:
+        case AsmInstruction::SETA:
+        case AsmInstruction::SETAE:
+        case AsmInstruction::SETB:
+        case AsmInstruction::SETBE:
+            expect(1);
+            builder.opcode={0x0F, (uint8_t)(0x90+getConditionCode(type))};
+            builder.setReg(0);
+            builder.setRM(operands[0]);
+            break;
+
+        case AsmInstruction::CALL:
+        case AsmInstruction::JMP:
+        case AsmInstruction::JZ:
+        case AsmInstruction::JNZ:
+        case AsmInstruction::JS:
+        case AsmInstruction::JNS:
+        case AsmInstruction::JG:
+        case AsmInstruction::JGE:
+        case AsmInstruction::JL:
+        case AsmInstruction::JLE:
+        case AsmInstruction::JA:
+        case AsmInstruction::JAE:
+        case AsmInstruction::JB:
+        case AsmInstruction::JBE:{
+            expect(1);
+            auto& target=operands[0];
+            if(target.kind==Operand::IMM&&!target.symbol.empty()){
+                if(type==AsmInstruction::CALL){
+                    builder.opcode={0xE8};
+                    builder.setImm(target, 4, true);
+                    break;
+                }
+                return Chunk{
+                    .isJump=true,
+                    .condition=getConditionCode(type),
+                    .target=target.symbol
+                };
+            }
+            if(type!=AsmInstruction::CALL&&type!=AsmInstruction::JMP)
+                throw unsupported;
+            if(target.kind==Operand::IMM||(target.isGeneral()&&target.reg.size!=8))
+                throw unsupported;
+            builder.opcode={0xFF};
+            builder.setReg((type==AsmInstruction::CALL)?2:4);
+            builder.setRM(target);
+            break;
+        }
+
+        case AsmInstruction::BSWAP:{
+            expect(1);
+            auto& d=operands[0];
+            if(!d.isGeneral()||d.reg.size<4)
+                throw unsupported;
+            builder.setSize(d.reg.size);
+            builder.opcode={0x0F, 0xC8};
+            builder.addToOpcode(d.reg);
+            break;
+        }
+
+        case AsmInstruction::XCHG:{
+            expect(2);
+            auto d=operands[0];
+            auto s=operands[1];
+            if(s.kind==Operand::MEM)
+                std::swap(d, s);
+            if(!s.isGeneral())
+                throw unsupported;
+            builder.setSize(s.reg.size);
+            builder.opcode={(uint8_t)((s.reg.size==1)?0x86:0x87)};
+            builder.setReg(s.reg);
+            builder.setRM(d);
+            break;
+        }
+
+        case AsmInstruction::MOVQ:
+        case AsmInstruction::MOVD:{
+            expect(2);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            auto rexW=(type==AsmInstruction::MOVQ)?0x8:0;
+            if(d.isXmm()&&(s.isGeneral()||(type==AsmInstruction::MOVD&&s.kind==Operand::MEM))){
+                builder.prefixes={0x66};
+                builder.rex|=rexW;
+                builder.opcode={0x0F, 0x6E};
+                builder.setReg(d.reg);
+                builder.setRM(s);
+            }
+            else if(s.isXmm()&&(d.isGeneral()||(type==AsmInstruction::MOVD&&d.kind==Operand::MEM))){
+                builder.prefixes={0x66};
+                builder.rex|=rexW;
+                builder.opcode={0x0F, 0x7E};
+                builder.setReg(s.reg);
+                builder.setRM(d);
+            }
+            else if(d.isXmm()&&s.kind!=Operand::IMM){
+                builder.prefixes={0xF3};
+                builder.opcode={0x0F, 0x7E};
+                builder.setReg(d.reg);
+                builder.setRM(s);
+            }
+            else if(s.isXmm()&&d.kind==Operand::MEM){
+                builder.prefixes={0x66};
+                builder.opcode={0x0F, 0xD6};
+                builder.setReg(s.reg);
+                builder.setRM(d);
+            }
+            else
+                throw unsupported;
+            break;
+        }
+
+        case AsmInstruction::MOVSD:
+        case AsmInstruction::MOVSS:{
+            expect(2);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            builder.prefixes={(uint8_t)((type==AsmInstruction::MOVSD)?0xF2:0xF3)};
+            if(d.isXmm()&&(s.isXmm()||s.kind==Operand::MEM)){
+                builder.opcode={0x0F, 0x10};
+                builder.setReg(d.reg);
+                builder.setRM(s);
+            }
+            else if(d.kind==Operand::MEM&&s.isXmm()){
+                builder.opcode={0x0F, 0x11};
+                builder.setReg(s.reg);
+                builder.setRM(d);
+            }
+            else
+                throw unsupported;
+            break;
+        }
+
+        case AsmInstruction::CVTSI2SD:
+        case AsmInstruction::CVTSI2SS:{
+            expect(2);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            if(!d.isXmm()||s.isXmm()||s.kind==Operand::IMM)
+                throw unsupported;
+            builder.prefixes={(uint8_t)((type==AsmInstruction::CVTSI2SD)?0xF2:0xF3)};
+            if(getSize(s)==8)
+                builder.rex|=0x8;
+            builder.opcode={0x0F, 0x2A};
+            builder.setReg(d.reg);
+            builder.setRM(s);
+            break;
+        }
+
+        case AsmInstruction::CVTSD2SI:
+        case AsmInstruction::CVTSS2SI:{
+            expect(2);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            if(!d.isGeneral()||s.isGeneral()||s.kind==Operand::IMM)
+                throw unsupported;
+            builder.prefixes={(uint8_t)((type==AsmInstruction::CVTSD2SI)?0xF2:0xF3)};
+            if(d.reg.size==8)
+                builder.rex|=0x8;
+            builder.opcode={0x0F, 0x2D};
+            builder.setReg(d.reg);
+            builder.setRM(s);
+            break;
+        }
+
+        case AsmInstruction::CVTSS2SD:
+        case AsmInstruction::CVTSD2SS:
+        case AsmInstruction::ADDSD:
+        case AsmInstruction::SUBSD:
+        case AsmInstruction::MULSD:
+        case AsmInstruction::DIVSD:
+        case AsmInstruction::ADDSS:
+        case AsmInstruction::SUBSS:
+        case AsmInstruction::MULSS:
+        case AsmInstruction::DIVSS:{
+            expect(2);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            if(!d.isXmm()||s.isGeneral()||s.kind==Operand::IMM)
+                throw unsupported;
+            auto isDouble=type==AsmInstruction::CVTSD2SS||(type>=AsmInstruction::ADDSD&&type<=AsmInstruction::DIVSD);
+            builder.prefixes={(uint8_t)(isDouble?0xF2:0xF3)};
+            uint8_t opcode;
+            switch(type){
+                case AsmInstruction::CVTSS2SD:
+                case AsmInstruction::CVTSD2SS:
+                    opcode=0x5A;break;
+                case AsmInstruction::ADDSD:
+                case AsmInstruction::ADDSS:
+                    opcode=0x58;break;
+                case AsmInstruction::SUBSD:
+                case AsmInstruction::SUBSS:
+                    opcode=0x5C;break;
+                case AsmInstruction::MULSD:
+                case AsmInstruction::MULSS:
+                    opcode=0x59;break;
+                default:
+                    opcode=0x5E;break;
+            }
+            builder.opcode={0x0F, opcode};
+            builder.setReg(d.reg);
+            builder.setRM(s);
+            break;
+        }
+
+        case AsmInstruction::ROUNDSD:
+        case AsmInstruction::ROUNDSS:{
+            expect(3);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            if(!d.isXmm()||s.isGeneral()||s.kind==Operand::IMM||operands[2].kind!=Operand::IMM)
+                throw unsupported;
+            builder.prefixes={0x66};
+            builder.opcode={0x0F, 0x3A, (uint8_t)((type==AsmInstruction::ROUNDSD)?0x0B:0x0A)};
+            builder.setReg(d.reg);
+            builder.setRM(s);
+            builder.setImm(operands[2], 1);
+            break;
+        }
+
+        case AsmInstruction::MOVDQU:
+        case AsmInstruction::MOVDQA:
+        case AsmInstruction::VMOVDQU:{
+            expect(2);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            auto isVex=type==AsmInstruction::VMOVDQU;
+            auto prefix=(uint8_t)((type==AsmInstruction::MOVDQA)?0x66:0xF3);
+            auto isLoad=d.kind==Operand::REG;
+            auto& reg=isLoad?d:s;
+            auto& rm=isLoad?s:d;
+            if(!(isVex?reg.isVector():reg.isXmm())||!(rm.kind==Operand::MEM||(rm.kind==Operand::REG&&rm.reg.size==reg.reg.size)))
+                throw unsupported;
+            auto opcode=(uint8_t)(isLoad?0x6F:0x7F);
+            if(isVex){
+                builder.setVex(1, prefix, reg.reg.size);
+                builder.opcode={opcode};
+            }
+            else{
+                builder.prefixes={prefix};
+                builder.opcode={0x0F, opcode};
+            }
+            builder.setReg(reg.reg);
+            builder.setRM(rm);
+            break;
+        }
+
+        case AsmInstruction::PSHUFD:{
+            expect(3);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            if(!d.isXmm()||!(s.isXmm()||s.kind==Operand::MEM)||operands[2].kind!=Operand::IMM)
+                throw unsupported;
+            builder.prefixes={0x66};
+            builder.opcode={0x0F, 0x70};
+            builder.setReg(d.reg);
+            builder.setRM(s);
+            builder.setImm(operands[2], 1);
+            break;
+        }
+
+        case AsmInstruction::PSRLDQ:{
+            expect(2);
+            auto& d=operands[0];
+            if(!d.isXmm()||operands[1].kind!=Operand::IMM)
+                throw unsupported;
+            builder.prefixes={0x66};
+            builder.opcode={0x0F, 0x73};
+            builder.setReg(3);
+            builder.setRM(d);
+            builder.setImm(operands[1], 1);
+            break;
+        }
+
+        case AsmInstruction::PADDB:
+        case AsmInstruction::PADDW:
+        case AsmInstruction::PADDD:
+        case AsmInstruction::PADDQ:
+        case AsmInstruction::PSUBB:
+        case AsmInstruction::PSUBW:
+        case AsmInstruction::PSUBD:
+        case AsmInstruction::PSUBQ:
+        case AsmInstruction::PAND:
+        case AsmInstruction::POR:
+        case AsmInstruction::PXOR:
+        case AsmInstruction::ADDPS:
+        case AsmInstruction::SUBPS:
+        case AsmInstruction::MULPS:
+        case AsmInstruction::DIVPS:
+        case AsmInstruction::ADDPD:
+        case AsmInstruction::SUBPD:
+        case AsmInstruction::MULPD:
+        case AsmInstruction::DIVPD:
+        case AsmInstruction::PCMPEQB:{
+            expect(2);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            if(!d.isXmm()||!(s.isXmm()||s.kind==Operand::MEM))
+                throw unsupported;
+            auto packedOpcode=getPackedOpcode(type);
+            if(packedOpcode.first)
+                builder.prefixes={packedOpcode.first};
+            builder.opcode={0x0F, packedOpcode.second};
+            builder.setReg(d.reg);
+            builder.setRM(s);
+            break;
+        }
+
+        case AsmInstruction::VPADDB:
+        case AsmInstruction::VPADDW:
+        case AsmInstruction::VPADDD:
+        case AsmInstruction::VPADDQ:
+        case AsmInstruction::VPSUBB:
+        case AsmInstruction::VPSUBW:
+        case AsmInstruction::VPSUBD:
+        case AsmInstruction::VPSUBQ:
+        case AsmInstruction::VPAND:
+        case AsmInstruction::VPOR:
+        case AsmInstruction::VPXOR:
+        case AsmInstruction::VADDPS:
+        case AsmInstruction::VSUBPS:
+        case AsmInstruction::VMULPS:
+        case AsmInstruction::VDIVPS:
+        case AsmInstruction::VADDPD:
+        case AsmInstruction::VSUBPD:
+        case AsmInstruction::VMULPD:
+        case AsmInstruction::VDIVPD:{
+            expect(3);
+            auto& d=operands[0];
+            auto& s1=operands[1];
+            auto& s2=operands[2];
+            auto size=d.reg.size;
+            if(
+                !d.isVector()||s1.kind!=Operand::REG||s1.reg.size!=size
+                ||!(s2.kind==Operand::MEM||(s2.kind==Operand::REG&&s2.reg.size==size))
+            )
+                throw unsupported;
+            auto packedOpcode=getPackedOpcode(type);
+            builder.setVex(1, packedOpcode.first, size, s1.reg.number);
+            builder.opcode={packedOpcode.second};
+            builder.setReg(d.reg);
+            builder.setRM(s2);
+            break;
+        }
+
+        case AsmInstruction::VPBROADCASTD:
+        case AsmInstruction::VPBROADCASTQ:{
+            expect(2);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            if(!d.isVector()||!(s.isXmm()||s.kind==Operand::MEM))
+                throw unsupported;
+            builder.setVex(2, 0x66, d.reg.size);
+            builder.opcode={(uint8_t)((type==AsmInstruction::VPBROADCASTD)?0x58:0x59)};
+            builder.setReg(d.reg);
+            builder.setRM(s);
+            break;
+        }
+
+        case AsmInstruction::VEXTRACTI128:{
+            expect(3);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            if(!(d.isXmm()||d.kind==Operand::MEM)||!s.isYmm()||operands[2].kind!=Operand::IMM)
+                throw unsupported;
+            builder.setVex(3, 0x66, 32);
+            builder.opcode={0x39};
+            builder.setReg(s.reg);
+            builder.setRM(d);
+            builder.setImm(operands[2], 1);
+            break;
+        }
+
+        case AsmInstruction::VZEROUPPER:
+            builder.setVex(1, 0, 16);
+            builder.opcode={0x77};
+            break;
+
+        case AsmInstruction::PMOVMSKB:{
+            expect(2);
+            auto& d=operands[0];
+            auto& s=operands[1];
+            if(!d.isGeneral()||d.reg.size<4||!s.isXmm())
+                throw unsupported;
+            builder.prefixes={0x66};
+            builder.opcode={0x0F, 0xD7};
+            builder.setReg(d.reg);
+            builder.setRM(s);
+            break;
+        }
+
+        case AsmInstruction::REP_MOVSB:
+        case AsmInstruction::REP_STOSB:
+            builder.prefixes={0xF3};
+            builder.opcode={(uint8_t)((type==AsmInstruction::REP_MOVSB)?0xA4:0xAA)};
+            break;
+
+        default:
+            throw unsupported;
+    }
+
+    return builder.getChunk(instruction);
+}
+
+void Encoder::layout(){
+    auto changed=true;
+    while(changed){
+        changed=false;
+
+        auto address=Elf::TEXT_ADDRESS;
+        for(auto& chunk:chunks){
+            chunk.address=address;
+            address+=chunk.getSize();
+            if(!chunk.label.empty())
+                symbols[chunk.label]=chunk.address;
+        }
+
+        for(auto& chunk:chunks){
+            if(!chunk.isJump||!chunk.isNear)
+                continue;
+            auto distance=(int64_t)getAddress(chunk.target)-(int64_t)(chunk.address+chunk.getSize());
+            if(!fitsInt8(distance)){
+                chunk.isNear=false;
+                changed=true;
+            }
+        }
+    }
+}
+
+void Encoder::layoutData(Elf::Image& image, uint64_t textSize){
+    layoutValues(*rodata, image.rodata, Elf::getRodataAddress(textSize));
+
+    auto address=Elf::getDataAddress(textSize, image.rodata.size());
+    layoutValues(*data, image.data, address);
+
+    uint64_t bssSize=0;
+    for(auto& entry:*bss){
+        bssSize=(bssSize+entry.size-1)/entry.size*entry.size;
+        symbols[entry.label]=address+image.data.size()+bssSize;
+        bssSize+=entry.size*entry.reservedSize;
+    }
+    image.bssSize=bssSize;
+}
+
+void Encoder::layoutValues(std::vector<Assembler::AsmData>& entries, std::vector<uint8_t>& bytes, uint64_t address){
+    auto align=[&](int size){
+        while(bytes.size()%size)
+            bytes.push_back(0);
+    };
+
+    for(auto& entry:entries){
+        align(entry.size);
+        symbols[entry.label]=address+bytes.size();
+        for(auto value:entry.values)
+            for(auto i=0;i<entry.size;i++)
+                bytes.push_back((value>>(8*i))&0xFF);
+    }
+
+    align(8);
+}
+
+void Encoder::writeChunk(Chunk& chunk, std::vector<uint8_t>& text){
+    auto write=[&](int64_t value, int size){
+        for(auto i=0;i<size;i++)
+            text.push_back((value>>(8*i))&0xFF);
+    };
+
+    if(chunk.isJump){
+        auto distance=(int64_t)getAddress(chunk.target)-(int64_t)(chunk.address+chunk.getSize());
+        if(chunk.isNear){
+            text.push_back((chunk.condition<0)?0xEB:0x70+chunk.condition);
+            write(distance, 1);
+        }
+        else if(chunk.condition<0){
+            text.push_back(0xE9);
+            write(distance, 4);
+        }
+        else{
+            text.push_back(0x0F);
+            text.push_back(0x80+chunk.condition);
+            write(distance, 4);
+        }
+        return;
+    }
+
+    auto start=text.size();
+    text.insert(text.end(), chunk.bytes.begin(), chunk.bytes.end());
+
+    for(auto& fixup:chunk.fixups){
+        auto value=(int64_t)getAddress(fixup.symbol)+fixup.addend;
+        if(fixup.isRelative)
+            value-=chunk.address+chunk.bytes.size();
+        if(fixup.size==4&&!fitsInt32(value))
+            throw AinException(L"العنوان بعيد جدًا عن الرمز "+fixup.symbol);
+        for(auto i=0;i<fixup.size;i++)
+            text[start+fixup.offset+i]=(value>>(8*i))&0xFF;
+    }
+}
+
+std::wstring Encoder::getSymbol(std::wstring name, std::wstring& currentLabel){
+    if(!name.empty()&&name.front()==L'.')
+        return currentLabel+name;
+    return name;
+}
+
+uint64_t Encoder::getAddress(std::wstring symbol){
+    auto symbolIt=symbols.find(symbol);
+    if(symbolIt==symbols.end())
+        throw AinException(L"لم يتم العثور على الرمز "+symbol);
+    return symbolIt->second;
+}
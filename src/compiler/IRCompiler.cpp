@@ -0,0 +1,794 @@
+#include "IRCompiler.hpp"
+#include "Compiler.hpp"
+#include "CompilerVarsOffsetSetter.hpp"
+#include "IRPasses.hpp"
+#include "RegisterAllocator.hpp"
+#include "BaseScope.hpp"
+#include "BuiltInFunScope.hpp"
+#include "FunDecl.hpp"
+#include "FunParam.hpp"
+#include "FunScope.hpp"
+#include "Type.hpp"
+#include "Variable.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+const std::vector<IRCompiler::Register> IRCompiler::REGISTERS={
+    Assembler::RSI, Assembler::RDI, Assembler::R8, Assembler::R9, Assembler::R10, Assembler::R11,
+    // The AST code generator doesn't use R12-R15 and restores RBX after using it
+    Assembler::RBX, Assembler::R12, Assembler::R13, Assembler::R14, Assembler::R15,
+};
+
+IRCompiler::IRCompiler(Compiler* compiler, std::unique_ptr<IR::Function> fun, Assembler::AsmLabel* asmLabel):
+    compiler(compiler), fun(std::move(fun)), asmLabel(asmLabel){}
+
+bool IRCompiler::prepare(){
+
+    // All the globals should be in the data segment
+    for(auto &instruction:fun->instructions){
+        if(!instruction->var||instruction->op==IR::Op::PARAM)
+            continue;
+        if(compiler->offsets[instruction->var].reg.value.find(L"var")!=0)
+            return false;
+    }
+
+    IR::splitCriticalEdges(fun.get());
+    order=IR::getReversePostOrder(fun.get());
+
+    // In the order of compiling the blocks, so the labels and the globals are added as if it was compiled here
+    for(auto block:order){
+        for(auto instruction:block->instructions){
+            if(instruction->op==IR::Op::LOAD_GLOBAL||instruction->op==IR::Op::STORE_GLOBAL)
+                compiler->useGlobalVariable(instruction->var);
+
+            if(instruction->op!=IR::Op::CALL)
+                continue;
+
+            auto callee=instruction->callee;
+            if(auto builtIn=dynamic_cast<BuiltInFunScope*>(callee))
+                builtInsAsm[instruction]=builtIn->getGeneratedAsm(compiler);
+            else if(compiler->labelsAsm.find(callee)==compiler->labelsAsm.end())
+                callee->accept(compiler);
+        }
+    }
+
+    return true;
+}
+
+void IRCompiler::compile(){
+
+    countUses();
+    assignLocations();
+
+    emit(Assembler::push(Assembler::RBP()));
+    emit(Assembler::mov(Assembler::RBP(), Assembler::RSP()));
+    emit(Assembler::reserveSpaceOnStack((slots.size()+savedRegisters.size())*8));
+
+    for(auto &regSlot:savedRegisters)
+        emit(Assembler::mov(Assembler::addressMov(Assembler::RBP(), regSlot.second), regSlot.first(Assembler::AsmInstruction::QWORD)));
+
+    compileRegisterParams();
+
+    for(int i=0;i<order.size();i++)
+        compileBlock(i);
+}
+
+void IRCompiler::emit(Assembler::AsmInstruction instruction){
+    *asmLabel+=instruction;
+}
+
+void IRCompiler::emit(std::vector<Assembler::AsmInstruction> instructions){
+    *asmLabel+=instructions;
+}
+
+void IRCompiler::countUses(){
+    for(auto block:order){
+        for(auto instruction:block->instructions){
+            for(auto operand:instruction->operands)
+                usesCount[operand]++;
+        }
+        if(block->value)
+            usesCount[block->value]++;
+    }
+}
+
+bool IRCompiler::isFusedCompare(IR::Instruction* instruction){
+    auto block=instruction->block;
+    return
+        instruction->isCompare()
+        &&block->terminator==IR::BasicBlock::Terminator::BRANCH
+        &&block->value==instruction
+        &&usesCount[instruction]==1
+    ;
+}
+
+bool IRCompiler::needsLocation(IR::Instruction* instruction){
+    return
+        *instruction->type!=*Type::VOID
+        &&instruction->op!=IR::Op::CONST
+        &&!isFusedCompare(instruction)
+    ;
+}
+
+void IRCompiler::assignLocations(){
+
+    // The operands of a fused compare should live until the branch
+    for(auto block:order){
+        auto &instructions=block->instructions;
+        auto compareIt=std::find(instructions.begin(), instructions.end(), block->value);
+        if(compareIt==instructions.end()||!isFusedCompare(*compareIt))
+            continue;
+        instructions.erase(compareIt);
+        instructions.push_back(block->value);
+    }
+
+    RegisterAllocator allocator(order, [&](IR::Instruction* instruction){return needsLocation(instruction);});
+
+    std::vector<int> scratchRegisters, preservedRegisters;
+    for(int i=0;i<REGISTERS.size();i++)
+        ((i<SCRATCH_REGISTERS_SIZE)?scratchRegisters:preservedRegisters).push_back(i);
+
+    allocator.allocate(scratchRegisters, preservedRegisters);
+
+    auto slotsSize=0;
+
+    for(auto block:order){
+        for(auto instruction:block->instructions){
+            if(!needsLocation(instruction))
+                continue;
+
+            auto reg=allocator.getRegister(instruction);
+            if(reg!=-1)
+                registers[instruction]=REGISTERS[reg];
+            else
+                slots[instruction]=-8*(++slotsSize);
+        }
+    }
+
+    for(auto reg:allocator.getUsedPreservedRegisters())
+        savedRegisters.push_back({REGISTERS[reg], -8*(++slotsSize)});
+}
+
+void IRCompiler::compileRegisterParams(){
+    if(!CompilerVarsOffsetSetter::hasRegisterParams(fun->scope))
+        return;
+
+    auto params=fun->scope->getDecl()->params;
+    auto locals=fun->scope->getLocals();
+    auto &argsRegisters=CompilerVarsOffsetSetter::PARAMS_REGISTERS;
+
+    std::unordered_map<Variable*, Register> paramsRegisters;
+    for(int i=0;i<params->size()&&i<argsRegisters.size();i++){
+        auto var=(*locals)[*(*params)[i]->name].get();
+        paramsRegisters[var]=argsRegisters[i];
+        registerParams.insert(var);
+    }
+
+    // The params are read at the start of the entry block
+    std::vector<std::pair<Register, Register>> moves;
+    for(auto instruction:fun->getEntry()->instructions){
+        if(instruction->op!=IR::Op::PARAM)
+            continue;
+
+        auto paramRegIt=paramsRegisters.find(instruction->var);
+        if(paramRegIt==paramsRegisters.end())
+            continue;
+
+        auto reg=paramRegIt->second;
+        extend(instruction->type, reg);
+
+        if(isInRegister(instruction))
+            moves.push_back({registers[instruction], reg});
+        else
+            emit(Assembler::mov(getLocation(instruction), reg(Assembler::AsmInstruction::QWORD)));
+    }
+
+    emitParallelMoves(moves);
+}
+
+void IRCompiler::compileBlock(int index){
+    auto block=order[index];
+    auto next=(index+1<order.size())?order[index+1]:nullptr;
+
+    if(index!=0)
+        emit(Assembler::localLabel(L"bb"+std::to_wstring(block->id)));
+
+    for(auto instruction:block->instructions)
+        compileInstruction(instruction);
+
+    switch(block->terminator){
+        case IR::BasicBlock::Terminator::JUMP:{
+            auto target=block->targets[0];
+            compilePhiCopies(block, target);
+            if(target!=next)
+                emit(Assembler::jmp(getBlockLabel(target)));
+            break;
+        }
+        case IR::BasicBlock::Terminator::BRANCH:
+            compileBranch(block, next);
+            break;
+        default:
+            compileReturn(block);
+            break;
+    }
+}
+
+void IRCompiler::compileInstruction(IR::Instruction* instruction){
+    using Op=IR::Op;
+
+    auto type=instruction->type;
+    auto target=getResultRegister(instruction);
+
+    switch(instruction->op){
+        case Op::CONST:
+        case Op::PHI:
+            // The constants are used as imms and the phis are assigned by their preds
+            return;
+
+        case Op::PARAM:{
+            auto var=instruction->var;
+            if(registerParams.find(var)!=registerParams.end())
+                return;
+            auto offset=compiler->offsets.at(var);
+            emit(Assembler::mov(
+                target(Type::getSize(type.get())),
+                Assembler::addressMov(offset.reg, offset.value),
+                Assembler::AsmInstruction::IMPLICIT,
+                L"مُعامِل "+*var->getName()
+            ));
+            extend(type, target);
+            break;
+        }
+
+        case Op::ADD:
+        case Op::SUB:
+        case Op::MUL:
+        case Op::AND:
+        case Op::OR:
+        case Op::XOR:
+            compileBinaryOp(instruction);
+            return;
+
+        case Op::DIV:
+        case Op::MOD:
+            compileDivOrMod(instruction);
+            return;
+
+        case Op::SHL:
+        case Op::SHR:
+            compileShift(instruction);
+            return;
+
+        case Op::NEG:
+            move(target, instruction->operands[0]);
+            emit(Assembler::neg(target(Assembler::AsmInstruction::QWORD)));
+            extend(type, target);
+            break;
+
+        case Op::NOT:
+            move(target, instruction->operands[0]);
+            emit(Assembler::_not(target(Assembler::AsmInstruction::QWORD)));
+            extend(type, target);
+            break;
+
+        case Op::LOGICAL_NOT:
+            move(target, instruction->operands[0]);
+            emit(Assembler::_xor(target(Assembler::AsmInstruction::QWORD), Assembler::imm(L"1")));
+            break;
+
+        case Op::CONVERT:
+            move(target, instruction->operands[0]);
+            extend(type, target);
+            break;
+
+        case Op::EQ:
+        case Op::NE:
+        case Op::LT:
+        case Op::LE:
+        case Op::GT:
+        case Op::GE:
+            if(isFusedCompare(instruction))
+                return;
+            compileCompare(instruction);
+            return;
+
+        case Op::LOAD_GLOBAL:{
+            auto var=instruction->var;
+            auto offset=compiler->offsets.at(var);
+            emit(Assembler::mov(
+                target(Type::getSize(type.get())),
+                Assembler::addressMov(offset.reg, offset.value),
+                Assembler::AsmInstruction::IMPLICIT,
+                L"الوصول لمتغير "+*var->getName()
+            ));
+            extend(type, target);
+            break;
+        }
+
+        case Op::STORE_GLOBAL:{
+            auto var=instruction->var;
+            auto offset=compiler->offsets.at(var);
+            auto reg=getValueRegister(instruction->operands[0]);
+            emit(Assembler::mov(
+                Assembler::addressMov(offset.reg, offset.value),
+                reg(Type::getSize(var->getType().get())),
+                Assembler::AsmInstruction::IMPLICIT,
+                L"تخصيص متغير "+*var->getName()
+            ));
+            return;
+        }
+
+        case Op::LOAD:{
+            auto address=getValueRegister(instruction->operands[0]);
+            emit(Assembler::mov(
+                target(Type::getSize(type.get())),
+                Assembler::addressMov(address(Assembler::AsmInstruction::QWORD)),
+                Assembler::AsmInstruction::IMPLICIT,
+                L"القراءة من عنوان"
+            ));
+            extend(type, target);
+            break;
+        }
+
+        case Op::STORE:{
+            auto address=instruction->operands[0];
+            auto value=instruction->operands[1];
+
+            // The value may be loaded to RAX, so the address is loaded to RCX
+            Register addressReg=Assembler::RCX;
+            if(isInRegister(address))
+                addressReg=registers[address];
+            else
+                move(addressReg, address);
+
+            auto reg=getValueRegister(value);
+            emit(Assembler::mov(
+                Assembler::addressMov(addressReg(Assembler::AsmInstruction::QWORD)),
+                reg(Type::getSize(value->type.get())),
+                Assembler::AsmInstruction::IMPLICIT,
+                L"الكتابة في عنوان"
+            ));
+            return;
+        }
+
+        case Op::CALL:
+            compileCall(instruction);
+            if(*type==*Type::VOID)
+                return;
+            extend(type, Assembler::RAX);
+            target=Assembler::RAX;
+            break;
+    }
+
+    setResult(instruction, target);
+}
+
+void IRCompiler::compileBinaryOp(IR::Instruction* instruction){
+    using Op=IR::Op;
+
+    auto op=instruction->op;
+    auto left=instruction->operands[0];
+    auto right=instruction->operands[1];
+    auto target=getResultRegister(instruction);
+
+    // Writing the left operand to the target shouldn't overwrite the right operand
+    if(
+        target!=Assembler::RAX
+        &&isInRegister(right)&&registers[right]==target
+        &&!(isInRegister(left)&&registers[left]==target)
+    ){
+        if(op==Op::SUB)
+            target=Assembler::RAX;
+        else
+            std::swap(left, right);
+    }
+
+    move(target, left);
+
+    auto d=target(Assembler::AsmInstruction::QWORD);
+    auto s=getSourceOperand(right);
+
+    switch(op){
+        case Op::ADD:
+            emit(Assembler::add(d, s));
+            break;
+        case Op::SUB:
+            emit(Assembler::sub(d, s));
+            break;
+        case Op::MUL:
+            if(right->op==Op::CONST){
+                move(Assembler::RCX, right);
+                s=Assembler::RCX();
+            }
+            emit(Assembler::imul(d, s));
+            break;
+        case Op::AND:
+            emit(Assembler::_and(d, s));
+            break;
+        case Op::OR:
+            emit(Assembler::_or(d, s));
+            break;
+        default:
+            emit(Assembler::_xor(d, s));
+            break;
+    }
+
+    // The extension of both operands is kept by the bitwise operations
+    if(op==Op::ADD||op==Op::SUB||op==Op::MUL)
+        extend(instruction->type, target);
+
+    setResult(instruction, target);
+}
+
+void IRCompiler::compileDivOrMod(IR::Instruction* instruction){
+    move(Assembler::RAX, instruction->operands[0]);
+    move(Assembler::RCX, instruction->operands[1]);
+
+    if(instruction->isUnsigned()){
+        emit(Assembler::zero(Assembler::RDX()));
+        emit(Assembler::div(Assembler::RCX()));
+    }
+    else{
+        emit(Assembler::cqo());
+        emit(Assembler::idiv(Assembler::RCX()));
+    }
+
+    if(instruction->op==IR::Op::MOD)
+        emit(Assembler::mov(Assembler::RAX(), Assembler::RDX()));
+
+    extend(instruction->type, Assembler::RAX);
+    setResult(instruction, Assembler::RAX);
+}
+
+void IRCompiler::compileShift(IR::Instruction* instruction){
+    auto type=instruction->type;
+    auto count=instruction->operands[1];
+    auto target=getResultRegister(instruction);
+
+    // The count is taken before the target is written, it may be in the same register
+    Assembler::AsmOperand k;
+    if(count->op==IR::Op::CONST)
+        k=Assembler::imm(std::to_wstring(count->imm&63));
+    else{
+        move(Assembler::RCX, count);
+        k=Assembler::RCX(Assembler::AsmInstruction::BYTE);
+    }
+
+    move(target, instruction->operands[0]);
+
+    if(instruction->op==IR::Op::SHL)
+        emit(Assembler::shl(target(Assembler::AsmInstruction::QWORD), k));
+    else{
+        // The shift is logical in the size of the type
+        zeroExtend(Type::getSize(type.get()), target);
+        emit(Assembler::shr(target(Assembler::AsmInstruction::QWORD), k));
+    }
+
+    extend(type, target);
+    setResult(instruction, target);
+}
+
+void IRCompiler::compileCall(IR::Instruction* instruction){
+    auto callee=instruction->callee;
+    auto paramsDecl=callee->getDecl()->params;
+    auto argsSize=compiler->getStackParamsSize(callee);
+    auto registerArgsSize=(CompilerVarsOffsetSetter::hasRegisterParams(callee))
+        ?std::min(instruction->operands.size(), CompilerVarsOffsetSetter::PARAMS_REGISTERS.size())
+        :0
+    ;
+
+    emit(Assembler::reserveSpaceOnStack(argsSize));
+
+    auto offset=argsSize;
+
+    for(int i=registerArgsSize;i<instruction->operands.size();i++){
+        auto arg=instruction->operands[i];
+        auto argSize=Type::getSize(arg->type.get());
+        offset-=argSize;
+        auto reg=getValueRegister(arg);
+        emit(Assembler::mov(
+            Assembler::addressMov(Assembler::RSP(), offset),
+            reg(argSize),
+            Assembler::AsmInstruction::IMPLICIT,
+            L"مُعامِل "+*(*paramsDecl)[i]->name
+        ));
+    }
+
+    if(registerArgsSize)
+        compileRegisterArgs(instruction);
+
+    auto builtInAsmIt=builtInsAsm.find(instruction);
+    if(builtInAsmIt!=builtInsAsm.end()){
+        emit(builtInAsmIt->second);
+        return; // It removes the args itself
+    }
+
+    std::wstring comment;
+    if(auto parentClass=BaseScope::toClassScope(callee->getParentScope()))
+        comment=L"استدعاء دالة "+parentClass->getName()+L"::"+callee->getDecl()->toString();
+    else
+        comment=L"استدعاء دالة "+callee->getDecl()->toString();
+
+    emit(Assembler::call(Assembler::label(compiler->labelsAsm.at(callee).label), comment));
+    emit(Assembler::removeReservedSpaceFromStack(argsSize));
+}
+
+void IRCompiler::compileRegisterArgs(IR::Instruction* instruction){
+    auto &argsRegisters=CompilerVarsOffsetSetter::PARAMS_REGISTERS;
+    auto registerArgsSize=std::min(instruction->operands.size(), argsRegisters.size());
+
+    // The values in registers are moved first, as the args registers may hold some of them
+    std::vector<std::pair<Register, Register>> moves;
+    for(int i=0;i<registerArgsSize;i++){
+        auto arg=instruction->operands[i];
+        if(isInRegister(arg))
+            moves.push_back({argsRegisters[i], registers[arg]});
+    }
+
+    emitParallelMoves(moves);
+
+    for(int i=0;i<registerArgsSize;i++){
+        auto arg=instruction->operands[i];
+        if(!isInRegister(arg))
+            move(argsRegisters[i], arg);
+    }
+}
+
+void IRCompiler::emitCompare(IR::Instruction* compare){
+    auto left=getValueRegister(compare->operands[0]);
+    emit(Assembler::cmp(left(Assembler::AsmInstruction::QWORD), getSourceOperand(compare->operands[1])));
+}
+
+void IRCompiler::emitParallelMoves(std::vector<std::pair<Register, Register>> moves){
+    moves.erase(
+        std::remove_if(moves.begin(), moves.end(), [](auto &move){return move.first==move.second;}),
+        moves.end()
+    );
+
+    while(!moves.empty()){
+
+        // A register that isn't read by the other moves can be written
+        auto moveIt=std::find_if(moves.begin(), moves.end(), [&](auto &move){
+            return std::none_of(moves.begin(), moves.end(), [&](auto &other){return other.second==move.first;});
+        });
+
+        if(moveIt!=moves.end()){
+            emit(Assembler::mov(moveIt->first(Assembler::AsmInstruction::QWORD), moveIt->second(Assembler::AsmInstruction::QWORD)));
+            moves.erase(moveIt);
+            continue;
+        }
+
+        // All the remaining moves are in cycles, the value of a register is kept in RAX to free it
+        auto reg=moves.front().first;
+        emit(Assembler::mov(Assembler::RAX(), reg(Assembler::AsmInstruction::QWORD)));
+        for(auto &move:moves){
+            if(move.second==reg)
+                move.second=Assembler::RAX;
+        }
+    }
+}
+
+void IRCompiler::compileCompare(IR::Instruction* instruction){
+    using Op=IR::Op;
+
+    emitCompare(instruction);
+
+    auto target=getResultRegister(instruction);
+    auto isUnsigned=instruction->operands[0]->isUnsigned();
+    auto low=target(Assembler::AsmInstruction::BYTE);
+
+    switch(instruction->op){
+        case Op::EQ: emit(Assembler::setz(low)); break;
+        case Op::NE: emit(Assembler::setnz(low)); break;
+        case Op::LT: emit((isUnsigned)?Assembler::setb(low):Assembler::setl(low)); break;
+        case Op::LE: emit((isUnsigned)?Assembler::setbe(low):Assembler::setle(low)); break;
+        case Op::GT: emit((isUnsigned)?Assembler::seta(low):Assembler::setg(low)); break;
+        default: emit((isUnsigned)?Assembler::setae(low):Assembler::setge(low)); break;
+    }
+
+    emit(Assembler::movzx(target(Assembler::AsmInstruction::DWORD), low));
+    setResult(instruction, target);
+}
+
+void IRCompiler::compilePhiCopies(IR::BasicBlock* from, IR::BasicBlock* to){
+    auto predIndex=to->getPredIndex(from);
+
+    std::vector<IR::Instruction*> phis;
+    for(auto instruction:to->instructions){
+        if(!instruction->isPhi())
+            break;
+        phis.push_back(instruction);
+    }
+
+    if(phis.empty())
+        return;
+
+    /*
+     * The copies happen at the same time, so a phi that is a source of another one is read before it's assigned.
+     * The other sources are live at the end of the pred, so they never share a location with the phis.
+    */
+    auto isParallel=false;
+    for(auto phi:phis){
+        auto source=phi->operands[predIndex];
+        if(source->isPhi()&&source->block==to&&source!=phi)
+            isParallel=true;
+    }
+
+    if(!isParallel){
+        for(auto phi:phis){
+            auto source=phi->operands[predIndex];
+            if(source==phi)
+                continue;
+            auto target=getResultRegister(phi);
+            move(target, source);
+            setResult(phi, target);
+        }
+        return;
+    }
+
+    for(auto phi:phis)
+        emit(Assembler::push(getValueRegister(phi->operands[predIndex])(Assembler::AsmInstruction::QWORD)));
+
+    for(auto phiIt=phis.rbegin();phiIt!=phis.rend();phiIt++){
+        auto target=getResultRegister(*phiIt);
+        emit(Assembler::pop(target(Assembler::AsmInstruction::QWORD)));
+        setResult(*phiIt, target);
+    }
+}
+
+void IRCompiler::compileBranch(IR::BasicBlock* block, IR::BasicBlock* next){
+    using Op=IR::Op;
+
+    auto condition=block->value;
+    auto trueTarget=block->targets[0];
+    auto falseTarget=block->targets[1];
+
+    auto op=Op::NE;
+    auto isUnsigned=false;
+
+    if(isFusedCompare(condition)){
+        emitCompare(condition);
+        op=condition->op;
+        isUnsigned=condition->operands[0]->isUnsigned();
+    }
+    else{
+        auto reg=getValueRegister(condition)(Assembler::AsmInstruction::QWORD);
+        emit(Assembler::test(reg, reg));
+    }
+
+    // Jumps to the true target unless it comes next
+    auto target=trueTarget;
+    auto otherTarget=falseTarget;
+    if(trueTarget==next){
+        target=falseTarget;
+        otherTarget=trueTarget;
+        switch(op){
+            case Op::EQ: op=Op::NE; break;
+            case Op::NE: op=Op::EQ; break;
+            case Op::LT: op=Op::GE; break;
+            case Op::LE: op=Op::GT; break;
+            case Op::GT: op=Op::LE; break;
+            default: op=Op::LT; break;
+        }
+    }
+
+    auto label=getBlockLabel(target);
+
+    switch(op){
+        case Op::EQ: emit(Assembler::jz(label)); break;
+        case Op::NE: emit(Assembler::jnz(label)); break;
+        case Op::LT: emit((isUnsigned)?Assembler::jb(label):Assembler::jl(label)); break;
+        case Op::LE: emit((isUnsigned)?Assembler::jbe(label):Assembler::jle(label)); break;
+        case Op::GT: emit((isUnsigned)?Assembler::ja(label):Assembler::jg(label)); break;
+        default: emit((isUnsigned)?Assembler::jae(label):Assembler::jge(label)); break;
+    }
+
+    if(otherTarget!=next)
+        emit(Assembler::jmp(getBlockLabel(otherTarget)));
+}
+
+void IRCompiler::compileReturn(IR::BasicBlock* block){
+    if(block->value)
+        move(Assembler::RAX, block->value);
+    else if(*fun->scope->getReturnType()==*Type::VOID)
+        emit(Assembler::zero(Assembler::RAX()));
+
+    for(auto &regSlot:savedRegisters)
+        emit(Assembler::mov(regSlot.first(Assembler::AsmInstruction::QWORD), Assembler::addressMov(Assembler::RBP(), regSlot.second)));
+
+    emit(Assembler::mov(Assembler::RSP(), Assembler::RBP()));
+    emit(Assembler::pop(Assembler::RBP()));
+    emit(Assembler::ret());
+}
+
+Assembler::AsmOperand IRCompiler::getBlockLabel(IR::BasicBlock* block){
+    return Assembler::label(L".bb"+std::to_wstring(block->id));
+}
+
+bool IRCompiler::isInRegister(IR::Instruction* value){
+    return registers.find(value)!=registers.end();
+}
+
+Assembler::AsmOperand IRCompiler::getLocation(IR::Instruction* value){
+    if(isInRegister(value))
+        return registers[value](Assembler::AsmInstruction::QWORD);
+    return Assembler::addressMov(Assembler::RBP(), slots[value]);
+}
+
+IRCompiler::Register IRCompiler::getResultRegister(IR::Instruction* value){
+    return (isInRegister(value))?registers[value]:Assembler::RAX;
+}
+
+IRCompiler::Register IRCompiler::getValueRegister(IR::Instruction* value){
+    if(isInRegister(value))
+        return registers[value];
+    move(Assembler::RAX, value);
+    return Assembler::RAX;
+}
+
+void IRCompiler::move(Register reg, IR::Instruction* value){
+    auto d=reg(Assembler::AsmInstruction::QWORD);
+
+    if(value->op==IR::Op::CONST){
+        if(value->imm==0)
+            emit(Assembler::zero(d));
+        else
+            emit(Assembler::mov(d, Assembler::imm(std::to_wstring(value->imm))));
+        return;
+    }
+
+    if(isInRegister(value)&&registers[value]==reg)
+        return;
+
+    emit(Assembler::mov(d, getLocation(value)));
+}
+
+Assembler::AsmOperand IRCompiler::getSourceOperand(IR::Instruction* value){
+    if(value->op!=IR::Op::CONST)
+        return getLocation(value);
+
+    // Only 32 bits imms are sign extended by the instructions
+    if(value->imm>=INT32_MIN&&value->imm<=INT32_MAX)
+        return Assembler::imm(std::to_wstring(value->imm));
+
+    move(Assembler::RCX, value);
+    return Assembler::RCX();
+}
+
+void IRCompiler::setResult(IR::Instruction* instruction, Register reg){
+    if(isInRegister(instruction)&&registers[instruction]==reg)
+        return;
+    emit(Assembler::mov(getLocation(instruction), reg(Assembler::AsmInstruction::QWORD)));
+}
+
+void IRCompiler::extend(SharedType type, Register reg){
+    auto size=Type::getSize(type.get());
+
+    if(size>=Assembler::AsmInstruction::QWORD)
+        return;
+
+    if(IR::isUnsignedType(type)){
+        zeroExtend(size, reg);
+        return;
+    }
+
+    if(size==Assembler::AsmInstruction::DWORD)
+        emit(Assembler::movsxd(reg(Assembler::AsmInstruction::QWORD), reg(size)));
+    else
+        emit(Assembler::movsx(reg(Assembler::AsmInstruction::QWORD), reg(size)));
+}
+
+void IRCompiler::zeroExtend(int size, Register reg){
+    auto d=reg(Assembler::AsmInstruction::DWORD);
+
+    if(size>=Assembler::AsmInstruction::QWORD)
+        return;
+
+    // Writing to the low 32 bits clears the upper half of the register
+    if(size==Assembler::AsmInstruction::DWORD)
+        emit(Assembler::mov(d, d));
+    else
+        emit(Assembler::movzx(d, reg(size)));
+}
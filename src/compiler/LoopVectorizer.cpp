@@ -0,0 +1,546 @@
+#include "LoopVectorizer.hpp"
+#include "Compiler.hpp"
+#include "ArrayClassScope.hpp"
+#include "AssignStatement.hpp"
+#include "AugmentedAssignStatement.hpp"
+#include "BuiltInFunScope.hpp"
+#include "ExpressionStatement.hpp"
+#include "LiteralExpression.hpp"
+#include "LoopScope.hpp"
+#include "NonStaticVarAccessExpression.hpp"
+#include "Type.hpp"
+#include "Variable.hpp"
+#include <algorithm>
+#include <string>
+
+using Assembler::AsmInstruction;
+
+const std::vector<Assembler::AsmOperand(*)(int size)> LoopVectorizer::ARRAY_REGISTERS={
+    Assembler::RSI, Assembler::RDI, Assembler::R8, Assembler::R9, Assembler::R10, Assembler::R11
+};
+
+LoopVectorizer::LoopVectorizer(Compiler* compiler, WhileStatement* stm, int loopNumber):
+    compiler(compiler),
+    stm(stm),
+    loopNumber(loopNumber),
+    isAvx2(compiler->isAvx2Enabled)
+{}
+
+bool LoopVectorizer::vectorize(){
+    if(!matchCondition())
+        return false;
+
+    auto loopScope=stm->getLoopScope();
+    auto stmList=loopScope->getStmList();
+    if(stmList->size()<2||!loopScope->getLocals()->empty()||!matchIncrement(stmList->back()))
+        return false;
+
+    // The invariants are known after finding all the assigned variables
+    assignedVars.insert(counter->getVar().get());
+    for(auto i=0;i<stmList->size()-1;i++)
+        if(auto assignStm=std::dynamic_pointer_cast<AssignStatement>(stmList->at(i)))
+            if(auto varEx=std::dynamic_pointer_cast<VarAccessExpression>(assignStm->getLeft()))
+                assignedVars.insert(varEx->getVar().get());
+
+    if(!isInvariant(limit.get()))
+        return false;
+
+    for(auto i=0;i<stmList->size()-1;i++)
+        if(!matchStatement(stmList->at(i)))
+            return false;
+
+    if(
+        arrays.size()>ARRAY_REGISTERS.size()
+        ||
+        invariants.size()+reductions.size()+tempsSize>REGISTERS_SIZE
+    )
+        return false;
+
+    auto loopNumStr=std::to_wstring(loopNumber);
+    auto vectorLoopLabelStr=L"vector_loop"+loopNumStr;
+    auto vectorEndLabelStr=L"vector_end"+loopNumStr;
+    auto elementsSize=std::to_wstring(getElementsPerVector());
+
+    // The registers of the invariants and the sums are taken from the end, the temps from the start
+    auto reg=REGISTERS_SIZE;
+    for(auto ex:invariants){
+        invariantRegisters[ex]=--reg;
+        ex->accept(compiler);
+        emitBroadcast(reg);
+    }
+
+    for(auto& reduction:reductions){
+        reduction.reg=--reg;
+        auto sum=getVectorRegister(reduction.reg);
+        emit(
+            isAvx2
+            ?Assembler::vpacked(AsmInstruction::VPXOR, sum, sum, sum, L"تصفير مجموع المتجه")
+            :Assembler::packed(AsmInstruction::PXOR, sum, sum, L"تصفير مجموع المتجه")
+        );
+    }
+
+    for(auto i=0;i<arrays.size();i++){
+        arrays[i]->accept(compiler);
+        emit(Assembler::mov(ARRAY_REGISTERS[i](AsmInstruction::QWORD), Assembler::RAX()));
+    }
+
+    limit->accept(compiler);
+    emit(Assembler::mov(Assembler::RDX(), Assembler::RAX()));
+    counter->accept(compiler);
+    emit(Assembler::mov(Assembler::RCX(), Assembler::RAX()));
+
+    emit(Assembler::localLabel(vectorLoopLabelStr));
+
+    // The remaining elements are computed without overflow because the counter is less than the limit
+    auto isUnsigned=*counter->getReturnType()==*Type::ULONG;
+    auto vectorEndLabel=Assembler::label(L"."+vectorEndLabelStr);
+    emit(Assembler::cmp(Assembler::RCX(), Assembler::RDX()));
+    emit(isUnsigned?Assembler::jae(vectorEndLabel):Assembler::jge(vectorEndLabel));
+    emit(Assembler::mov(Assembler::RAX(), Assembler::RDX()));
+    emit(Assembler::sub(Assembler::RAX(), Assembler::RCX()));
+    emit(Assembler::cmp(Assembler::RAX(), Assembler::imm(elementsSize), L"هل بقي متجه كامل"));
+    emit(Assembler::jb(vectorEndLabel));
+
+    for(auto& store:stores){
+        auto value=emitValue(store.second.get(), 0);
+        auto address=getElementAddress(store.first);
+        auto comment=L"تخصيص عناصر المصفوفة";
+        emit(
+            isAvx2
+            ?Assembler::vmovdqu(address, getVectorRegister(value.reg), comment)
+            :Assembler::movdqu(address, getVectorRegister(value.reg), comment)
+        );
+    }
+
+    for(auto& reduction:reductions){
+        auto value=emitValue(reduction.value.get(), 0);
+        auto sum=getVectorRegister(reduction.reg);
+        auto add=getPackedAdd();
+        if(isAvx2)
+            emit(Assembler::vpacked(
+                (AsmInstruction::InstructionType)(add-AsmInstruction::PADDB+AsmInstruction::VPADDB),
+                sum, sum, getVectorRegister(value.reg)
+            ));
+        else
+            emit(Assembler::packed(add, sum, getVectorRegister(value.reg)));
+    }
+
+    emit(Assembler::add(Assembler::RCX(), Assembler::imm(elementsSize)));
+    emit(Assembler::jmp(Assembler::label(L"."+vectorLoopLabelStr)));
+
+    emit(Assembler::localLabel(vectorEndLabelStr));
+    emit(Assembler::mov(
+        getVarAddress(counter->getVar().get()),
+        Assembler::RCX(),
+        AsmInstruction::IMPLICIT,
+        L"إكمال باقي العناصر من الحلقة العادية"
+    ));
+
+    if(isAvx2){
+        // The upper halves are added to the lower ones, then cleared to not slow down the SSE instructions after the loop
+        for(auto& reduction:reductions){
+            auto sum=Assembler::XMM(reduction.reg);
+            emit(Assembler::vextracti128(Assembler::XMM0(), Assembler::YMM(reduction.reg), 1));
+            emit(Assembler::vpacked(
+                (AsmInstruction::InstructionType)(getPackedAdd()-AsmInstruction::PADDB+AsmInstruction::VPADDB),
+                sum, sum, Assembler::XMM0()
+            ));
+        }
+        emit(Assembler::vzeroupper());
+    }
+
+    for(auto& reduction:reductions)
+        emitHorizontalSum(reduction);
+
+    return true;
+}
+
+bool LoopVectorizer::matchCondition(){
+    OperatorFunInvokeExpression* condition;
+    if(!isBuiltInOp(stm->getCondition().get(), condition)||condition->getOp()!=OperatorFunInvokeExpression::Operator::LESS)
+        return false;
+
+    counter=dynamic_cast<VarAccessExpression*>(condition->getInside().get());
+    if(!counter)
+        return false;
+
+    auto type=counter->getReturnType();
+    if(*type!=*Type::LONG&&*type!=*Type::ULONG)
+        return false;
+
+    limit=condition->getArgs()->at(0);
+    return *limit->getReturnType()==*type;
+}
+
+bool LoopVectorizer::matchIncrement(SharedIStatement stm){
+    if(auto exStm=std::dynamic_pointer_cast<ExpressionStatement>(stm)){
+        OperatorFunInvokeExpression* incEx;
+        if(!isBuiltInOp(exStm->getEx().get(), incEx))
+            return false;
+        auto op=incEx->getOp();
+        if(op!=OperatorFunInvokeExpression::Operator::PRE_INC&&op!=OperatorFunInvokeExpression::Operator::POST_INC)
+            return false;
+        auto varEx=dynamic_cast<VarAccessExpression*>(incEx->getInside().get());
+        return varEx&&varEx->getVar()==counter->getVar();
+    }
+
+    if(auto augStm=std::dynamic_pointer_cast<AugmentedAssignStatement>(stm)){
+        auto varEx=std::dynamic_pointer_cast<VarAccessExpression>(augStm->getLeft());
+        auto literal=std::dynamic_pointer_cast<LiteralExpression>(augStm->getRight());
+        return
+            augStm->getOp()==AugmentedAssignStatement::Operator::PLUS
+            &&
+            !augStm->isOpFunExplicit()
+            &&
+            std::dynamic_pointer_cast<BuiltInFunScope>(augStm->getOpFun())
+            &&
+            varEx&&varEx->getVar()==counter->getVar()
+            &&
+            literal&&literal->getValue()->toString()==L"1"
+        ;
+    }
+
+    return false;
+}
+
+bool LoopVectorizer::matchStatement(SharedIStatement stm){
+    // Setting an element at the counter
+    if(auto exStm=std::dynamic_pointer_cast<ExpressionStatement>(stm)){
+        OperatorFunInvokeExpression* setEx;
+        if(!isBuiltInOp(exStm->getEx().get(), setEx)||setEx->getOp()!=OperatorFunInvokeExpression::Operator::SET_EQUAL)
+            return false;
+
+        auto arrayEx=dynamic_cast<VarAccessExpression*>(setEx->getInside().get());
+        auto indexEx=std::dynamic_pointer_cast<VarAccessExpression>(setEx->getArgs()->at(0));
+        if(!arrayEx||!indexEx||indexEx->getVar()!=counter->getVar()||assignedVars.count(arrayEx->getVar().get()))
+            return false;
+
+        auto arrayType=arrayEx->getReturnType()->asArray();
+        auto value=setEx->getArgs()->at(1);
+        if(!arrayType||!matchElementType(arrayType->getType()))
+            return false;
+
+        auto temps=matchValue(value);
+        if(temps<0)
+            return false;
+
+        tempsSize=std::max(tempsSize, temps);
+        addArray(arrayEx);
+        stores.push_back({arrayEx->getVar().get(), value});
+        return true;
+    }
+
+    // Adding to an integer variable, as "م+=ع" or "م=م+ع"
+    auto assignStm=std::dynamic_pointer_cast<AssignStatement>(stm);
+    if(!assignStm)
+        return false;
+
+    auto varEx=std::dynamic_pointer_cast<VarAccessExpression>(assignStm->getLeft());
+    if(!varEx)
+        return false;
+    auto var=varEx->getVar().get();
+
+    SharedIExpression value;
+    if(auto augStm=std::dynamic_pointer_cast<AugmentedAssignStatement>(stm)){
+        if(
+            augStm->getOp()!=AugmentedAssignStatement::Operator::PLUS
+            ||
+            augStm->isOpFunExplicit()
+            ||
+            !std::dynamic_pointer_cast<BuiltInFunScope>(augStm->getOpFun())
+        )
+            return false;
+        value=augStm->getRight();
+    }
+    else{
+        OperatorFunInvokeExpression* plusEx;
+        if(!isBuiltInOp(assignStm->getRight().get(), plusEx)||plusEx->getOp()!=OperatorFunInvokeExpression::Operator::PLUS)
+            return false;
+        auto leftEx=dynamic_cast<VarAccessExpression*>(plusEx->getInside().get());
+        if(!leftEx||leftEx->getVar().get()!=var)
+            return false;
+        value=plusEx->getArgs()->at(0);
+    }
+
+    // The floating point sums would be reordered, so they give different results
+    if(!matchElementType(varEx->getReturnType())||*elementType==*Type::FLOAT||*elementType==*Type::DOUBLE)
+        return false;
+
+    for(auto& reduction:reductions)
+        if(reduction.var==var)
+            return false;
+
+    auto temps=matchValue(value);
+    if(temps<0)
+        return false;
+
+    tempsSize=std::max(tempsSize, temps);
+    reductions.push_back(Reduction{var, value, -1});
+    return true;
+}
+
+bool LoopVectorizer::matchElementType(SharedType type){
+    if(elementType)
+        return *type==*elementType;
+
+    for(auto supported:{
+        Type::BYTE, Type::UBYTE, Type::SHORT, Type::USHORT, Type::INT, Type::UINT,
+        Type::LONG, Type::ULONG, Type::FLOAT, Type::DOUBLE
+    })
+        if(*type==*supported){
+            elementType=type;
+            return true;
+        }
+    return false;
+}
+
+int LoopVectorizer::matchValue(SharedIExpression ex){
+    if(*ex->getReturnType()!=*elementType)
+        return -1;
+
+    if(isInvariant(ex.get())){
+        invariants.push_back(ex.get());
+        return 0;
+    }
+
+    VarAccessExpression* array;
+    if(isArrayAtCounter(ex.get(), array)){
+        addArray(array);
+        return 1;
+    }
+
+    OperatorFunInvokeExpression* opEx;
+    if(!isBuiltInOp(ex.get(), opEx)||opEx->getArgs()->size()!=1||getPackedOp(opEx)==AsmInstruction::NOP)
+        return -1;
+
+    auto leftTemps=matchValue(opEx->getInside());
+    auto rightTemps=matchValue(opEx->getArgs()->at(0));
+    if(leftTemps<0||rightTemps<0)
+        return -1;
+
+    // The left is evaluated in the first temp and the right after it
+    return std::max({leftTemps, 1, rightTemps+1});
+}
+
+bool LoopVectorizer::isInvariant(IExpression* ex){
+    if(dynamic_cast<LiteralExpression*>(ex))
+        return true;
+
+    if(auto varEx=dynamic_cast<VarAccessExpression*>(ex))
+        return !assignedVars.count(varEx->getVar().get());
+
+    // The capacity of an array that isn't changed
+    if(auto varEx=dynamic_cast<NonStaticVarAccessExpression*>(ex))
+        return
+            *varEx->getVar()->getName()==*ArrayClassScope::CAPACITY_NAME
+            &&
+            varEx->getInside()->getReturnType()->asArray()
+            &&
+            isInvariant(varEx->getInside().get())
+        ;
+
+    return false;
+}
+
+bool LoopVectorizer::isArrayAtCounter(IExpression* ex, VarAccessExpression*& array){
+    OperatorFunInvokeExpression* getEx;
+    if(!isBuiltInOp(ex, getEx)||getEx->getOp()!=OperatorFunInvokeExpression::Operator::GET)
+        return false;
+
+    array=dynamic_cast<VarAccessExpression*>(getEx->getInside().get());
+    auto indexEx=std::dynamic_pointer_cast<VarAccessExpression>(getEx->getArgs()->at(0));
+    return
+        array&&array->getReturnType()->asArray()&&!assignedVars.count(array->getVar().get())
+        &&
+        indexEx&&indexEx->getVar()==counter->getVar()
+    ;
+}
+
+bool LoopVectorizer::isBuiltInOp(IExpression* ex, OperatorFunInvokeExpression*& opEx){
+    opEx=dynamic_cast<OperatorFunInvokeExpression*>(ex);
+    return
+        opEx
+        &&
+        std::dynamic_pointer_cast<BuiltInFunScope>(opEx->getFun())
+        &&
+        *opEx->getInside()->getReturnType()!=*Type::STRING
+    ;
+}
+
+void LoopVectorizer::addArray(VarAccessExpression* array){
+    for(auto added:arrays)
+        if(added->getVar()==array->getVar())
+            return;
+    arrays.push_back(array);
+}
+
+void LoopVectorizer::emit(Assembler::AsmInstruction instruction){
+    *compiler->currentAsmLabel+=instruction;
+}
+
+void LoopVectorizer::emitBroadcast(int reg){
+    auto size=getElementSize();
+    auto comment=L"نسخ القيمة لكل عناصر المتجه";
+
+    // The bytes and the words are repeated in a dword first
+    if(size<4){
+        emit(Assembler::movzx(Assembler::RAX(AsmInstruction::DWORD), Assembler::RAX(size)));
+        emit(Assembler::mov(Assembler::RCX(AsmInstruction::DWORD), Assembler::imm((size==1)?L"0x01010101":L"0x00010001")));
+        emit(Assembler::imul(Assembler::RAX(AsmInstruction::DWORD), Assembler::RCX(AsmInstruction::DWORD)));
+    }
+
+    auto xmm=Assembler::XMM(reg);
+    if(size==8)
+        emit(Assembler::movq(xmm, Assembler::RAX()));
+    else
+        emit(Assembler::movd(xmm, Assembler::RAX(AsmInstruction::DWORD)));
+
+    if(isAvx2)
+        emit(
+            (size==8)
+            ?Assembler::vpbroadcastq(Assembler::YMM(reg), xmm, comment)
+            :Assembler::vpbroadcastd(Assembler::YMM(reg), xmm, comment)
+        );
+    else
+        emit(Assembler::pshufd(xmm, xmm, (size==8)?0x44:0, comment));
+}
+
+LoopVectorizer::Value LoopVectorizer::emitValue(IExpression* ex, int temp){
+    auto invariantIt=invariantRegisters.find(ex);
+    if(invariantIt!=invariantRegisters.end())
+        return Value{invariantIt->second, false};
+
+    VarAccessExpression* array;
+    if(isArrayAtCounter(ex, array)){
+        auto address=getElementAddress(array->getVar().get());
+        auto comment=L"قراءة عناصر المصفوفة";
+        emit(
+            isAvx2
+            ?Assembler::vmovdqu(getVectorRegister(temp), address, comment)
+            :Assembler::movdqu(getVectorRegister(temp), address, comment)
+        );
+        return Value{temp, true};
+    }
+
+    auto opEx=dynamic_cast<OperatorFunInvokeExpression*>(ex);
+    auto op=getPackedOp(opEx);
+    auto left=emitValue(opEx->getInside().get(), temp);
+    // The SSE operations change their first operand
+    if(!isAvx2&&!left.isTemp){
+        emit(Assembler::movdqa(getVectorRegister(temp), getVectorRegister(left.reg)));
+        left=Value{temp, true};
+    }
+    auto right=emitValue(opEx->getArgs()->at(0).get(), temp+1);
+
+    if(isAvx2)
+        emit(Assembler::vpacked(
+            (AsmInstruction::InstructionType)(op-AsmInstruction::PADDB+AsmInstruction::VPADDB),
+            getVectorRegister(temp), getVectorRegister(left.reg), getVectorRegister(right.reg)
+        ));
+    else
+        emit(Assembler::packed(op, getVectorRegister(temp), getVectorRegister(right.reg)));
+
+    return Value{temp, true};
+}
+
+void LoopVectorizer::emitHorizontalSum(Reduction& reduction){
+    auto size=getElementSize();
+    auto add=getPackedAdd();
+    auto sum=Assembler::XMM(reduction.reg);
+    auto temp=Assembler::XMM0();
+
+    // The halves are added until the sum is in the lowest dword or qword
+    emit(Assembler::pshufd(temp, sum, 0x4E, L"جمع عناصر المتجه"));
+    emit(Assembler::packed(add, sum, temp));
+    if(size==8)
+        emit(Assembler::movq(Assembler::RAX(), sum));
+    else{
+        emit(Assembler::pshufd(temp, sum, 0xB1));
+        emit(Assembler::packed(add, sum, temp));
+        // Words and bytes are added as packed lanes, so a lane's carry doesn't spill into the next one
+        for(auto shift=2;shift>=size;shift/=2){
+            emit(Assembler::movdqa(temp, sum));
+            emit(Assembler::psrldq(temp, shift));
+            emit(Assembler::packed(add, sum, temp));
+        }
+        emit(Assembler::movd(Assembler::RAX(AsmInstruction::DWORD), sum));
+    }
+
+    emit(Assembler::add(
+        getVarAddress(reduction.var),
+        Assembler::RAX(size),
+        AsmInstruction::IMPLICIT,
+        L"إضافة مجموع المتجه للمتغير "+*reduction.var->getName()
+    ));
+}
+
+int LoopVectorizer::getElementSize(){
+    return Type::getSize(elementType.get());
+}
+
+int LoopVectorizer::getElementsPerVector(){
+    return (isAvx2?32:16)/getElementSize();
+}
+
+Assembler::AsmOperand LoopVectorizer::getVectorRegister(int reg){
+    return isAvx2?Assembler::YMM(reg):Assembler::XMM(reg);
+}
+
+Assembler::AsmOperand LoopVectorizer::getElementAddress(Variable* array){
+    auto index=0;
+    while(arrays[index]->getVar().get()!=array)
+        index++;
+    return Assembler::addressLea(
+        ARRAY_REGISTERS[index](AsmInstruction::QWORD).value
+        +L"+8+"+Assembler::RCX().value+L"*"+std::to_wstring(getElementSize())
+    );
+}
+
+Assembler::AsmOperand LoopVectorizer::getVarAddress(Variable* var){
+    auto offset=compiler->offsets[var];
+    if(offset.reg.value.find(L"var")==0)
+        compiler->useGlobalVariable(var);
+    return Assembler::addressMov(offset.reg, offset.value);
+}
+
+AsmInstruction::InstructionType LoopVectorizer::getPackedOp(OperatorFunInvokeExpression* ex){
+    auto isDouble=*elementType==*Type::DOUBLE;
+    if(isDouble||*elementType==*Type::FLOAT){
+        switch(ex->getOp()){
+            case OperatorFunInvokeExpression::Operator::PLUS:
+                return isDouble?AsmInstruction::ADDPD:AsmInstruction::ADDPS;
+            case OperatorFunInvokeExpression::Operator::MINUS:
+                return isDouble?AsmInstruction::SUBPD:AsmInstruction::SUBPS;
+            case OperatorFunInvokeExpression::Operator::TIMES:
+                return isDouble?AsmInstruction::MULPD:AsmInstruction::MULPS;
+            case OperatorFunInvokeExpression::Operator::DIV:
+                return isDouble?AsmInstruction::DIVPD:AsmInstruction::DIVPS;
+            default:
+                return AsmInstruction::NOP;
+        }
+    }
+
+    switch(ex->getOp()){
+        case OperatorFunInvokeExpression::Operator::PLUS:
+            return getPackedAdd();
+        case OperatorFunInvokeExpression::Operator::MINUS:
+            return (AsmInstruction::InstructionType)(getPackedAdd()-AsmInstruction::PADDB+AsmInstruction::PSUBB);
+        case OperatorFunInvokeExpression::Operator::BIT_AND:
+            return AsmInstruction::PAND;
+        case OperatorFunInvokeExpression::Operator::BIT_OR:
+            return AsmInstruction::POR;
+        case OperatorFunInvokeExpression::Operator::XOR:
+            return AsmInstruction::PXOR;
+        default:
+            return AsmInstruction::NOP;
+    }
+}
+
+AsmInstruction::InstructionType LoopVectorizer::getPackedAdd(){
+    switch(getElementSize()){
+        case 1: return AsmInstruction::PADDB;
+        case 2: return AsmInstruction::PADDW;
+        case 4: return AsmInstruction::PADDD;
+        default: return AsmInstruction::PADDQ;
+    }
+}
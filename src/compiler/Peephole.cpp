@@ -0,0 +1,426 @@
+#include "Peephole.hpp"
+#include <algorithm>
+#include <cwctype>
+#include <unordered_map>
+#include <utility>
+
+namespace Peephole {
+
+    using Assembler::AsmInstruction;
+    using Assembler::AsmOperand;
+    using Instructions=std::vector<AsmInstruction>;
+
+    namespace {
+
+        using Register=AsmOperand(*)(int size);
+
+        // Each name of a general purpose register with its 64 bits register and its size
+        const std::unordered_map<std::wstring, std::pair<std::wstring, int>>& getRegisters(){
+            static const auto registers=[]{
+                std::unordered_map<std::wstring, std::pair<std::wstring, int>> registers;
+                Register families[]={
+                    Assembler::RAX, Assembler::RBX, Assembler::RCX, Assembler::RDX,
+                    Assembler::RDI, Assembler::RSI, Assembler::RSP, Assembler::RBP,
+                    Assembler::R8, Assembler::R9, Assembler::R10, Assembler::R11,
+                    Assembler::R12, Assembler::R13, Assembler::R14, Assembler::R15,
+                };
+                for(auto reg:families){
+                    auto family=reg(AsmInstruction::QWORD).value;
+                    for(auto size:{AsmInstruction::BYTE, AsmInstruction::WORD, AsmInstruction::DWORD, AsmInstruction::QWORD})
+                        registers[reg(size).value]={family, size};
+                }
+                return registers;
+            }();
+            return registers;
+        }
+
+        bool isRegister(AsmOperand operand){
+            return operand.type==AsmOperand::REG&&!getRegisterFamily(operand.value).empty();
+        }
+
+        // Writing 32 bits to a register clears its upper half, so only the other sizes can be skipped when the value is the same
+        bool isKeepingUpperBits(AsmOperand reg){
+            return getRegisterSize(reg.value)!=AsmInstruction::DWORD;
+        }
+
+        bool isJump(AsmInstruction& instruction){
+            return instruction.type>=AsmInstruction::JMP&&instruction.type<=AsmInstruction::JBE;
+        }
+
+        bool isMove(AsmInstruction& instruction){
+            switch(instruction.type){
+                case AsmInstruction::MOV:
+                case AsmInstruction::MOVSX:
+                case AsmInstruction::MOVZX:
+                case AsmInstruction::MOVSXD:
+                case AsmInstruction::LEA:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // The instructions that don't use any register or memory other than their operands
+        bool isSimple(AsmInstruction& instruction){
+            switch(instruction.type){
+                case AsmInstruction::MOV:
+                case AsmInstruction::MOVSX:
+                case AsmInstruction::MOVZX:
+                case AsmInstruction::MOVSXD:
+                case AsmInstruction::LEA:
+                case AsmInstruction::ADD:
+                case AsmInstruction::SUB:
+                case AsmInstruction::BSR:
+                case AsmInstruction::BSF:
+                case AsmInstruction::XOR:
+                case AsmInstruction::OR:
+                case AsmInstruction::AND:
+                case AsmInstruction::SHR:
+                case AsmInstruction::SHL:
+                case AsmInstruction::CMP:
+                case AsmInstruction::TEST:
+                case AsmInstruction::INC:
+                case AsmInstruction::DEC:
+                case AsmInstruction::NEG:
+                case AsmInstruction::NOT:
+                case AsmInstruction::SETZ:
+                case AsmInstruction::SETNZ:
+                case AsmInstruction::SETS:
+                case AsmInstruction::SETNS:
+                case AsmInstruction::SETG:
+                case AsmInstruction::SETGE:
+                case AsmInstruction::SETL:
+                case AsmInstruction::SETLE:
+                case AsmInstruction::SETA:
+                case AsmInstruction::SETAE:
+                case AsmInstruction::SETB:
+                case AsmInstruction::SETBE:
+                case AsmInstruction::CMOVZ:
+                case AsmInstruction::CMOVNZ:
+                case AsmInstruction::CMOVS:
+                case AsmInstruction::CMOVG:
+                    return true;
+                case AsmInstruction::IMUL:
+                    return instruction.operands.size()==2;
+                default:
+                    return false;
+            }
+        }
+
+        bool isWritingOperand(AsmInstruction& instruction){
+            return instruction.type!=AsmInstruction::CMP&&instruction.type!=AsmInstruction::TEST;
+        }
+
+        bool isUsingRegister(AsmInstruction& instruction, std::wstring family){
+            return std::any_of(
+                instruction.operands.begin(),
+                instruction.operands.end(),
+                [&](auto& operand){return Peephole::isUsingRegister(operand, family);}
+            );
+        }
+
+        bool isWritingRegister(AsmInstruction& instruction, std::wstring family){
+            return isWritingOperand(instruction)
+                &&isRegister(instruction.operands[0])
+                &&getRegisterFamily(instruction.operands[0].value)==family
+            ;
+        }
+
+        bool isWritingMemory(AsmInstruction& instruction){
+            return isWritingOperand(instruction)&&instruction.operands[0].type==AsmOperand::ADDRESSING;
+        }
+
+        // Whether the flags are set again before any instruction reads them, starting from the index
+        bool areFlagsDead(Instructions& instructions, int index){
+            for(auto i=index;i<(int)instructions.size();i++){
+                switch(instructions[i].type){
+                    case AsmInstruction::ADD:
+                    case AsmInstruction::SUB:
+                    case AsmInstruction::XOR:
+                    case AsmInstruction::OR:
+                    case AsmInstruction::AND:
+                    case AsmInstruction::CMP:
+                    case AsmInstruction::TEST:
+                    case AsmInstruction::NEG:
+                    case AsmInstruction::CALL:
+                    case AsmInstruction::RET:
+                    case AsmInstruction::SYSCALL:
+                        return true;
+                    case AsmInstruction::MOV:
+                    case AsmInstruction::MOVSX:
+                    case AsmInstruction::MOVZX:
+                    case AsmInstruction::MOVSXD:
+                    case AsmInstruction::LEA:
+                    case AsmInstruction::PUSH:
+                    case AsmInstruction::POP:
+                    case AsmInstruction::NOT:
+                    // The flags set before the label are read only by the instructions after it
+                    case AsmInstruction::LOCAL_LABEL:
+                        continue;
+                    default:
+                        return false;
+                }
+            }
+            return false;
+        }
+
+        std::wstring getComment(AsmInstruction& first, AsmInstruction& second){
+            return (first.comment.empty())?second.comment:first.comment;
+        }
+
+    }
+
+    const std::vector<Pattern> PATTERNS={
+        // push X, pop Y -> mov Y, X
+        {
+            .name=L"push_pop",
+            .size=2,
+            .matches=[](Instructions& instructions, int index){
+                auto& push=instructions[index];
+                auto& pop=instructions[index+1];
+                return push.type==AsmInstruction::PUSH&&pop.type==AsmInstruction::POP
+                    &&isRegister(push.operands[0])&&isRegister(pop.operands[0])
+                ;
+            },
+            .rewrite=[](Instructions& instructions, int index)->Instructions{
+                auto& push=instructions[index];
+                auto& pop=instructions[index+1];
+                if(push.operands[0].value==pop.operands[0].value)
+                    return {};
+                return {Assembler::mov(pop.operands[0], push.operands[0], AsmInstruction::IMPLICIT, getComment(push, pop))};
+            }
+        },
+        // Moves a pop up to the push of its value through the instructions that don't use the stack or the popped register
+        {
+            .name=L"hoist_pop",
+            .size=2,
+            .matches=[](Instructions& instructions, int index){
+                auto& instruction=instructions[index];
+                auto& pop=instructions[index+1];
+                if(pop.type!=AsmInstruction::POP||!isRegister(pop.operands[0])||!isSimple(instruction))
+                    return false;
+                auto popped=getRegisterFamily(pop.operands[0].value);
+                return !isUsingRegister(instruction, Assembler::RSP().value)
+                    &&!isUsingRegister(instruction, popped)
+                    &&!isWritingMemory(instruction)
+                ;
+            },
+            .rewrite=[](Instructions& instructions, int index)->Instructions{
+                return {instructions[index+1], instructions[index]};
+            }
+        },
+        // Moves a push down to the pop of its value through the instructions that don't use the stack or change the pushed register
+        {
+            .name=L"sink_push",
+            .size=2,
+            .matches=[](Instructions& instructions, int index){
+                auto& push=instructions[index];
+                auto& instruction=instructions[index+1];
+                if(push.type!=AsmInstruction::PUSH||!isRegister(push.operands[0])||!isSimple(instruction))
+                    return false;
+                auto pushed=getRegisterFamily(push.operands[0].value);
+                return !isUsingRegister(instruction, Assembler::RSP().value)
+                    &&!isWritingRegister(instruction, pushed)
+                ;
+            },
+            .rewrite=[](Instructions& instructions, int index)->Instructions{
+                return {instructions[index+1], instructions[index]};
+            }
+        },
+        // mov R, R
+        {
+            .name=L"self_move",
+            .size=1,
+            .matches=[](Instructions& instructions, int index){
+                auto& mov=instructions[index];
+                return mov.type==AsmInstruction::MOV
+                    &&isRegister(mov.operands[0])
+                    &&mov.operands[0].value==mov.operands[1].value
+                    &&isKeepingUpperBits(mov.operands[0])
+                ;
+            },
+            .rewrite=[](Instructions& instructions, int index)->Instructions{
+                return {};
+            }
+        },
+        // mov [m], R, mov R, [m] -> mov [m], R
+        {
+            .name=L"reload_after_store",
+            .size=2,
+            .matches=[](Instructions& instructions, int index){
+                auto& store=instructions[index];
+                auto& load=instructions[index+1];
+                return store.type==AsmInstruction::MOV&&load.type==AsmInstruction::MOV
+                    &&store.size==load.size
+                    &&store.operands[0].type==AsmOperand::ADDRESSING&&isRegister(store.operands[1])
+                    &&load.operands[0].value==store.operands[1].value
+                    &&load.operands[1].value==store.operands[0].value
+                    &&isKeepingUpperBits(load.operands[0])
+                ;
+            },
+            .rewrite=[](Instructions& instructions, int index)->Instructions{
+                return {instructions[index]};
+            }
+        },
+        // mov R, [m], mov [m], R -> mov R, [m]
+        {
+            .name=L"store_after_load",
+            .size=2,
+            .matches=[](Instructions& instructions, int index){
+                auto& load=instructions[index];
+                auto& store=instructions[index+1];
+                return load.type==AsmInstruction::MOV&&store.type==AsmInstruction::MOV
+                    &&store.size==load.size
+                    &&isRegister(load.operands[0])&&load.operands[1].type==AsmOperand::ADDRESSING
+                    &&store.operands[0].value==load.operands[1].value
+                    &&store.operands[1].value==load.operands[0].value
+                    &&!isUsingRegister(load.operands[1], getRegisterFamily(load.operands[0].value))
+                ;
+            },
+            .rewrite=[](Instructions& instructions, int index)->Instructions{
+                return {instructions[index]};
+            }
+        },
+        // mov R, X, mov R, Y -> mov R, Y when Y doesn't use R
+        {
+            .name=L"overwritten_move",
+            .size=2,
+            .matches=[](Instructions& instructions, int index){
+                auto& first=instructions[index];
+                auto& second=instructions[index+1];
+                if(!isMove(first)||!isMove(second)||!isRegister(first.operands[0])||!isRegister(second.operands[0]))
+                    return false;
+                auto family=getRegisterFamily(first.operands[0].value);
+                return getRegisterFamily(second.operands[0].value)==family
+                    &&getRegisterSize(second.operands[0].value)>=AsmInstruction::DWORD
+                    &&!isUsingRegister(second.operands[1], family)
+                ;
+            },
+            .rewrite=[](Instructions& instructions, int index)->Instructions{
+                return {instructions[index+1]};
+            }
+        },
+        // jmp .L, .L:
+        {
+            .name=L"jump_to_next",
+            .size=2,
+            .matches=[](Instructions& instructions, int index){
+                auto& jump=instructions[index];
+                auto& label=instructions[index+1];
+                return isJump(jump)&&label.type==AsmInstruction::LOCAL_LABEL
+                    &&label.operands[0].value==jump.operands[0].value+L":"
+                ;
+            },
+            .rewrite=[](Instructions& instructions, int index)->Instructions{
+                return {instructions[index+1]};
+            }
+        },
+        // A cmp or a test whose flags aren't read, like the capacity check of an array access after its jump is removed
+        {
+            .name=L"dead_compare",
+            .size=1,
+            .matches=[](Instructions& instructions, int index){
+                auto& compare=instructions[index];
+                return (compare.type==AsmInstruction::CMP||compare.type==AsmInstruction::TEST)
+                    &&areFlagsDead(instructions, index+1)
+                ;
+            },
+            .rewrite=[](Instructions& instructions, int index)->Instructions{
+                return {};
+            }
+        },
+        // The instructions after a jmp or a ret that are reached only through a label
+        {
+            .name=L"unreachable",
+            .size=2,
+            .matches=[](Instructions& instructions, int index){
+                auto& jump=instructions[index];
+                auto& instruction=instructions[index+1];
+                return (jump.type==AsmInstruction::JMP||jump.type==AsmInstruction::RET)
+                    &&instruction.type!=AsmInstruction::LOCAL_LABEL
+                    &&instruction.type!=AsmInstruction::INLINE_ASM
+                ;
+            },
+            .rewrite=[](Instructions& instructions, int index)->Instructions{
+                return {instructions[index]};
+            }
+        },
+        // add RSP, n, mov RSP, RBP -> mov RSP, RBP
+        {
+            .name=L"stack_pointer_reset",
+            .size=2,
+            .matches=[](Instructions& instructions, int index){
+                auto& adjust=instructions[index];
+                auto& reset=instructions[index+1];
+                return (adjust.type==AsmInstruction::ADD||adjust.type==AsmInstruction::SUB)
+                    &&adjust.operands[0].value==Assembler::RSP().value
+                    &&reset.type==AsmInstruction::MOV
+                    &&reset.operands[0].value==Assembler::RSP().value
+                    &&reset.operands[1].value==Assembler::RBP().value
+                    &&areFlagsDead(instructions, index+2)
+                ;
+            },
+            .rewrite=[](Instructions& instructions, int index)->Instructions{
+                return {instructions[index+1]};
+            }
+        },
+    };
+
+    void optimize(Assembler::AsmLabel* label){
+        auto& instructions=label->instructions;
+        auto changed=true;
+        while(changed){
+            changed=false;
+            for(auto index=0;index<(int)instructions.size();){
+                auto pattern=std::find_if(PATTERNS.begin(), PATTERNS.end(), [&](const Pattern& pattern){
+                    return index+pattern.size<=(int)instructions.size()&&pattern.matches(instructions, index);
+                });
+
+                if(pattern==PATTERNS.end()){
+                    index++;
+                    continue;
+                }
+
+                auto replacement=pattern->rewrite(instructions, index);
+                instructions.erase(instructions.begin()+index, instructions.begin()+index+pattern->size);
+                instructions.insert(instructions.begin()+index, replacement.begin(), replacement.end());
+                changed=true;
+
+                // The previous instruction may make a pattern with the new ones
+                index=std::max(0, index-1);
+            }
+        }
+    }
+
+    std::wstring getRegisterFamily(std::wstring reg){
+        auto& registers=getRegisters();
+        auto regIt=registers.find(reg);
+        return (regIt!=registers.end())?regIt->second.first:L"";
+    }
+
+    int getRegisterSize(std::wstring reg){
+        auto& registers=getRegisters();
+        auto regIt=registers.find(reg);
+        return (regIt!=registers.end())?regIt->second.second:0;
+    }
+
+    bool isUsingRegister(AsmOperand operand, std::wstring family){
+        if(operand.type==AsmOperand::REG)
+            return getRegisterFamily(operand.value)==family;
+        if(operand.type!=AsmOperand::ADDRESSING)
+            return false;
+
+        std::wstring name;
+        for(auto c:operand.value+L" "){
+            if(std::iswalnum(c)){
+                name+=c;
+                continue;
+            }
+            if(!name.empty()&&getRegisterFamily(name)==family)
+                return true;
+            name.clear();
+        }
+        return false;
+    }
+
+}
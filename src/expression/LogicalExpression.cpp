@@ -27,4 +27,12 @@ SharedIExpression LogicalExpression::getRight()const{
 
 LogicalExpression::Operation LogicalExpression::getLogicalOp()const{
     return logicalOp;
+}
+
+void LogicalExpression::setLeft(SharedIExpression left){
+    this->left=left;
+}
+
+void LogicalExpression::setRight(SharedIExpression right){
+    this->right=right;
 }
\ No newline at end of file
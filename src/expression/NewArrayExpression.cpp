@@ -17,6 +17,20 @@ NewArrayExpression::NewArrayExpression(
     this->returnType=initReturnType;
 }
 
+NewArrayExpression::NewArrayExpression(
+    int lineNumber,
+    SharedType type,
+    SharedVector<SharedIExpression>values
+):IExpression(lineNumber,std::make_shared<Type::Array>(type, true)),values(values){}
+
 std::vector<SharedIExpression> NewArrayExpression::getCapacities()const{
     return this->capacities;
+}
+
+SharedVector<SharedIExpression> NewArrayExpression::getValues()const{
+    return this->values;
+}
+
+bool NewArrayExpression::isConstant()const{
+    return this->values!=nullptr;
 }
\ No newline at end of file
@@ -21,6 +21,10 @@ SharedIExpression NonStaticFunInvokeExpression::getInside()const{
     return inside;
 }
 
+void NonStaticFunInvokeExpression::setInside(SharedIExpression inside){
+    this->inside=inside;
+}
+
 SharedVector<SharedIExpression> NonStaticFunInvokeExpression::getArgs()const{
     return args;
 }
@@ -31,4 +35,12 @@ SharedFunScope NonStaticFunInvokeExpression::getFun()const{
 
 void NonStaticFunInvokeExpression::setFun(SharedFunScope fun){
     this->fun=fun;
+}
+
+BuiltInFunScope* NonStaticFunInvokeExpression::getBuiltInFun()const{
+    return builtInFun;
+}
+
+void NonStaticFunInvokeExpression::setBuiltInFun(BuiltInFunScope* builtInFun){
+    this->builtInFun=builtInFun;
 }
\ No newline at end of file
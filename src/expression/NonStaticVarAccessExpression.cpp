@@ -17,10 +17,22 @@ SharedIExpression NonStaticVarAccessExpression::getInside()const{
     return inside;
 }
 
+void NonStaticVarAccessExpression::setInside(SharedIExpression inside){
+    this->inside=inside;
+}
+
 SharedVariable NonStaticVarAccessExpression::getVar()const{
     return var;
 }
 
 void NonStaticVarAccessExpression::setVar(SharedVariable var){
     this->var=var;
+}
+
+int NonStaticVarAccessExpression::getSlotOffset()const{
+    return slotOffset;
+}
+
+void NonStaticVarAccessExpression::setSlotOffset(int offset){
+    this->slotOffset=offset;
 }
\ No newline at end of file
@@ -28,6 +28,10 @@ SharedIExpression SetOperatorExpression::getValueEx()const{
     return this->valueEx;
 }
 
+void SetOperatorExpression::setValueEx(SharedIExpression valueEx){
+    this->valueEx=valueEx;
+}
+
 SharedFunScope SetOperatorExpression::getFunOfSet()const {
     return this->funOfSet;
 }
@@ -23,4 +23,17 @@ SharedVariable ThisVarAccessExpression::getVar()const{
 
 void ThisVarAccessExpression::setVar(SharedVariable var){
     this->var=var;
+}
+
+int* ThisVarAccessExpression::getSlotReg()const{
+    return slotReg;
+}
+
+int ThisVarAccessExpression::getSlotOffset()const{
+    return slotOffset;
+}
+
+void ThisVarAccessExpression::setSlot(int* reg,int offset){
+    this->slotReg=reg;
+    this->slotOffset=offset;
 }
\ No newline at end of file
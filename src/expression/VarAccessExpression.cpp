@@ -29,4 +29,17 @@ std::wstring VarAccessExpression::getVarName()const{
 
 void VarAccessExpression::setVar(SharedVariable var){
     this->var=var;
+}
+
+int* VarAccessExpression::getSlotReg()const{
+    return slotReg;
+}
+
+int VarAccessExpression::getSlotOffset()const{
+    return slotOffset;
+}
+
+void VarAccessExpression::setSlot(int* reg,int offset){
+    this->slotReg=reg;
+    this->slotOffset=offset;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <locale>
 #include <codecvt>
+#include <cstdint>
 #include "string_helper.hpp"
 bool startsWith(std::string str, std::string prefix)
 {
@@ -79,6 +80,35 @@ const char* toCharPointer(const std::wstring& wstr) {
     return mbstr;
 }
 
+void writeUtf8(std::ostream& out, const std::wstring& wstr){
+    char bytes[4];
+    for(auto c:wstr){
+        auto code=(uint32_t)c;
+        if(code<0x80){
+            out.put((char)code);
+            continue;
+        }
+        if(code<0x800){
+            bytes[0]=0xC0|(code>>6);
+            bytes[1]=0x80|(code&0x3F);
+            out.write(bytes, 2);
+            continue;
+        }
+        if(code<0x10000){
+            bytes[0]=0xE0|(code>>12);
+            bytes[1]=0x80|((code>>6)&0x3F);
+            bytes[2]=0x80|(code&0x3F);
+            out.write(bytes, 3);
+            continue;
+        }
+        bytes[0]=0xF0|(code>>18);
+        bytes[1]=0x80|((code>>12)&0x3F);
+        bytes[2]=0x80|((code>>6)&0x3F);
+        bytes[3]=0x80|(code&0x3F);
+        out.write(bytes, 4);
+    }
+}
+
 std::wstring toWstring(std::string str){
     // Create a wide string using the codecvt_utf8_utf16 facet
     std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
@@ -7,6 +7,7 @@
 #include "FunScope.hpp"
 #include "IValue.hpp"
 #include "IntValue.hpp"
+#include "LongValue.hpp"
 #include "OperatorFunInvokeExpression.hpp"
 #include "OutOfMemoryException.hpp"
 #include "RefValue.hpp"
@@ -15,6 +16,7 @@
 #include "StackOverFlowException.hpp"
 #include "StackUnderFlowException.hpp"
 #include "Type.hpp"
+#include "ULongValue.hpp"
 #include "VoidValue.hpp"
 #include "Variable.hpp"
 #include "FunParam.hpp"
@@ -46,13 +48,45 @@ SharedIValue Interpreter::pop(){
 }
 
 void Interpreter::runStmList(StmListScope* scope){
-    for(auto stm:*scope->getStmList()){
+    auto stmList=scope->getStmList();
+
+    if(!scope->hasJumpStatements()){
+        for(auto stm:*stmList){
+            if(profiler)
+                profiler->onStatement(stm->getLineNumber());
+            stm->accept(this);
+        }
+        return;
+    }
+
+    for(auto stm:*stmList){
+        if(profiler)
+            profiler->onStatement(stm->getLineNumber());
         stm->accept(this);
-        if(funReturn||loopBreak||loopContinue)
+        if(completion!=Completion::NORMAL)
             break;
     }
 }
 
+void Interpreter::runLoopScope(LoopScope* scope, bool& exitLoop){
+    scope->accept(this);
+
+    switch(completion){
+        case Completion::NORMAL:
+            return;
+        case Completion::CONTINUE:
+            completion=Completion::NORMAL;
+            return;
+        case Completion::BREAK:
+            completion=Completion::NORMAL;
+            exitLoop=true;
+            return;
+        case Completion::RETURN:
+            exitLoop=true;
+            return;
+    }
+}
+
 void Interpreter::reserveSpaceForStmListLocals(int size){
     *SP-=size;
 }
@@ -104,7 +138,7 @@ void Interpreter::invokeNonStaticBuiltInFun(NonStaticFunInvokeExpression* ex){
             AX=pop();
     }
 
-    ex->getFun()->accept(this);
+    ex->getBuiltInFun()->invokeOnInterpreter(this);
 
     push(AX); // return value
 }
@@ -129,7 +163,7 @@ void Interpreter::invokeBuiltInOpFun(OperatorFunInvokeExpression* ex){
 
         AX=DX;
 
-        ex->getFun()->accept(this);
+        ex->getBuiltInFun()->invokeOnInterpreter(this);
 
         push(AX); // push return value to assign it
 
@@ -189,7 +223,7 @@ void Interpreter::invokeBuiltInOpFun(OperatorFunInvokeExpression* ex){
         default:{}
     }
 
-    ex->getFun()->accept(this);
+    ex->getBuiltInFun()->invokeOnInterpreter(this);
 
     switch(op){
         case OperatorFunInvokeExpression::Operator::NOT_EQUAL:{
@@ -198,22 +232,22 @@ void Interpreter::invokeBuiltInOpFun(OperatorFunInvokeExpression* ex){
             break;
         }
         case OperatorFunInvokeExpression::Operator::LESS:{
-            auto val=std::dynamic_pointer_cast<IntValue>(AX)->getValue();
+            auto val=std::dynamic_pointer_cast<LongValue>(AX)->getValue();
             AX=std::make_shared<BoolValue>(val<0);
             break;
         }
         case OperatorFunInvokeExpression::Operator::LESS_EQUAL:{
-            auto val=std::dynamic_pointer_cast<IntValue>(AX)->getValue();
+            auto val=std::dynamic_pointer_cast<LongValue>(AX)->getValue();
             AX=std::make_shared<BoolValue>(val<=0);
             break;
         }
         case OperatorFunInvokeExpression::Operator::GREATER:{
-            auto val=std::dynamic_pointer_cast<IntValue>(AX)->getValue();
+            auto val=std::dynamic_pointer_cast<LongValue>(AX)->getValue();
             AX=std::make_shared<BoolValue>(val>0);
             break;
         }
         case OperatorFunInvokeExpression::Operator::GREATER_EQUAL:{
-            auto val=std::dynamic_pointer_cast<IntValue>(AX)->getValue();
+            auto val=std::dynamic_pointer_cast<LongValue>(AX)->getValue();
             AX=std::make_shared<BoolValue>(val>=0);
             break;
         }
@@ -281,6 +315,9 @@ int Interpreter::getAvailableHeapAddress(int size){
     if(heapAddress>=*SS)
         throw OutOfMemoryException();
 
+    if(profiler)
+        profiler->onAllocation();
+
     memory[heapAddress]=std::make_shared<IntValue>(size);
 
     return heapAddress;
@@ -292,10 +329,7 @@ Interpreter::Interpreter():
     SP(new int(*BP)),
     BX(new int(-1)),
     DS(new int(0)),
-    SS(new int(DATA_SIZE+HEAP_SIZE)),
-    funReturn(false),
-    loopBreak(false),
-    loopContinue(false)
+    SS(new int(DATA_SIZE+HEAP_SIZE))
 {}
 
 Interpreter::LeftSideAssigner::LeftSideAssigner(Interpreter* interpreter)
@@ -309,7 +343,7 @@ void Interpreter::LeftSideAssigner::visit(NonStaticVarAccessExpression* ex){
     ex->getInside()->accept(interpreter);
     auto ref=interpreter->topAs<RefValue>()->getAddress();
     interpreter->push(
-        interpreter->memory[ref+interpreter->offsets[ex->getVar().get()].value]
+        interpreter->memory[ref+ex->getSlotOffset()]
     );
 }
 
@@ -317,14 +351,13 @@ Interpreter::RightSideAssigner::RightSideAssigner(Interpreter* interpreter)
 :interpreter(interpreter){}
 
 void Interpreter::RightSideAssigner::visit(VarAccessExpression* ex){
-    auto offset=interpreter->offsets[ex->getVar().get()];
-    interpreter->memory[*offset.reg+offset.value]=interpreter->pop();
+    interpreter->memory[*ex->getSlotReg()+ex->getSlotOffset()]=interpreter->pop();
 }
 
 void Interpreter::RightSideAssigner::visit(NonStaticVarAccessExpression* ex){
     auto val=interpreter->pop();
     auto ref=interpreter->popAs<RefValue>()->getAddress();
-    interpreter->memory[ref+interpreter->offsets[ex->getVar().get()].value]=val;
+    interpreter->memory[ref+ex->getSlotOffset()]=val;
 }
 
 void Interpreter::visit(PackageScope* scope){
@@ -346,6 +379,9 @@ void Interpreter::visit(ClassScope* scope){
 
 void Interpreter::visit(FunScope* scope){
 
+    if(profiler)
+        profiler->enterFun(scope);
+
     push(std::make_shared<IntValue>(*BP));
 
     *BP=*SP;
@@ -363,25 +399,24 @@ void Interpreter::visit(FunScope* scope){
     if(localsSize>paramsSize)
         reserveSpaceForStmListLocals(localsSize-paramsSize);
 
-    for(auto stm:*scope->getStmList()){
-        stm->accept(this);
-        if(funReturn)
-            break;
-    }
+    runStmList(scope);
 
     if(isConstructor)
         AX=std::make_shared<RefValue>(*BX);
 
     // When return type of a function is Void but it reaches its end, without an explicit return
-    else if(!funReturn) 
+    else if(completion!=Completion::RETURN) 
         AX=std::make_shared<VoidValue>();
     
-    funReturn=false;
+    completion=Completion::NORMAL;
 
     *SP=*BP;
 
     *BP=popAs<IntValue>()->getValue();
 
+    if(profiler)
+        profiler->exitFun();
+
 }
 
 void Interpreter::visit(BuiltInFunScope* scope){
@@ -405,8 +440,7 @@ void Interpreter::visit(StmListScope* scope){
 
 void Interpreter::visit(VarStm* stm){
     stm->getEx()->accept(this);
-    auto offset=offsets[stm->getVar().get()];
-    memory[*offset.reg+offset.value]=pop();
+    memory[*stm->getSlotReg()+stm->getSlotOffset()]=pop();
 }
 
 void Interpreter::visit(AssignStatement* stm){
@@ -457,46 +491,59 @@ void Interpreter::visit(IfStatement* stm){
 }
 
 void Interpreter::visit(WhileStatement* stm){
-    
+
+    auto condition=stm->getCondition().get();
+    auto loopScope=stm->getLoopScope().get();
+
+    // The loop can only exit from its condition
+    if(!loopScope->hasJumpStatements()){
+        while(true){
+            condition->accept(this);
+            if(!popAs<BoolValue>()->getValue())
+                break;
+            loopScope->accept(this);
+        }
+        return;
+    }
+
+    auto exitLoop=false;
+
     while(true){
-        stm->getCondition()->accept(this);
+        condition->accept(this);
 
         if(!popAs<BoolValue>()->getValue())
             break;
         
-        stm->getLoopScope()->accept(this);
-
-        if(loopContinue)
-            loopContinue=false;
+        runLoopScope(loopScope,exitLoop);
 
-        if(loopBreak){
-            loopBreak=false;
+        if(exitLoop)
             break;
-        }
-
-        if(funReturn)
-            break;
-        
     }
 }
 
 void Interpreter::visit(DoWhileStatement* stm){
 
-    do{
-        stm->getLoopScope()->accept(this);
+    auto condition=stm->getCondition().get();
+    auto loopScope=stm->getLoopScope().get();
 
-        if(loopContinue)
-            loopContinue=false;
+    // The loop can only exit from its condition
+    if(!loopScope->hasJumpStatements()){
+        do{
+            loopScope->accept(this);
+            condition->accept(this);
+        }while(popAs<BoolValue>()->getValue());
+        return;
+    }
 
-        if(loopBreak){
-            loopBreak=false;
-            break;
-        }
+    auto exitLoop=false;
 
-        if(funReturn)
+    do{
+        runLoopScope(loopScope,exitLoop);
+
+        if(exitLoop)
             break;
         
-        stm->getCondition()->accept(this);
+        condition->accept(this);
 
         if(!popAs<BoolValue>()->getValue())
             break;
@@ -505,17 +552,17 @@ void Interpreter::visit(DoWhileStatement* stm){
 }
 
 void Interpreter::visit(BreakStatement* stm){
-    loopBreak=true;
+    completion=Completion::BREAK;
 }
 
 void Interpreter::visit(ContinueStatement* stm){
-    loopContinue=true;
+    completion=Completion::CONTINUE;
 }
 
 void Interpreter::visit(ReturnStatement* stm){
     stm->getEx()->accept(this);
     AX=pop();
-    funReturn=true;
+    completion=Completion::RETURN;
 }
 
 void Interpreter::visit(ExpressionStatement* stm){
@@ -524,8 +571,7 @@ void Interpreter::visit(ExpressionStatement* stm){
 }
 
 void Interpreter::visit(VarAccessExpression* ex){
-    auto offset=offsets[ex->getVar().get()];
-    push(memory[*offset.reg+offset.value]);
+    push(memory[*ex->getSlotReg()+ex->getSlotOffset()]);
 }
 
 void Interpreter::visit(FunInvokeExpression* ex){
@@ -572,13 +618,30 @@ void Interpreter::visit(NewObjectExpression* ex){
 
 void Interpreter::visit(NewArrayExpression* ex){
 
+    if(ex->isConstant()){
+        auto addressIt=constantArraysAddresses.find(ex);
+        if(addressIt==constantArraysAddresses.end()){
+            auto address=(int)memory.size();
+            memory.push_back(std::make_shared<IntValue>((int)ex->getValues()->size()));
+            for(auto value:*ex->getValues()){
+                value->accept(this);
+                memory.push_back(pop());
+            }
+            addressIt=constantArraysAddresses.emplace(ex, address).first;
+        }
+        push(std::make_shared<RefValue>(addressIt->second));
+        return;
+    }
+
     auto capExs=ex->getCapacities();
     
     for(auto capEx:capExs){
         capEx->accept(this);
-        auto cap=topAs<IntValue>()->getValue();
+        // The capacities are م8, but the sizes of the heap blocks are kept as ints
+        auto cap=(long long)popAs<ULongValue>()->getValue();
         if(cap<0)
             throw ArrayNegativeCapacityException(cap);
+        push(std::make_shared<IntValue>(cap));
     }
 
     push(std::make_shared<IntValue>(*BP));
@@ -630,13 +693,16 @@ void Interpreter::visit(NonStaticVarAccessExpression* ex){
     ex->getInside()->accept(this);
     AX=pop();
     auto ax=std::dynamic_pointer_cast<RefValue>(AX)->getAddress();
-    push(
-        memory[ax+offsets[ex->getVar().get()].value]
-    );
+    auto value=memory[ax+ex->getSlotOffset()];
+    // The size of an array is kept as an int like the size of any heap block, but its capacity is م8
+    static auto arrayCapacity=Type::ARRAY_CLASS->getPublicVariables()->at(*ArrayClassScope::CAPACITY_NAME).get();
+    if(ex->getVar().get()==arrayCapacity)
+        value=std::make_shared<ULongValue>(std::dynamic_pointer_cast<IntValue>(value)->getValue());
+    push(value);
 }
 
 void Interpreter::visit(NonStaticFunInvokeExpression* ex){
-    if(auto builtIn=std::dynamic_pointer_cast<BuiltInFunScope>(ex->getFun())){
+    if(ex->getBuiltInFun()){
         invokeNonStaticBuiltInFun(ex);
         return;
     }
@@ -645,7 +711,7 @@ void Interpreter::visit(NonStaticFunInvokeExpression* ex){
 
 void Interpreter::visit(OperatorFunInvokeExpression* ex){
     
-    if(auto builtIn=std::dynamic_pointer_cast<BuiltInFunScope>(ex->getFun())){
+    if(ex->getBuiltInFun()){
         invokeBuiltInOpFun(ex);
         return;
     }
@@ -700,22 +766,22 @@ void Interpreter::visit(OperatorFunInvokeExpression* ex){
             break;
         }
         case OperatorFunInvokeExpression::Operator::LESS:{
-            auto val=popAs<IntValue>()->getValue();
+            auto val=popAs<LongValue>()->getValue();
             push(std::make_shared<BoolValue>(val<0));
             break;
         }
         case OperatorFunInvokeExpression::Operator::LESS_EQUAL:{
-            auto val=popAs<IntValue>()->getValue();
+            auto val=popAs<LongValue>()->getValue();
             push(std::make_shared<BoolValue>(val<=0));
             break;
         }
         case OperatorFunInvokeExpression::Operator::GREATER:{
-            auto val=popAs<IntValue>()->getValue();
+            auto val=popAs<LongValue>()->getValue();
             push(std::make_shared<BoolValue>(val>0));
             break;
         }
         case OperatorFunInvokeExpression::Operator::GREATER_EQUAL:{
-            auto val=popAs<IntValue>()->getValue();
+            auto val=popAs<LongValue>()->getValue();
             push(std::make_shared<BoolValue>(val>=0));
             break;
         }
@@ -892,8 +958,7 @@ void Interpreter::visit(ThisExpression* ex){
 }
 
 void Interpreter::visit(ThisVarAccessExpression* ex){
-    auto offset=offsets[ex->getVar().get()];
-    push(memory[*offset.reg+offset.value]);
+    push(memory[*ex->getSlotReg()+ex->getSlotOffset()]);
 }
 
 void Interpreter::visit(ThisFunInvokeExpression* ex){
@@ -0,0 +1,205 @@
+#include "InterpreterCachesSetter.hpp"
+#include "BuiltInFunScope.hpp"
+#include "IExpression.hpp"
+#include "Variable.hpp"
+#include <memory>
+
+InterpreterCachesSetter::InterpreterCachesSetter(
+    std::unordered_map<Variable*, VarsOffsetSetter::Offset>* offsets
+)
+:offsets(offsets){}
+
+void InterpreterCachesSetter::visitArgs(SharedVector<SharedIExpression> args){
+    for(auto arg:*args){
+        arg->accept(this);
+    }
+}
+
+void InterpreterCachesSetter::visitStmList(StmListScope* scope){
+    auto outerHasLoopJump=hasLoopJump;
+    auto outerHasReturn=hasReturn;
+    hasLoopJump=false;
+    hasReturn=false;
+
+    for(auto stm:*scope->getStmList())
+        stm->accept(this);
+
+    scope->setHasJumpStatements(hasLoopJump||hasReturn);
+
+    hasLoopJump=hasLoopJump||outerHasLoopJump;
+    hasReturn=hasReturn||outerHasReturn;
+}
+
+void InterpreterCachesSetter::visitLoopScope(SharedLoopScope scope){
+    // break and continue don't go outside their loop
+    auto outerHasLoopJump=hasLoopJump;
+    scope->accept(this);
+    hasLoopJump=outerHasLoopJump;
+}
+
+void InterpreterCachesSetter::visit(PackageScope* scope){
+    for(auto fileIterator:scope->getFiles()){
+        fileIterator.second->accept(this);
+    }
+    for(auto packageIterator:scope->getPackages()){
+        packageIterator.second->accept(this);
+    }
+}
+
+void InterpreterCachesSetter::visit(FileScope* scope){
+    scope->getGlobalVarsInitStmList()->accept(this);
+
+    for(auto classIt:*scope->getPublicClasses()){
+        classIt.second->accept(this);
+    }
+    for(auto classIt:*scope->getPrivateClasses()){
+        classIt.second->accept(this);
+    }
+    for(auto funIt:*scope->getPublicFunctions()){
+        funIt.second->accept(this);
+    }
+    for(auto funIt:*scope->getPrivateFunctions()){
+        funIt.second->accept(this);
+    }
+}
+
+void InterpreterCachesSetter::visit(ClassScope* scope){
+    // Built-in classes don't have vars init statements
+    if(auto varsInitStmList=scope->getVarsInitStmList())
+        varsInitStmList->accept(this);
+
+    for(auto constructorIt:*scope->getPublicConstructors()){
+        constructorIt.second->accept(this);
+    }
+    for(auto constructorIt:*scope->getPrivateConstructors()){
+        constructorIt.second->accept(this);
+    }
+    for(auto funIt:*scope->getPublicFunctions()){
+        funIt.second->accept(this);
+    }
+    for(auto funIt:*scope->getPrivateFunctions()){
+        funIt.second->accept(this);
+    }
+}
+
+void InterpreterCachesSetter::visit(FunScope* scope){
+    visitStmList(scope);
+}
+
+void InterpreterCachesSetter::visit(LoopScope* scope){
+    visitStmList(scope);
+}
+
+void InterpreterCachesSetter::visit(StmListScope* scope){
+    visitStmList(scope);
+}
+
+void InterpreterCachesSetter::visit(VarStm* stm){
+    stm->getEx()->accept(this);
+    auto offset=(*offsets)[stm->getVar().get()];
+    stm->setSlot(offset.reg,offset.value);
+}
+
+void InterpreterCachesSetter::visit(AssignStatement* stm){
+    stm->getLeft()->accept(this);
+    stm->getRight()->accept(this);
+}
+
+void InterpreterCachesSetter::visit(AugmentedAssignStatement* stm){
+    stm->getLeft()->accept(this);
+    stm->getRight()->accept(this);
+}
+
+void InterpreterCachesSetter::visit(IfStatement* stm){
+    stm->getIfCondition()->accept(this);
+    stm->getIfScope()->accept(this);
+    if(auto elseScope=stm->getElseScope())
+        elseScope->accept(this);
+}
+
+void InterpreterCachesSetter::visit(WhileStatement* stm){
+    stm->getCondition()->accept(this);
+    visitLoopScope(stm->getLoopScope());
+}
+
+void InterpreterCachesSetter::visit(DoWhileStatement* stm){
+    stm->getCondition()->accept(this);
+    visitLoopScope(stm->getLoopScope());
+}
+
+void InterpreterCachesSetter::visit(BreakStatement* stm){
+    hasLoopJump=true;
+}
+
+void InterpreterCachesSetter::visit(ContinueStatement* stm){
+    hasLoopJump=true;
+}
+
+void InterpreterCachesSetter::visit(ReturnStatement* stm){
+    stm->getEx()->accept(this);
+    hasReturn=true;
+}
+
+void InterpreterCachesSetter::visit(ExpressionStatement* stm){
+    stm->getEx()->accept(this);
+}
+
+void InterpreterCachesSetter::visit(VarAccessExpression* ex){
+    auto offset=(*offsets)[ex->getVar().get()];
+    ex->setSlot(offset.reg,offset.value);
+}
+
+void InterpreterCachesSetter::visit(FunInvokeExpression* ex){
+    visitArgs(ex->getArgs());
+}
+
+void InterpreterCachesSetter::visit(NewObjectExpression* ex){
+    visitArgs(ex->getArgs());
+}
+
+void InterpreterCachesSetter::visit(NewArrayExpression* ex){
+    for(auto capEx:ex->getCapacities()){
+        capEx->accept(this);
+    }
+    if(ex->isConstant())
+        for(auto valueEx:*ex->getValues()){
+            valueEx->accept(this);
+        }
+}
+
+void InterpreterCachesSetter::visit(LogicalExpression* ex){
+    ex->getLeft()->accept(this);
+    ex->getRight()->accept(this);
+}
+
+void InterpreterCachesSetter::visit(NonStaticVarAccessExpression* ex){
+    ex->getInside()->accept(this);
+    ex->setSlotOffset((*offsets)[ex->getVar().get()].value);
+}
+
+void InterpreterCachesSetter::visit(NonStaticFunInvokeExpression* ex){
+    ex->getInside()->accept(this);
+    visitArgs(ex->getArgs());
+    ex->setBuiltInFun(dynamic_cast<BuiltInFunScope*>(ex->getFun().get()));
+}
+
+void InterpreterCachesSetter::visit(OperatorFunInvokeExpression* ex){
+    ex->getInside()->accept(this);
+    visitArgs(ex->getArgs());
+    ex->setBuiltInFun(dynamic_cast<BuiltInFunScope*>(ex->getFun().get()));
+}
+
+void InterpreterCachesSetter::visit(SetOperatorExpression* ex){
+    ex->getExOfGet()->accept(this);
+    if(auto valueEx=ex->getValueEx())
+        valueEx->accept(this);
+}
+
+void InterpreterCachesSetter::visit(ThisVarAccessExpression* ex){
+    auto offset=(*offsets)[ex->getVar().get()];
+    ex->setSlot(offset.reg,offset.value);
+}
+
+void InterpreterCachesSetter::visit(ThisFunInvokeExpression* ex){
+    visitArgs(ex->getArgs());
+}
@@ -0,0 +1,142 @@
+#include "InterpreterProfiler.hpp"
+#include "ClassScope.hpp"
+#include "FunDecl.hpp"
+#include <algorithm>
+#include <memory>
+#include <sys/time.h>
+
+std::atomic<int> InterpreterProfiler::pendingSamples{0};
+static_assert(std::atomic<int>::is_always_lock_free);
+
+InterpreterProfiler::InterpreterProfiler(int samplingIntervalUs)
+:samplingIntervalUs(samplingIntervalUs){}
+
+void InterpreterProfiler::onTimerSignal(int signal){
+    pendingSamples.fetch_add(1,std::memory_order_relaxed);
+}
+
+void InterpreterProfiler::start(){
+    struct sigaction action{};
+    action.sa_handler=onTimerSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags=SA_RESTART;
+    sigaction(SIGPROF,&action,nullptr);
+
+    struct itimerval timer{};
+    timer.it_interval.tv_sec=samplingIntervalUs/1000000;
+    timer.it_interval.tv_usec=samplingIntervalUs%1000000;
+    timer.it_value=timer.it_interval;
+    setitimer(ITIMER_PROF,&timer,nullptr);
+}
+
+void InterpreterProfiler::stop(){
+    struct itimerval timer{};
+    setitimer(ITIMER_PROF,&timer,nullptr);
+    signal(SIGPROF,SIG_DFL);
+}
+
+void InterpreterProfiler::enterFun(FunScope* fun){
+    callStack.push_back(fun);
+    callersLines.push_back(currentLine);
+    funsStats[fun].calls++;
+}
+
+void InterpreterProfiler::exitFun(){
+    if(callStack.empty())
+        return;
+    callStack.pop_back();
+    currentLine=callersLines.back();
+    callersLines.pop_back();
+}
+
+void InterpreterProfiler::onAllocation(){
+    if(callStack.empty())
+        return;
+    funsStats[callStack.back()].allocations++;
+}
+
+void InterpreterProfiler::takeSample(){
+    if(callStack.empty())
+        return;
+
+    auto sampleId=samplesCount++;
+
+    for(auto fun:callStack){
+        auto& stats=funsStats[fun];
+        if(stats.lastSample==sampleId)
+            continue;
+        stats.lastSample=sampleId;
+        stats.inclusiveSamples++;
+    }
+
+    auto currentFun=callStack.back();
+    funsStats[currentFun].selfSamples++;
+    linesSamples[{currentFun,currentLine}]++;
+    stacksSamples[callStack]++;
+}
+
+std::wstring InterpreterProfiler::getFunName(FunScope* fun){
+    auto name=fun->getDecl()->toString();
+    if(auto classScope=std::dynamic_pointer_cast<ClassScope>(fun->getParentScope()))
+        name=classScope->getName()+L"."+name;
+    return name;
+}
+
+std::wstring InterpreterProfiler::getTime(int samples){
+    auto timeUs=(long long)samples*samplingIntervalUs;
+    return std::to_wstring(timeUs/1000)+L"."+std::to_wstring(timeUs%1000/100)+L"ms";
+}
+
+std::wstring InterpreterProfiler::getFlatReport(){
+    auto funs=std::vector<std::pair<FunScope*, FunStats>>(funsStats.begin(),funsStats.end());
+    std::sort(funs.begin(),funs.end(),[](auto& a,auto& b){
+        if(a.second.selfSamples!=b.second.selfSamples)
+            return a.second.selfSamples>b.second.selfSamples;
+        return a.second.inclusiveSamples>b.second.inclusiveSamples;
+    });
+
+    std::wstring report=
+        L"samples: "+std::to_wstring(samplesCount)
+        +L", interval: "+std::to_wstring(samplingIntervalUs)+L"us\n\n"
+        +L"self\tinclusive\tcalls\tallocations\tfunction\n";
+
+    for(auto& funIt:funs){
+        auto& stats=funIt.second;
+        report+=
+            getTime(stats.selfSamples)+L"\t"
+            +getTime(stats.inclusiveSamples)+L"\t"
+            +std::to_wstring(stats.calls)+L"\t"
+            +std::to_wstring(stats.allocations)+L"\t"
+            +getFunName(funIt.first)+L"\n";
+    }
+
+    auto lines=std::vector<std::pair<std::pair<FunScope*, int>, int>>(linesSamples.begin(),linesSamples.end());
+    std::sort(lines.begin(),lines.end(),[](auto& a,auto& b){
+        return a.second>b.second;
+    });
+
+    report+=L"\nself\tline\tfunction\n";
+
+    for(auto& lineIt:lines){
+        report+=
+            getTime(lineIt.second)+L"\t"
+            +std::to_wstring(lineIt.first.second)+L"\t"
+            +getFunName(lineIt.first.first)+L"\n";
+    }
+
+    return report;
+}
+
+std::wstring InterpreterProfiler::getCollapsedStacks(){
+    std::wstring stacks=L"";
+    for(auto& stackIt:stacksSamples){
+        auto& stack=stackIt.first;
+        for(int i=0;i<stack.size();i++){
+            if(i!=0)
+                stacks+=L";";
+            stacks+=getFunName(stack[i]);
+        }
+        stacks+=L" "+std::to_wstring(stackIt.second)+L"\n";
+    }
+    return stacks;
+}
@@ -0,0 +1,285 @@
+#include "IR.hpp"
+#include "FunDecl.hpp"
+#include "FunScope.hpp"
+#include "Type.hpp"
+#include "Variable.hpp"
+#include <algorithm>
+#include <unordered_set>
+
+namespace IR {
+
+    bool Instruction::isPhi()const{
+        return op==Op::PHI;
+    }
+
+    bool Instruction::isCompare()const{
+        switch(op){
+            case Op::EQ:
+            case Op::NE:
+            case Op::LT:
+            case Op::LE:
+            case Op::GT:
+            case Op::GE:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool Instruction::isPure()const{
+        switch(op){
+            case Op::PHI:
+            case Op::LOAD_GLOBAL:
+            case Op::STORE_GLOBAL:
+            case Op::LOAD:
+            case Op::STORE:
+            case Op::CALL:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    bool Instruction::isSpeculatable()const{
+        if(!isPure()||op==Op::PARAM)
+            return false;
+
+        if(op!=Op::DIV&&op!=Op::MOD)
+            return true;
+
+        // Only a known divisor can't fault
+        auto divisor=operands[1];
+        return divisor->op==Op::CONST&&divisor->imm!=0&&divisor->imm!=-1;
+    }
+
+    bool Instruction::hasSideEffects()const{
+        return op==Op::STORE_GLOBAL||op==Op::STORE||op==Op::CALL;
+    }
+
+    bool Instruction::isUnsigned()const{
+        return isUnsignedType(type);
+    }
+
+    std::wstring Instruction::toString()const{
+        auto text=(*type==*Type::VOID)?L"":L"v"+std::to_wstring(id)+L":"+*type->getName()+L" = ";
+        text+=getOpName(op);
+
+        if(op==Op::CONST)
+            text+=L" "+std::to_wstring(imm);
+
+        if(var)
+            text+=L" "+*var->getName();
+
+        if(callee)
+            text+=L" "+callee->getDecl()->toString();
+
+        for(int i=0;i<operands.size();i++){
+            text+=(i==0)?L" ":L", ";
+            if(op==Op::PHI)
+                text+=L"[b"+std::to_wstring(block->preds[i]->id)+L"] ";
+            text+=L"v"+std::to_wstring(operands[i]->id);
+        }
+
+        return text;
+    }
+
+    std::vector<BasicBlock*> BasicBlock::getSuccessors()const{
+        switch(terminator){
+            case Terminator::JUMP:
+                return {targets[0]};
+            case Terminator::BRANCH:
+                return {targets[0], targets[1]};
+            default:
+                return {};
+        }
+    }
+
+    int BasicBlock::getPredIndex(BasicBlock* pred)const{
+        for(int i=0;i<preds.size();i++){
+            if(preds[i]==pred)
+                return i;
+        }
+        return -1;
+    }
+
+    void BasicBlock::removePred(BasicBlock* pred){
+        auto index=getPredIndex(pred);
+        if(index==-1)
+            return;
+
+        preds.erase(preds.begin()+index);
+
+        for(auto instruction:instructions){
+            if(!instruction->isPhi())
+                break;
+            instruction->operands.erase(instruction->operands.begin()+index);
+        }
+    }
+
+    std::wstring BasicBlock::toString()const{
+        auto text=L"b"+std::to_wstring(id)+L":";
+
+        if(!preds.empty()){
+            text+=L"\t; preds";
+            for(auto pred:preds)
+                text+=L" b"+std::to_wstring(pred->id);
+        }
+
+        for(auto instruction:instructions)
+            text+=L"\n\t"+instruction->toString();
+
+        switch(terminator){
+            case Terminator::NONE:
+                break;
+            case Terminator::JUMP:
+                text+=L"\n\tjump b"+std::to_wstring(targets[0]->id);
+                break;
+            case Terminator::BRANCH:
+                text+=L"\n\tbranch v"+std::to_wstring(value->id)
+                    +L", b"+std::to_wstring(targets[0]->id)
+                    +L", b"+std::to_wstring(targets[1]->id);
+                break;
+            case Terminator::RETURN:
+                text+=L"\n\treturn";
+                if(value)
+                    text+=L" v"+std::to_wstring(value->id);
+                break;
+        }
+
+        return text;
+    }
+
+    Function::Function(FunScope* scope):scope(scope){}
+
+    BasicBlock* Function::getEntry()const{
+        return blocks.front().get();
+    }
+
+    BasicBlock* Function::newBlock(){
+        auto block=std::make_unique<BasicBlock>();
+        block->id=blocksCounter++;
+        blocks.push_back(std::move(block));
+        return blocks.back().get();
+    }
+
+    Instruction* Function::newInstruction(Op op, SharedType type, std::vector<Instruction*> operands){
+        auto instruction=std::make_unique<Instruction>();
+        instruction->id=instructionsCounter++;
+        instruction->op=op;
+        instruction->type=type;
+        instruction->operands=operands;
+        instructions.push_back(std::move(instruction));
+        return instructions.back().get();
+    }
+
+    void Function::addEdge(BasicBlock* from, BasicBlock* to){
+        to->preds.push_back(from);
+    }
+
+    void Function::replaceAllUses(Instruction* of, Instruction* with){
+        for(auto &block:blocks){
+            for(auto instruction:block->instructions){
+                std::replace(instruction->operands.begin(), instruction->operands.end(), of, with);
+            }
+            if(block->value==of)
+                block->value=with;
+        }
+    }
+
+    void Function::removeBlocks(std::vector<BasicBlock*> blocksToRemove){
+        std::unordered_set<BasicBlock*> removed(blocksToRemove.begin(), blocksToRemove.end());
+
+        for(auto &block:blocks){
+            if(removed.find(block.get())!=removed.end())
+                continue;
+            for(auto pred:blocksToRemove)
+                block->removePred(pred);
+        }
+
+        blocks.erase(
+            std::remove_if(
+                blocks.begin(),
+                blocks.end(),
+                [&](const std::unique_ptr<BasicBlock>& block){return removed.find(block.get())!=removed.end();}
+            ),
+            blocks.end()
+        );
+    }
+
+    std::wstring Function::toString()const{
+        auto text=L"دالة "+scope->getDecl()->toString();
+        for(auto &block:blocks)
+            text+=L"\n"+block->toString();
+        return text;
+    }
+
+    std::wstring getOpName(Op op){
+        switch(op){
+            case Op::CONST: return L"const";
+            case Op::PARAM: return L"param";
+            case Op::PHI: return L"phi";
+            case Op::ADD: return L"add";
+            case Op::SUB: return L"sub";
+            case Op::MUL: return L"mul";
+            case Op::DIV: return L"div";
+            case Op::MOD: return L"mod";
+            case Op::AND: return L"and";
+            case Op::OR: return L"or";
+            case Op::XOR: return L"xor";
+            case Op::SHL: return L"shl";
+            case Op::SHR: return L"shr";
+            case Op::NEG: return L"neg";
+            case Op::NOT: return L"not";
+            case Op::LOGICAL_NOT: return L"logical_not";
+            case Op::CONVERT: return L"convert";
+            case Op::EQ: return L"eq";
+            case Op::NE: return L"ne";
+            case Op::LT: return L"lt";
+            case Op::LE: return L"le";
+            case Op::GT: return L"gt";
+            case Op::GE: return L"ge";
+            case Op::LOAD_GLOBAL: return L"load_global";
+            case Op::STORE_GLOBAL: return L"store_global";
+            case Op::LOAD: return L"load";
+            case Op::STORE: return L"store";
+            case Op::CALL: return L"call";
+        }
+        return L"";
+    }
+
+    bool isIntegerType(SharedType type){
+        return
+            *type==*Type::BYTE||*type==*Type::UBYTE
+            ||*type==*Type::SHORT||*type==*Type::USHORT
+            ||*type==*Type::INT||*type==*Type::UINT
+            ||*type==*Type::LONG||*type==*Type::ULONG
+        ;
+    }
+
+    bool isSupportedType(SharedType type){
+        return isIntegerType(type)||*type==*Type::BOOL||*type==*Type::CHAR;
+    }
+
+    bool isUnsignedType(SharedType type){
+        return
+            *type==*Type::UBYTE||*type==*Type::USHORT
+            ||*type==*Type::UINT||*type==*Type::ULONG
+            ||*type==*Type::BOOL||*type==*Type::CHAR
+        ;
+    }
+
+    long long canonicalize(long long value, SharedType type){
+        auto isUnsigned=isUnsignedType(type);
+        switch(Type::getSize(type.get())){
+            case 1:
+                return isUnsigned?(long long)(unsigned char)value:(long long)(signed char)value;
+            case 2:
+                return isUnsigned?(long long)(unsigned short)value:(long long)(short)value;
+            case 4:
+                return isUnsigned?(long long)(unsigned int)value:(long long)(int)value;
+            default:
+                return value;
+        }
+    }
+
+}
@@ -0,0 +1,755 @@
+#include "IRBuilder.hpp"
+#include "BuiltInFunScope.hpp"
+#include "BoolValue.hpp"
+#include "ByteValue.hpp"
+#include "UByteValue.hpp"
+#include "ShortValue.hpp"
+#include "UShortValue.hpp"
+#include "IntValue.hpp"
+#include "UIntValue.hpp"
+#include "LongValue.hpp"
+#include "ULongValue.hpp"
+#include "CharValue.hpp"
+#include "FunDecl.hpp"
+#include "FunParam.hpp"
+#include "Type.hpp"
+#include "Variable.hpp"
+#include "string_helper.hpp"
+#include <string>
+
+std::unique_ptr<IR::Function> IRBuilder::build(FunScope* scope){
+    IRBuilder builder(scope);
+
+    if(builder.supported)
+        builder.lowerStmList(scope);
+
+    if(!builder.supported)
+        return nullptr;
+
+    // Falling off the end of the function
+    if(builder.currentBlock->terminator==IR::BasicBlock::Terminator::NONE)
+        builder.currentBlock->terminator=IR::BasicBlock::Terminator::RETURN;
+
+    return std::move(builder.fun);
+}
+
+IRBuilder::IRBuilder(FunScope* scope):
+    fun(std::make_unique<IR::Function>(scope))
+{
+    auto returnType=scope->getReturnType();
+    if(*returnType!=*Type::VOID&&!IR::isSupportedType(returnType)){
+        unsupported();
+        return;
+    }
+
+    collectLocals(scope);
+
+    if(!supported)
+        return;
+
+    currentBlock=fun->newBlock();
+    sealBlock(currentBlock);
+
+    auto locals=scope->getLocals();
+    for(auto param:*scope->getDecl()->params){
+        auto var=(*locals)[*param->name].get();
+        auto paramValue=append(IR::Op::PARAM, var->getType());
+        paramValue->var=var;
+        writeVariable(var, currentBlock, paramValue);
+    }
+}
+
+void IRBuilder::unsupported(){
+    supported=false;
+}
+
+void IRBuilder::collectLocals(StmListScope* scope){
+    for(auto varIt:*scope->getLocals()){
+        auto var=varIt.second.get();
+        if(!IR::isSupportedType(var->getType()))
+            unsupported();
+        locals.insert(var);
+    }
+
+    for(auto stm:*scope->getStmList()){
+        if(auto ifStm=std::dynamic_pointer_cast<IfStatement>(stm)){
+            collectLocals(ifStm->getIfScope().get());
+            if(auto elseScope=ifStm->getElseScope())
+                collectLocals(elseScope.get());
+        }
+        else if(auto loopStm=std::dynamic_pointer_cast<WhileStatement>(stm)){
+            collectLocals(loopStm->getLoopScope().get());
+        }
+    }
+}
+
+void IRBuilder::lowerStmList(StmListScope* scope){
+    for(auto stm:*scope->getStmList()){
+        if(!supported)
+            return;
+        stm->accept(this);
+    }
+}
+
+IR::Instruction* IRBuilder::lower(SharedIExpression ex){
+    result=nullptr;
+
+    if(supported)
+        ex->accept(this);
+
+    auto value=result;
+    result=nullptr;
+
+    if(!value){
+        unsupported();
+        // Keeps building valid instructions until the builder stops
+        return constant(0, Type::LONG);
+    }
+
+    return value;
+}
+
+void IRBuilder::lowerCondition(SharedIExpression condition, IR::BasicBlock* trueTarget, IR::BasicBlock* falseTarget){
+
+    if(auto logicalEx=std::dynamic_pointer_cast<LogicalExpression>(condition)){
+        lowerLogicalCondition(logicalEx.get(), trueTarget, falseTarget);
+        return;
+    }
+
+    auto opEx=std::dynamic_pointer_cast<OperatorFunInvokeExpression>(condition);
+    if(
+        opEx
+        &&opEx->getOp()==OperatorFunInvokeExpression::Operator::LOGICAL_NOT
+        &&std::dynamic_pointer_cast<BuiltInFunScope>(opEx->getFun())
+    ){
+        lowerCondition(opEx->getInside(), falseTarget, trueTarget);
+        return;
+    }
+
+    branch(lower(condition), trueTarget, falseTarget);
+}
+
+void IRBuilder::lowerLogicalCondition(LogicalExpression* ex, IR::BasicBlock* trueTarget, IR::BasicBlock* falseTarget){
+    auto rightBlock=fun->newBlock();
+
+    if(ex->getLogicalOp()==LogicalExpression::Operation::AND)
+        lowerCondition(ex->getLeft(), rightBlock, falseTarget);
+    else
+        lowerCondition(ex->getLeft(), trueTarget, rightBlock);
+
+    sealBlock(rightBlock);
+    currentBlock=rightBlock;
+    lowerCondition(ex->getRight(), trueTarget, falseTarget);
+}
+
+IR::Instruction* IRBuilder::constant(long long value, SharedType type){
+    auto instruction=append(IR::Op::CONST, type);
+    instruction->imm=IR::canonicalize(value, type);
+    return instruction;
+}
+
+IR::Instruction* IRBuilder::append(IR::Op op, SharedType type, std::vector<IR::Instruction*> operands){
+    auto instruction=fun->newInstruction(op, type, operands);
+    instruction->block=currentBlock;
+    currentBlock->instructions.push_back(instruction);
+    return instruction;
+}
+
+IR::Instruction* IRBuilder::readVar(Variable* var){
+    if(locals.find(var)!=locals.end())
+        return readVariable(var, currentBlock);
+
+    if(!IR::isSupportedType(var->getType())){
+        unsupported();
+        return constant(0, Type::LONG);
+    }
+
+    auto load=append(IR::Op::LOAD_GLOBAL, var->getType());
+    load->var=var;
+    return load;
+}
+
+void IRBuilder::writeVar(Variable* var, IR::Instruction* value){
+    if(locals.find(var)!=locals.end()){
+        writeVariable(var, currentBlock, value);
+        return;
+    }
+
+    if(!IR::isSupportedType(var->getType())){
+        unsupported();
+        return;
+    }
+
+    auto store=append(IR::Op::STORE_GLOBAL, Type::VOID, {value});
+    store->var=var;
+}
+
+void IRBuilder::jump(IR::BasicBlock* target){
+    currentBlock->terminator=IR::BasicBlock::Terminator::JUMP;
+    currentBlock->targets[0]=target;
+    fun->addEdge(currentBlock, target);
+}
+
+void IRBuilder::branch(IR::Instruction* condition, IR::BasicBlock* trueTarget, IR::BasicBlock* falseTarget){
+    currentBlock->terminator=IR::BasicBlock::Terminator::BRANCH;
+    currentBlock->value=condition;
+    currentBlock->targets[0]=trueTarget;
+    currentBlock->targets[1]=falseTarget;
+    fun->addEdge(currentBlock, trueTarget);
+    fun->addEdge(currentBlock, falseTarget);
+}
+
+void IRBuilder::startUnreachableBlock(){
+    currentBlock=fun->newBlock();
+    sealBlock(currentBlock);
+}
+
+void IRBuilder::writeVariable(Variable* var, IR::BasicBlock* block, IR::Instruction* value){
+    currentDefs[var][block]=value;
+}
+
+IR::Instruction* IRBuilder::readVariable(Variable* var, IR::BasicBlock* block){
+    auto &defs=currentDefs[var];
+    auto defIt=defs.find(block);
+    if(defIt!=defs.end())
+        return defIt->second;
+    return readVariableRecursive(var, block);
+}
+
+IR::Instruction* IRBuilder::readVariableRecursive(Variable* var, IR::BasicBlock* block){
+    IR::Instruction* value;
+
+    if(sealedBlocks.find(block)==sealedBlocks.end()){
+        value=newPhi(var, block);
+        incompletePhis[block].push_back({var, value});
+    }
+
+    else if(block->preds.empty()){
+        // Not initialized on this path, only happens in unreachable code
+        auto prevBlock=currentBlock;
+        currentBlock=block;
+        value=constant(0, var->getType());
+        currentBlock=prevBlock;
+    }
+
+    else if(block->preds.size()==1)
+        value=readVariable(var, block->preds[0]);
+
+    else{
+        // The phi breaks the cycles of the loops
+        value=newPhi(var, block);
+        writeVariable(var, block, value);
+        addPhiOperands(var, value);
+    }
+
+    writeVariable(var, block, value);
+    return value;
+}
+
+IR::Instruction* IRBuilder::newPhi(Variable* var, IR::BasicBlock* block){
+    auto phi=fun->newInstruction(IR::Op::PHI, var->getType());
+    phi->block=block;
+
+    auto insertIt=block->instructions.begin();
+    while(insertIt!=block->instructions.end()&&(*insertIt)->isPhi())
+        insertIt++;
+    block->instructions.insert(insertIt, phi);
+
+    return phi;
+}
+
+void IRBuilder::addPhiOperands(Variable* var, IR::Instruction* phi){
+    for(auto pred:phi->block->preds){
+        phi->operands.push_back(readVariable(var, pred));
+    }
+}
+
+void IRBuilder::sealBlock(IR::BasicBlock* block){
+    auto phisIt=incompletePhis.find(block);
+    if(phisIt!=incompletePhis.end()){
+        for(auto &varPhi:phisIt->second)
+            addPhiOperands(varPhi.first, varPhi.second);
+        incompletePhis.erase(phisIt);
+    }
+    sealedBlocks.insert(block);
+}
+
+void IRBuilder::visit(LoopScope* scope){
+    lowerStmList(scope);
+}
+
+void IRBuilder::visit(StmListScope* scope){
+    lowerStmList(scope);
+}
+
+void IRBuilder::visit(VarStm* stm){
+    writeVar(stm->getVar().get(), lower(stm->getEx()));
+}
+
+void IRBuilder::visit(AssignStatement* stm){
+    auto varAccess=std::dynamic_pointer_cast<VarAccessExpression>(stm->getLeft());
+    if(!varAccess){
+        unsupported();
+        return;
+    }
+    writeVar(varAccess->getVar().get(), lower(stm->getRight()));
+}
+
+void IRBuilder::visit(AugmentedAssignStatement* stm){
+    auto varAccess=std::dynamic_pointer_cast<VarAccessExpression>(stm->getLeft());
+    auto leftType=stm->getLeft()->getReturnType();
+    auto op=stm->getOp();
+
+    if(
+        !varAccess
+        ||stm->isOpFunExplicit()
+        ||!std::dynamic_pointer_cast<BuiltInFunScope>(stm->getOpFun())
+        ||!IR::isIntegerType(leftType)
+        ||*stm->getRight()->getReturnType()!=*leftType
+        ||op==AugmentedAssignStatement::Operator::POW
+        ||op==AugmentedAssignStatement::Operator::BAD_OP
+    ){
+        unsupported();
+        return;
+    }
+
+    auto var=varAccess->getVar().get();
+    auto oldValue=readVar(var);
+    auto rightValue=lower(stm->getRight());
+    writeVar(var, append(toIROp(op), leftType, {oldValue, rightValue}));
+}
+
+void IRBuilder::visit(IfStatement* stm){
+    auto elseScope=stm->getElseScope();
+
+    auto ifBlock=fun->newBlock();
+    auto elseBlock=(elseScope)?fun->newBlock():nullptr;
+    auto endBlock=fun->newBlock();
+
+    lowerCondition(stm->getIfCondition(), ifBlock, (elseBlock)?elseBlock:endBlock);
+
+    sealBlock(ifBlock);
+    currentBlock=ifBlock;
+    lowerStmList(stm->getIfScope().get());
+    jump(endBlock);
+
+    if(elseBlock){
+        sealBlock(elseBlock);
+        currentBlock=elseBlock;
+        lowerStmList(elseScope.get());
+        jump(endBlock);
+    }
+
+    sealBlock(endBlock);
+    currentBlock=endBlock;
+}
+
+void IRBuilder::visit(WhileStatement* stm){
+    // The loop is rotated, the condition is checked once before the loop and then at its end
+    auto preheader=fun->newBlock();
+    auto bodyBlock=fun->newBlock();
+    auto continueBlock=fun->newBlock();
+    auto breakBlock=fun->newBlock();
+
+    lowerCondition(stm->getCondition(), preheader, breakBlock);
+
+    sealBlock(preheader);
+    currentBlock=preheader;
+    jump(bodyBlock);
+
+    loops.push_back({continueBlock, breakBlock});
+    currentBlock=bodyBlock;
+    lowerStmList(stm->getLoopScope().get());
+    jump(continueBlock);
+    loops.pop_back();
+
+    sealBlock(continueBlock);
+    currentBlock=continueBlock;
+    lowerCondition(stm->getCondition(), bodyBlock, breakBlock);
+
+    sealBlock(bodyBlock);
+    sealBlock(breakBlock);
+    currentBlock=breakBlock;
+}
+
+void IRBuilder::visit(DoWhileStatement* stm){
+    auto preheader=fun->newBlock();
+    auto bodyBlock=fun->newBlock();
+    auto continueBlock=fun->newBlock();
+    auto breakBlock=fun->newBlock();
+
+    jump(preheader);
+    sealBlock(preheader);
+    currentBlock=preheader;
+    jump(bodyBlock);
+
+    loops.push_back({continueBlock, breakBlock});
+    currentBlock=bodyBlock;
+    lowerStmList(stm->getLoopScope().get());
+    jump(continueBlock);
+    loops.pop_back();
+
+    sealBlock(continueBlock);
+    currentBlock=continueBlock;
+    lowerCondition(stm->getCondition(), bodyBlock, breakBlock);
+
+    sealBlock(bodyBlock);
+    sealBlock(breakBlock);
+    currentBlock=breakBlock;
+}
+
+void IRBuilder::visit(BreakStatement* stm){
+    jump(loops.back().breakTarget);
+    startUnreachableBlock();
+}
+
+void IRBuilder::visit(ContinueStatement* stm){
+    jump(loops.back().continueTarget);
+    startUnreachableBlock();
+}
+
+void IRBuilder::visit(ReturnStatement* stm){
+    IR::Instruction* value=nullptr;
+
+    if(!std::dynamic_pointer_cast<VoidExpression>(stm->getEx()))
+        value=lower(stm->getEx());
+
+    currentBlock->terminator=IR::BasicBlock::Terminator::RETURN;
+    currentBlock->value=value;
+    startUnreachableBlock();
+}
+
+void IRBuilder::visit(ExpressionStatement* stm){
+    lower(stm->getEx());
+}
+
+void IRBuilder::visit(VarAccessExpression* ex){
+    result=readVar(ex->getVar().get());
+}
+
+void IRBuilder::visit(FunInvokeExpression* ex){
+    auto callee=ex->getFun();
+    auto returnType=ex->getReturnType();
+
+    if(callee==BuiltInFunScope::INLINE_ASM||(*returnType!=*Type::VOID&&!IR::isSupportedType(returnType))){
+        unsupported();
+        return;
+    }
+
+    if(auto builtIn=std::dynamic_pointer_cast<BuiltInFunScope>(callee)){
+        if(auto access=lowerMemoryAccess(builtIn.get(), ex)){
+            result=access;
+            return;
+        }
+    }
+
+    std::vector<IR::Instruction*> args;
+    for(auto arg:*ex->getArgs()){
+        if(!IR::isSupportedType(arg->getReturnType())){
+            unsupported();
+            return;
+        }
+        args.push_back(lower(arg));
+    }
+
+    auto call=append(IR::Op::CALL, returnType, args);
+    call->callee=callee.get();
+    result=call;
+}
+
+void IRBuilder::visit(NewObjectExpression* ex){
+    unsupported();
+}
+
+void IRBuilder::visit(NewArrayExpression* ex){
+    unsupported();
+}
+
+void IRBuilder::visit(LiteralExpression* ex){
+    auto value=ex->getValue();
+    auto type=ex->getReturnType();
+
+    if(auto val=std::dynamic_pointer_cast<BoolValue>(value))
+        result=constant(val->getValue(), Type::BOOL);
+
+    else if(auto val=std::dynamic_pointer_cast<CharValue>(value)){
+        // The same bytes the assembler makes of the char in quotes
+        auto chars=toCharPointer(val->toString());
+        auto utf8=std::string(chars);
+        delete[] chars;
+        unsigned long long bytes=0;
+        for(int i=utf8.size()-1;i>=0;i--)
+            bytes=(bytes<<8)|(unsigned char)utf8[i];
+        result=constant(bytes, Type::CHAR);
+    }
+
+    else if(auto val=std::dynamic_pointer_cast<ByteValue>(value))
+        result=constant(val->getValue(), type);
+    else if(auto val=std::dynamic_pointer_cast<UByteValue>(value))
+        result=constant(val->getValue(), type);
+    else if(auto val=std::dynamic_pointer_cast<ShortValue>(value))
+        result=constant(val->getValue(), type);
+    else if(auto val=std::dynamic_pointer_cast<UShortValue>(value))
+        result=constant(val->getValue(), type);
+    else if(auto val=std::dynamic_pointer_cast<IntValue>(value))
+        result=constant(val->getValue(), type);
+    else if(auto val=std::dynamic_pointer_cast<UIntValue>(value))
+        result=constant(val->getValue(), type);
+    else if(auto val=std::dynamic_pointer_cast<LongValue>(value))
+        result=constant(val->getValue(), type);
+    else if(auto val=std::dynamic_pointer_cast<ULongValue>(value))
+        result=constant(val->getValue(), type);
+    else
+        unsupported();
+}
+
+void IRBuilder::visit(VoidExpression* ex){
+    unsupported();
+}
+
+void IRBuilder::visit(LogicalExpression* ex){
+    auto trueBlock=fun->newBlock();
+    auto falseBlock=fun->newBlock();
+    auto endBlock=fun->newBlock();
+
+    lowerLogicalCondition(ex, trueBlock, falseBlock);
+
+    sealBlock(trueBlock);
+    currentBlock=trueBlock;
+    auto trueValue=constant(1, Type::BOOL);
+    jump(endBlock);
+
+    sealBlock(falseBlock);
+    currentBlock=falseBlock;
+    auto falseValue=constant(0, Type::BOOL);
+    jump(endBlock);
+
+    sealBlock(endBlock);
+    currentBlock=endBlock;
+
+    // The preds of the end block are the true block then the false block
+    auto phi=fun->newInstruction(IR::Op::PHI, Type::BOOL, {trueValue, falseValue});
+    phi->block=endBlock;
+    endBlock->instructions.insert(endBlock->instructions.begin(), phi);
+    result=phi;
+}
+
+void IRBuilder::visit(NonStaticVarAccessExpression* ex){
+    unsupported();
+}
+
+void IRBuilder::visit(NonStaticFunInvokeExpression* ex){
+    auto fun=std::dynamic_pointer_cast<BuiltInFunScope>(ex->getFun());
+    auto insideType=ex->getInside()->getReturnType();
+    auto returnType=ex->getReturnType();
+
+    // Only the conversions between integers, they are named after the type they convert to
+    auto isConversion=
+        fun
+        &&!*fun->getDecl()->isOperator
+        &&ex->getArgs()->empty()
+        &&ex->getFunName()==L"_"+*returnType->getName()
+        &&IR::isIntegerType(insideType)
+        &&IR::isIntegerType(returnType)
+    ;
+
+    if(!isConversion){
+        unsupported();
+        return;
+    }
+
+    auto inside=lower(ex->getInside());
+    result=(*insideType==*returnType)?inside:append(IR::Op::CONVERT, returnType, {inside});
+}
+
+void IRBuilder::visit(OperatorFunInvokeExpression* ex){
+    if(!std::dynamic_pointer_cast<BuiltInFunScope>(ex->getFun())){
+        unsupported();
+        return;
+    }
+    result=lowerBuiltInOp(ex);
+}
+
+void IRBuilder::visit(SetOperatorExpression* ex){
+    unsupported();
+}
+
+void IRBuilder::visit(ThisExpression* ex){
+    unsupported();
+}
+
+void IRBuilder::visit(ThisVarAccessExpression* ex){
+    unsupported();
+}
+
+void IRBuilder::visit(ThisFunInvokeExpression* ex){
+    unsupported();
+}
+
+IR::Instruction* IRBuilder::lowerMemoryAccess(BuiltInFunScope* fun, FunInvokeExpression* ex){
+    auto params=fun->getDecl()->params;
+    auto args=ex->getArgs();
+
+    auto isRead=fun->isReadFromAddress()&&args->size()==1;
+    auto isWrite=
+        fun->isWriteToAddress()
+        &&args->size()==2
+        &&IR::isSupportedType((*params)[1]->type)
+    ;
+
+    if(!isRead&&!isWrite)
+        return nullptr;
+
+    auto address=lower((*args)[0]);
+    if(isRead)
+        return append(IR::Op::LOAD, ex->getReturnType(), {address});
+
+    // The value is stored in the size of the param
+    auto valueType=(*params)[1]->type;
+    auto value=lower((*args)[1]);
+    if(*value->type!=*valueType)
+        value=append(IR::Op::CONVERT, valueType, {value});
+
+    return append(IR::Op::STORE, Type::VOID, {address, value});
+}
+
+IR::Instruction* IRBuilder::lowerBuiltInOp(OperatorFunInvokeExpression* ex){
+    using Operator=OperatorFunInvokeExpression::Operator;
+
+    auto op=ex->getOp();
+    auto inside=ex->getInside();
+    auto insideType=inside->getReturnType();
+    auto returnType=ex->getReturnType();
+
+    if(!IR::isSupportedType(insideType)||!IR::isSupportedType(returnType))
+        return nullptr;
+
+    auto isInteger=IR::isIntegerType(insideType);
+
+    switch(op){
+        case Operator::PRE_INC:
+        case Operator::PRE_DEC:
+        case Operator::POST_INC:
+        case Operator::POST_DEC:
+            return (isInteger)?lowerIncOrDec(ex):nullptr;
+        case Operator::UNARY_PLUS:
+            return (isInteger)?lower(inside):nullptr;
+        case Operator::UNARY_MINUS:
+            return (isInteger)?append(IR::Op::NEG, returnType, {lower(inside)}):nullptr;
+        case Operator::BIT_NOT:
+            return (isInteger)?append(IR::Op::NOT, returnType, {lower(inside)}):nullptr;
+        case Operator::LOGICAL_NOT:
+            return (*insideType==*Type::BOOL)?append(IR::Op::LOGICAL_NOT, Type::BOOL, {lower(inside)}):nullptr;
+        default:
+            break;
+    }
+
+    if(!isBinaryOp(op))
+        return nullptr;
+
+    auto arg=(*ex->getArgs())[0];
+
+    if(*arg->getReturnType()!=*insideType)
+        return nullptr;
+
+    auto isEquality=op==Operator::EQUAL_EQUAL||op==Operator::NOT_EQUAL;
+    if(!isInteger&&!isEquality)
+        return nullptr;
+
+    auto irOp=toIROp(op);
+    auto isCompare=isEquality||op==Operator::LESS||op==Operator::LESS_EQUAL||op==Operator::GREATER||op==Operator::GREATER_EQUAL;
+    if(!isCompare&&*returnType!=*insideType)
+        return nullptr;
+
+    auto insideValue=lower(inside);
+    auto argValue=lower(arg);
+    return append(irOp, returnType, {insideValue, argValue});
+}
+
+IR::Instruction* IRBuilder::lowerIncOrDec(OperatorFunInvokeExpression* ex){
+    using Operator=OperatorFunInvokeExpression::Operator;
+
+    auto op=ex->getOp();
+    auto isInc=op==Operator::PRE_INC||op==Operator::POST_INC;
+    auto isPre=op==Operator::PRE_INC||op==Operator::PRE_DEC;
+    auto type=ex->getInside()->getReturnType();
+    auto irOp=(isInc)?IR::Op::ADD:IR::Op::SUB;
+
+    // Called as a function on a value
+    if(!IExpression::isAssignableExpression(ex->getInside()))
+        return append(irOp, type, {lower(ex->getInside()), constant(1, type)});
+
+    auto varAccess=std::dynamic_pointer_cast<VarAccessExpression>(ex->getInside());
+    if(!varAccess)
+        return nullptr;
+
+    auto var=varAccess->getVar().get();
+    auto oldValue=readVar(var);
+    auto newValue=append(irOp, type, {oldValue, constant(1, type)});
+    writeVar(var, newValue);
+
+    return (isPre)?newValue:oldValue;
+}
+
+bool IRBuilder::isBinaryOp(OperatorFunInvokeExpression::Operator op){
+    using Operator=OperatorFunInvokeExpression::Operator;
+    switch(op){
+        case Operator::PLUS:
+        case Operator::MINUS:
+        case Operator::TIMES:
+        case Operator::DIV:
+        case Operator::MOD:
+        case Operator::EQUAL_EQUAL:
+        case Operator::NOT_EQUAL:
+        case Operator::LESS:
+        case Operator::LESS_EQUAL:
+        case Operator::GREATER:
+        case Operator::GREATER_EQUAL:
+        case Operator::SHR:
+        case Operator::SHL:
+        case Operator::BIT_AND:
+        case Operator::XOR:
+        case Operator::BIT_OR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+IR::Op IRBuilder::toIROp(OperatorFunInvokeExpression::Operator op){
+    using Operator=OperatorFunInvokeExpression::Operator;
+    switch(op){
+        case Operator::PLUS: return IR::Op::ADD;
+        case Operator::MINUS: return IR::Op::SUB;
+        case Operator::TIMES: return IR::Op::MUL;
+        case Operator::DIV: return IR::Op::DIV;
+        case Operator::MOD: return IR::Op::MOD;
+        case Operator::EQUAL_EQUAL: return IR::Op::EQ;
+        case Operator::NOT_EQUAL: return IR::Op::NE;
+        case Operator::LESS: return IR::Op::LT;
+        case Operator::LESS_EQUAL: return IR::Op::LE;
+        case Operator::GREATER: return IR::Op::GT;
+        case Operator::GREATER_EQUAL: return IR::Op::GE;
+        case Operator::SHR: return IR::Op::SHR;
+        case Operator::SHL: return IR::Op::SHL;
+        case Operator::BIT_AND: return IR::Op::AND;
+        case Operator::XOR: return IR::Op::XOR;
+        default: return IR::Op::OR;
+    }
+}
+
+IR::Op IRBuilder::toIROp(AugmentedAssignStatement::Operator op){
+    using Operator=AugmentedAssignStatement::Operator;
+    switch(op){
+        case Operator::PLUS: return IR::Op::ADD;
+        case Operator::MINUS: return IR::Op::SUB;
+        case Operator::TIMES: return IR::Op::MUL;
+        case Operator::DIV: return IR::Op::DIV;
+        case Operator::MOD: return IR::Op::MOD;
+        case Operator::SHR: return IR::Op::SHR;
+        case Operator::SHL: return IR::Op::SHL;
+        case Operator::BIT_AND: return IR::Op::AND;
+        case Operator::XOR: return IR::Op::XOR;
+        default: return IR::Op::OR;
+    }
+}
@@ -0,0 +1,561 @@
+#include "IRPasses.hpp"
+#include "Type.hpp"
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <unordered_set>
+
+namespace IR {
+
+    void optimize(Function* fun){
+        removeUnreachableBlocks(fun);
+        propagateCopies(fun);
+        eliminateCommonSubexpressions(fun);
+        propagateCopies(fun);
+        hoistLoopInvariants(fun);
+        reduceInductionVariables(fun);
+        eliminateDeadCode(fun);
+    }
+
+    std::vector<BasicBlock*> getReversePostOrder(Function* fun){
+        std::vector<BasicBlock*> postOrder;
+        std::unordered_set<BasicBlock*> visited;
+
+        // Iterative to not overflow the stack on long functions
+        std::vector<std::pair<BasicBlock*, int>> stack;
+        stack.push_back({fun->getEntry(), 0});
+        visited.insert(fun->getEntry());
+
+        while(!stack.empty()){
+            auto &top=stack.back();
+            auto block=top.first;
+            auto successors=block->getSuccessors();
+
+            // The false target is visited first so the true target ends right after the block
+            std::reverse(successors.begin(), successors.end());
+
+            if(top.second<successors.size()){
+                auto successor=successors[top.second++];
+                if(visited.insert(successor).second)
+                    stack.push_back({successor, 0});
+                continue;
+            }
+
+            postOrder.push_back(block);
+            stack.pop_back();
+        }
+
+        std::reverse(postOrder.begin(), postOrder.end());
+        return postOrder;
+    }
+
+    std::unordered_map<BasicBlock*, BasicBlock*> getDominators(Function* fun){
+        // From "A Simple, Fast Dominance Algorithm" by Cooper, Harvey and Kennedy
+        auto order=getReversePostOrder(fun);
+
+        std::unordered_map<BasicBlock*, int> orderIndex;
+        for(int i=0;i<order.size();i++)
+            orderIndex[order[i]]=i;
+
+        std::unordered_map<BasicBlock*, BasicBlock*> idoms;
+        auto entry=fun->getEntry();
+        idoms[entry]=entry;
+
+        auto intersect=[&](BasicBlock* first, BasicBlock* second){
+            while(first!=second){
+                while(orderIndex[first]>orderIndex[second])
+                    first=idoms[first];
+                while(orderIndex[second]>orderIndex[first])
+                    second=idoms[second];
+            }
+            return first;
+        };
+
+        auto changed=true;
+        while(changed){
+            changed=false;
+            for(int i=1;i<order.size();i++){
+                auto block=order[i];
+                BasicBlock* newIdom=nullptr;
+
+                for(auto pred:block->preds){
+                    if(idoms.find(pred)==idoms.end())
+                        continue;
+                    newIdom=(newIdom)?intersect(pred, newIdom):pred;
+                }
+
+                if(idoms[block]!=newIdom){
+                    idoms[block]=newIdom;
+                    changed=true;
+                }
+            }
+        }
+
+        return idoms;
+    }
+
+    static bool dominates(std::unordered_map<BasicBlock*, BasicBlock*> &idoms, BasicBlock* dominator, BasicBlock* block){
+        while(true){
+            if(block==dominator)
+                return true;
+            auto idom=idoms[block];
+            if(idom==block)
+                return false;
+            block=idom;
+        }
+    }
+
+    void removeUnreachableBlocks(Function* fun){
+        auto order=getReversePostOrder(fun);
+        std::unordered_set<BasicBlock*> reachable(order.begin(), order.end());
+
+        std::vector<BasicBlock*> unreachable;
+        for(auto &block:fun->blocks){
+            if(reachable.find(block.get())==reachable.end())
+                unreachable.push_back(block.get());
+        }
+
+        fun->removeBlocks(unreachable);
+    }
+
+    void propagateCopies(Function* fun){
+        auto changed=true;
+        while(changed){
+            changed=false;
+
+            for(auto &block:fun->blocks){
+                auto &instructions=block->instructions;
+                for(auto instructionIt=instructions.begin();instructionIt!=instructions.end();){
+                    auto phi=*instructionIt;
+                    if(!phi->isPhi())
+                        break;
+
+                    Instruction* same=nullptr;
+                    auto isTrivial=true;
+                    for(auto operand:phi->operands){
+                        if(operand==phi||operand==same)
+                            continue;
+                        if(same){
+                            isTrivial=false;
+                            break;
+                        }
+                        same=operand;
+                    }
+
+                    if(!isTrivial||!same){
+                        instructionIt++;
+                        continue;
+                    }
+
+                    instructionIt=instructions.erase(instructionIt);
+                    fun->replaceAllUses(phi, same);
+                    changed=true;
+                }
+            }
+        }
+    }
+
+    static bool isCommutative(Op op){
+        switch(op){
+            case Op::ADD:
+            case Op::MUL:
+            case Op::AND:
+            case Op::OR:
+            case Op::XOR:
+            case Op::EQ:
+            case Op::NE:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    static std::wstring getValueNumberKey(Instruction* instruction){
+        std::vector<int> operandsIds;
+        for(auto operand:instruction->operands)
+            operandsIds.push_back(operand->id);
+
+        if(isCommutative(instruction->op))
+            std::sort(operandsIds.begin(), operandsIds.end());
+
+        auto key=getOpName(instruction->op)
+            +L":"+*instruction->type->getName()
+            +L":"+std::to_wstring(instruction->imm)
+            +L":"+std::to_wstring((long long)instruction->var)
+        ;
+        for(auto id:operandsIds)
+            key+=L":"+std::to_wstring(id);
+
+        return key;
+    }
+
+    void eliminateCommonSubexpressions(Function* fun){
+        auto idoms=getDominators(fun);
+
+        std::unordered_map<BasicBlock*, std::vector<BasicBlock*>> children;
+        for(auto blockIdom:idoms){
+            if(blockIdom.first!=blockIdom.second)
+                children[blockIdom.second].push_back(blockIdom.first);
+        }
+
+        // The values available in the dominators of the visited block
+        std::unordered_map<std::wstring, Instruction*> available;
+
+        std::function<void(BasicBlock*)> visit=[&](BasicBlock* block){
+            std::vector<std::wstring> addedKeys;
+            auto &instructions=block->instructions;
+
+            for(auto instructionIt=instructions.begin();instructionIt!=instructions.end();){
+                auto instruction=*instructionIt;
+                if(!instruction->isPure()){
+                    instructionIt++;
+                    continue;
+                }
+
+                auto key=getValueNumberKey(instruction);
+                auto availableIt=available.find(key);
+
+                if(availableIt==available.end()){
+                    available[key]=instruction;
+                    addedKeys.push_back(key);
+                    instructionIt++;
+                    continue;
+                }
+
+                instructionIt=instructions.erase(instructionIt);
+                fun->replaceAllUses(instruction, availableIt->second);
+            }
+
+            for(auto child:children[block])
+                visit(child);
+
+            for(auto &key:addedKeys)
+                available.erase(key);
+        };
+
+        visit(fun->getEntry());
+    }
+
+    namespace {
+
+        struct Loop{
+            BasicBlock* header;
+            BasicBlock* preheader; // The only pred of the header from outside the loop, it ends with a jump
+            std::unordered_set<BasicBlock*> blocks;
+
+            bool contains(Instruction* instruction)const{
+                return blocks.find(instruction->block)!=blocks.end();
+            }
+        };
+
+        // The loops that have a preheader, the inner loops come before the outer loops
+        std::vector<Loop> findLoops(Function* fun){
+            auto idoms=getDominators(fun);
+            auto order=getReversePostOrder(fun);
+            std::vector<Loop> loops;
+
+            // The inner loops come after the outer loops in reverse post order
+            for(auto headerIt=order.rbegin();headerIt!=order.rend();headerIt++){
+                auto header=*headerIt;
+
+                // The blocks of the loop are the ones that reach a back edge without passing the header
+                std::unordered_set<BasicBlock*> blocks={header};
+                std::vector<BasicBlock*> worklist;
+                auto hasBackEdge=false;
+                for(auto pred:header->preds){
+                    if(!dominates(idoms, header, pred))
+                        continue;
+                    hasBackEdge=true;
+                    if(blocks.insert(pred).second)
+                        worklist.push_back(pred);
+                }
+
+                if(!hasBackEdge)
+                    continue;
+
+                while(!worklist.empty()){
+                    auto block=worklist.back();
+                    worklist.pop_back();
+                    for(auto pred:block->preds){
+                        if(blocks.insert(pred).second)
+                            worklist.push_back(pred);
+                    }
+                }
+
+                BasicBlock* preheader=nullptr;
+                auto hasUniquePreheader=true;
+                for(auto pred:header->preds){
+                    if(blocks.find(pred)!=blocks.end())
+                        continue;
+                    if(preheader)
+                        hasUniquePreheader=false;
+                    preheader=pred;
+                }
+
+                if(
+                    !hasUniquePreheader
+                    ||!preheader
+                    ||preheader->terminator!=BasicBlock::Terminator::JUMP
+                )
+                    continue;
+
+                loops.push_back({header, preheader, blocks});
+            }
+
+            return loops;
+        }
+
+        // The wrap around of 64 bits values keeps the linear functions of the induction variables exact
+        bool is64BitsInteger(SharedType type){
+            return isIntegerType(type)&&Type::getSize(type.get())==8;
+        }
+
+    }
+
+    void hoistLoopInvariants(Function* fun){
+        auto order=getReversePostOrder(fun);
+
+        for(auto &loop:findLoops(fun)){
+            auto preheader=loop.preheader;
+
+            auto isDefinedOutside=[&](Instruction* instruction){
+                return !loop.contains(instruction);
+            };
+
+            auto changed=true;
+            while(changed){
+                changed=false;
+
+                for(auto block:order){
+                    if(loop.blocks.find(block)==loop.blocks.end())
+                        continue;
+
+                    auto &instructions=block->instructions;
+                    for(auto instructionIt=instructions.begin();instructionIt!=instructions.end();){
+                        auto instruction=*instructionIt;
+
+                        if(
+                            !instruction->isSpeculatable()
+                            ||!std::all_of(instruction->operands.begin(), instruction->operands.end(), isDefinedOutside)
+                        ){
+                            instructionIt++;
+                            continue;
+                        }
+
+                        instructionIt=instructions.erase(instructionIt);
+                        preheader->instructions.push_back(instruction);
+                        instruction->block=preheader;
+                        changed=true;
+                    }
+                }
+            }
+        }
+    }
+
+    void reduceInductionVariables(Function* fun){
+        auto order=getReversePostOrder(fun);
+
+        for(auto &loop:findLoops(fun)){
+            auto header=loop.header;
+            auto preheader=loop.preheader;
+            auto preheaderIndex=header->getPredIndex(preheader);
+
+            auto addToPreheader=[&](Op op, SharedType type, std::vector<Instruction*> operands, long long imm=0){
+                auto instruction=fun->newInstruction(op, type, operands);
+                instruction->imm=imm;
+                instruction->block=preheader;
+                preheader->instructions.push_back(instruction);
+                return instruction;
+            };
+
+            // The basic induction variables, a phi of the header that's incremented by a constant in each back edge
+            std::unordered_map<Instruction*, Instruction*> increments;
+            for(auto phi:header->instructions){
+                if(!phi->isPhi())
+                    break;
+                if(!is64BitsInteger(phi->type))
+                    continue;
+
+                Instruction* increment=nullptr;
+                auto isBasic=true;
+                for(int i=0;i<phi->operands.size();i++){
+                    if(i==preheaderIndex)
+                        continue;
+                    if(increment&&phi->operands[i]!=increment)
+                        isBasic=false;
+                    increment=phi->operands[i];
+                }
+
+                if(
+                    isBasic
+                    &&increment->op==Op::ADD
+                    &&loop.contains(increment)
+                    &&increment->operands[0]==phi
+                    &&increment->operands[1]->op==Op::CONST
+                )
+                    increments[phi]=increment;
+            }
+
+            if(increments.empty())
+                continue;
+
+            struct Derived{
+                Instruction* instruction;
+                Instruction* iv;
+                unsigned long long scale;
+                Instruction* offset;
+            };
+
+            // A basic induction variable as iv, iv*c or iv<<c
+            auto getScaled=[&](Instruction* value, Derived &derived){
+                if(increments.find(value)!=increments.end()){
+                    derived.iv=value;
+                    derived.scale=1;
+                    return true;
+                }
+
+                if((value->op!=Op::MUL&&value->op!=Op::SHL)||!is64BitsInteger(value->type))
+                    return false;
+
+                auto left=value->operands[0];
+                auto right=value->operands[1];
+                if(value->op==Op::MUL&&left->op==Op::CONST)
+                    std::swap(left, right);
+                if(increments.find(left)==increments.end()||right->op!=Op::CONST)
+                    return false;
+
+                derived.iv=left;
+                derived.scale=(value->op==Op::MUL)?right->imm:1ULL<<(right->imm&63);
+                return true;
+            };
+
+            // The derived induction variables, iv*scale+offset where the offset is a loop invariant that isn't a constant
+            std::vector<Derived> derivedValues;
+            for(auto block:order){
+                if(loop.blocks.find(block)==loop.blocks.end())
+                    continue;
+
+                for(auto instruction:block->instructions){
+                    if(instruction->op!=Op::ADD||!is64BitsInteger(instruction->type))
+                        continue;
+
+                    Derived derived{instruction};
+                    auto left=instruction->operands[0];
+                    auto right=instruction->operands[1];
+                    if(getScaled(left, derived))
+                        derived.offset=right;
+                    else if(getScaled(right, derived))
+                        derived.offset=left;
+                    else
+                        continue;
+
+                    if(!loop.contains(derived.offset)&&derived.offset->op!=Op::CONST)
+                        derivedValues.push_back(derived);
+                }
+            }
+
+            // Each one gets a phi of its own that's incremented with its basic induction variable
+            for(auto &derived:derivedValues){
+                auto instruction=derived.instruction;
+                auto type=instruction->type;
+                auto increment=increments[derived.iv];
+
+                // The loops usually start from a constant, mostly 0, so the start is the offset itself
+                auto init=derived.iv->operands[preheaderIndex];
+                auto start=derived.offset;
+                if(init->op!=Op::CONST){
+                    auto scaled=init;
+                    if(derived.scale!=1)
+                        scaled=addToPreheader(Op::MUL, type, {init, addToPreheader(Op::CONST, type, {}, derived.scale)});
+                    start=addToPreheader(Op::ADD, type, {scaled, start});
+                }
+                else if(init->imm!=0)
+                    start=addToPreheader(Op::ADD, type, {start, addToPreheader(Op::CONST, type, {}, (unsigned long long)init->imm*derived.scale)});
+                auto step=addToPreheader(Op::CONST, type, {}, (unsigned long long)increment->operands[1]->imm*derived.scale);
+
+                auto phi=fun->newInstruction(Op::PHI, type, std::vector<Instruction*>(header->preds.size()));
+                phi->block=header;
+                header->instructions.insert(header->instructions.begin(), phi);
+
+                // Right after the increment of the basic induction variable, so it reaches the same back edges
+                auto next=fun->newInstruction(Op::ADD, type, {phi, step});
+                next->block=increment->block;
+                auto &incrementBlockInstructions=increment->block->instructions;
+                incrementBlockInstructions.insert(
+                    std::find(incrementBlockInstructions.begin(), incrementBlockInstructions.end(), increment)+1,
+                    next
+                );
+
+                for(int i=0;i<phi->operands.size();i++)
+                    phi->operands[i]=(i==preheaderIndex)?start:next;
+
+                auto &instructions=instruction->block->instructions;
+                instructions.erase(std::find(instructions.begin(), instructions.end(), instruction));
+                fun->replaceAllUses(instruction, phi);
+            }
+        }
+    }
+
+    void eliminateDeadCode(Function* fun){
+        std::unordered_set<Instruction*> live;
+        std::vector<Instruction*> worklist;
+
+        auto markLive=[&](Instruction* instruction){
+            if(instruction&&live.insert(instruction).second)
+                worklist.push_back(instruction);
+        };
+
+        for(auto &block:fun->blocks){
+            for(auto instruction:block->instructions){
+                if(instruction->hasSideEffects())
+                    markLive(instruction);
+            }
+            markLive(block->value);
+        }
+
+        while(!worklist.empty()){
+            auto instruction=worklist.back();
+            worklist.pop_back();
+            for(auto operand:instruction->operands)
+                markLive(operand);
+        }
+
+        for(auto &block:fun->blocks){
+            auto &instructions=block->instructions;
+            instructions.erase(
+                std::remove_if(
+                    instructions.begin(),
+                    instructions.end(),
+                    [&](Instruction* instruction){return live.find(instruction)==live.end();}
+                ),
+                instructions.end()
+            );
+        }
+    }
+
+    void splitCriticalEdges(Function* fun){
+        std::vector<BasicBlock*> blocks;
+        for(auto &block:fun->blocks)
+            blocks.push_back(block.get());
+
+        for(auto block:blocks){
+            if(block->terminator!=BasicBlock::Terminator::BRANCH)
+                continue;
+
+            for(auto &target:block->targets){
+                if(target->preds.size()<2)
+                    continue;
+
+                auto edgeBlock=fun->newBlock();
+                edgeBlock->terminator=BasicBlock::Terminator::JUMP;
+                edgeBlock->targets[0]=target;
+                edgeBlock->preds.push_back(block);
+
+                // Keeps the order of the preds, so the phis operands stay the same
+                target->preds[target->getPredIndex(block)]=edgeBlock;
+                target=edgeBlock;
+            }
+        }
+    }
+
+}
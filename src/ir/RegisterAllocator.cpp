@@ -0,0 +1,236 @@
+#include "RegisterAllocator.hpp"
+#include <algorithm>
+
+RegisterAllocator::RegisterAllocator(
+    std::vector<IR::BasicBlock*> order,
+    std::function<bool(IR::Instruction*)> needsLocation
+):order(order), needsLocation(needsLocation){}
+
+void RegisterAllocator::allocate(std::vector<int> scratchRegisters, std::vector<int> preservedRegisters){
+    numberInstructions();
+    computeLiveness();
+    buildIntervals();
+
+    std::vector<Interval*> sortedIntervals;
+    for(auto block:order){
+        for(auto instruction:block->instructions){
+            auto intervalIt=intervals.find(instruction);
+            if(intervalIt!=intervals.end())
+                sortedIntervals.push_back(&intervalIt->second);
+        }
+    }
+
+    std::stable_sort(
+        sortedIntervals.begin(),
+        sortedIntervals.end(),
+        [](Interval* first, Interval* second){return first->start<second->start;}
+    );
+
+    std::unordered_set<int> preserved(preservedRegisters.begin(), preservedRegisters.end());
+    std::unordered_set<int> freeRegisters(scratchRegisters.begin(), scratchRegisters.end());
+    freeRegisters.insert(preservedRegisters.begin(), preservedRegisters.end());
+
+    std::vector<Interval*> active;
+
+    auto takeFreeRegister=[&](std::vector<int> &candidates){
+        for(auto reg:candidates){
+            if(freeRegisters.erase(reg))
+                return reg;
+        }
+        return -1;
+    };
+
+    for(auto interval:sortedIntervals){
+
+        // Frees the registers of the intervals that ended
+        for(auto activeIt=active.begin();activeIt!=active.end();){
+            if((*activeIt)->end>=interval->start){
+                activeIt++;
+                continue;
+            }
+            freeRegisters.insert(registers[(*activeIt)->value]);
+            activeIt=active.erase(activeIt);
+        }
+
+        auto reg=-1;
+        if(!interval->isLiveAcrossCall)
+            reg=takeFreeRegister(scratchRegisters);
+        if(reg==-1)
+            reg=takeFreeRegister(preservedRegisters);
+
+        if(reg!=-1){
+            registers[interval->value]=reg;
+            active.push_back(interval);
+            continue;
+        }
+
+        // Spills the interval that ends last, it blocks the register for the longest time
+        Interval* spilled=nullptr;
+        for(auto activeInterval:active){
+            auto activeReg=registers[activeInterval->value];
+            if(interval->isLiveAcrossCall&&preserved.find(activeReg)==preserved.end())
+                continue;
+            if(!spilled||activeInterval->end>spilled->end)
+                spilled=activeInterval;
+        }
+
+        if(!spilled||spilled->end<=interval->end)
+            continue;
+
+        registers[interval->value]=registers[spilled->value];
+        registers.erase(spilled->value);
+        active.erase(std::find(active.begin(), active.end(), spilled));
+        active.push_back(interval);
+    }
+
+    for(auto reg:preservedRegisters){
+        for(auto valueReg:registers){
+            if(valueReg.second==reg){
+                usedPreservedRegisters.push_back(reg);
+                break;
+            }
+        }
+    }
+}
+
+int RegisterAllocator::getRegister(IR::Instruction* value){
+    auto regIt=registers.find(value);
+    return (regIt!=registers.end())?regIt->second:-1;
+}
+
+std::vector<int> RegisterAllocator::getUsedPreservedRegisters(){
+    return usedPreservedRegisters;
+}
+
+void RegisterAllocator::numberInstructions(){
+    // Each instruction takes two positions to keep space between the uses and the defs
+    auto position=0;
+
+    for(auto block:order){
+        blocksStarts[block]=position;
+        position+=2;
+
+        for(auto instruction:block->instructions){
+            if(instruction->isPhi()){
+                positions[instruction]=blocksStarts[block];
+                continue;
+            }
+
+            positions[instruction]=position;
+            if(instruction->op==IR::Op::CALL)
+                callsPositions.push_back(position);
+            position+=2;
+        }
+
+        // The terminator and the phi copies for the successor
+        blocksEnds[block]=position;
+        position+=2;
+    }
+}
+
+void RegisterAllocator::computeLiveness(){
+    auto changed=true;
+
+    while(changed){
+        changed=false;
+
+        for(auto blockIt=order.rbegin();blockIt!=order.rend();blockIt++){
+            auto block=*blockIt;
+            std::unordered_set<IR::Instruction*> live;
+
+            for(auto successor:block->getSuccessors()){
+                auto predIndex=successor->getPredIndex(block);
+                for(auto value:liveIns[successor])
+                    live.insert(value);
+                for(auto instruction:successor->instructions){
+                    if(!instruction->isPhi())
+                        break;
+                    auto operand=instruction->operands[predIndex];
+                    if(needsLocation(operand))
+                        live.insert(operand);
+                }
+            }
+
+            liveOuts[block]=live;
+
+            if(block->value&&needsLocation(block->value))
+                live.insert(block->value);
+
+            for(auto instructionIt=block->instructions.rbegin();instructionIt!=block->instructions.rend();instructionIt++){
+                auto instruction=*instructionIt;
+                live.erase(instruction);
+                if(instruction->isPhi())
+                    continue;
+                for(auto operand:instruction->operands){
+                    if(needsLocation(operand))
+                        live.insert(operand);
+                }
+            }
+
+            if(live!=liveIns[block]){
+                liveIns[block]=live;
+                changed=true;
+            }
+        }
+    }
+}
+
+void RegisterAllocator::buildIntervals(){
+    for(auto block:order){
+        for(auto instruction:block->instructions){
+            if(!needsLocation(instruction))
+                continue;
+
+            extendInterval(instruction, positions[instruction]);
+
+            // The phi is assigned at the end of its preds
+            if(instruction->isPhi()){
+                for(auto pred:block->preds)
+                    extendInterval(instruction, blocksEnds[pred]);
+            }
+        }
+    }
+
+    for(auto block:order){
+        for(auto value:liveIns[block])
+            extendInterval(value, blocksStarts[block]);
+
+        for(auto value:liveOuts[block])
+            extendInterval(value, blocksEnds[block]);
+
+        for(auto instruction:block->instructions){
+            if(instruction->isPhi())
+                continue;
+            for(auto operand:instruction->operands){
+                if(needsLocation(operand))
+                    extendInterval(operand, positions[instruction]);
+            }
+        }
+
+        if(block->value&&needsLocation(block->value))
+            extendInterval(block->value, blocksEnds[block]);
+    }
+
+    for(auto &valueInterval:intervals){
+        auto &interval=valueInterval.second;
+        for(auto callPosition:callsPositions){
+            if(interval.start<callPosition&&callPosition<interval.end){
+                interval.isLiveAcrossCall=true;
+                break;
+            }
+        }
+    }
+}
+
+void RegisterAllocator::extendInterval(IR::Instruction* value, int position){
+    auto intervalIt=intervals.find(value);
+
+    if(intervalIt==intervals.end()){
+        intervals[value]=Interval{.value=value, .start=position, .end=position};
+        return;
+    }
+
+    auto &interval=intervalIt->second;
+    interval.start=std::min(interval.start, position);
+    interval.end=std::max(interval.end, position);
+}
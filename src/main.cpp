@@ -11,6 +11,8 @@
 #include "ClassParser.hpp"
 #include "Compiler.hpp"
 #include "CompilerVarsOffsetSetter.hpp"
+#include "ConstantFoldingVisitor.hpp"
+#include "FunInliningVisitor.hpp"
 #include "ExpressionParser.hpp"
 #include "FileParser.hpp"
 #include "FunDeclParser.hpp"
@@ -37,6 +39,7 @@
 #include "FunScope.hpp"
 #include "Type.hpp"
 #include "Interpreter.hpp"
+#include "InterpreterCachesSetter.hpp"
 #include "VarsOffsetSetter.hpp"
 #include "ainio.hpp"
 #include "string_helper.hpp"
@@ -130,6 +133,18 @@ bool isMainFileOption(std::string o){
     return o=="-m" || o=="--main";
 }
 
+bool isProfileOption(std::string o){
+    return o=="--profile";
+}
+
+bool isAsmOption(std::string o){
+    return o=="--asm";
+}
+
+bool isMarchOption(std::string o){
+    return o.rfind("--march=", 0)==0;
+}
+
 std::string removeExtension(std::string fileName){
     return fileName.substr(0, fileName.find_last_of("."));
 }
@@ -146,8 +161,32 @@ int main(int argc, char * argv[]){
 
     // to make sure that -m or --main is used only once 
     auto mainOptionUsed=false;
+    // to run the program on the interpreter with the sampling profiler instead of compiling it
+    auto profileOptionUsed=false;
+    // to write the generated asm next to the executable for debugging
+    auto asmOptionUsed=false;
+    // to use AVX2 in the vectorized loops with --march=avx2, SSE2 is used by default with --march=x86-64
+    auto avx2OptionUsed=false;
     for(int i=1;i<argc;i++){
 
+        if(isProfileOption(argv[i])){
+            profileOptionUsed=true;
+            continue;
+        }
+
+        if(isAsmOption(argv[i])){
+            asmOptionUsed=true;
+            continue;
+        }
+
+        if(isMarchOption(argv[i])){
+            auto march=std::string(argv[i]).substr(std::string("--march=").size());
+            if(march!="avx2"&&march!="x86-64")
+                throw std::invalid_argument("المعالج غير مدعوم: "+march+"، المتاح avx2 و x86-64");
+            avx2OptionUsed=march=="avx2";
+            continue;
+        }
+
         if(!isMainFileOption(argv[i])){
             filesStack.push_back(argv[i]);
             continue;
@@ -200,68 +239,114 @@ int main(int argc, char * argv[]){
         PackageScope::AIN_PACKAGE->accept(checker);
         
         delete checker;
-        /*
-        auto interpreter=new Interpreter;
-        auto lAssigner=new Interpreter::LeftSideAssigner(interpreter);
-        auto rAssigner=new Interpreter::RightSideAssigner(interpreter);
-        
-        auto varsOffsetSetter=new VarsOffsetSetter(
-            &interpreter->offsets,
-            interpreter->BP,
-            interpreter->BX,
-            interpreter->DS
-        );
 
-        PackageScope::AIN_PACKAGE->accept(varsOffsetSetter);
+        auto constantFolder=new ConstantFoldingVisitor;
+        auto inliner=new FunInliningVisitor;
+
+        // Folding first turns the constant globals into literals, so more args are trivial to substitute
+        PackageScope::AIN_PACKAGE->accept(constantFolder);
+        PackageScope::AIN_PACKAGE->accept(inliner);
+        PackageScope::AIN_PACKAGE->accept(constantFolder);
+
+        delete inliner;
+        delete constantFolder;
+
+        auto main=PackageScope::AIN_PACKAGE->
+            findFileByPath(toWstring(filesStack[0]))->
+            findPublicFunction(L"البداية()");
+
+        auto outputBinName=removeExtension(filesStack[0]);
+
+        if(profileOptionUsed){
+            auto interpreter=new Interpreter;
+            auto lAssigner=new Interpreter::LeftSideAssigner(interpreter);
+            auto rAssigner=new Interpreter::RightSideAssigner(interpreter);
+            auto profiler=new InterpreterProfiler;
+            
+            auto varsOffsetSetter=new VarsOffsetSetter(
+                &interpreter->offsets,
+                interpreter->BP,
+                interpreter->BX,
+                interpreter->DS
+            );
+
+            PackageScope::AIN_PACKAGE->accept(varsOffsetSetter);
+
+            delete varsOffsetSetter;
+
+            auto interpreterCachesSetter=new InterpreterCachesSetter(&interpreter->offsets);
+
+            PackageScope::AIN_PACKAGE->accept(interpreterCachesSetter);
+
+            delete interpreterCachesSetter;
+
+            interpreter->lAssigner=lAssigner;
+            interpreter->rAssigner=rAssigner;
+            interpreter->profiler=profiler;
+
+            PackageScope::AIN_PACKAGE->accept(interpreter); // To init global vars
+
+            profiler->start();
+            try{
+                main->accept(interpreter);
+            }
+            catch(...){
+                // The sampling timer shouldn't keep firing after a failed run
+                profiler->stop();
+                throw;
+            }
+            profiler->stop();
+
+            std::ofstream flatProfileFile(outputBinName+".profile");
+            flatProfileFile<<toCharPointer(profiler->getFlatReport());
+            flatProfileFile.close();
 
-        delete varsOffsetSetter;
+            std::ofstream collapsedProfileFile(outputBinName+".folded");
+            collapsedProfileFile<<toCharPointer(profiler->getCollapsedStacks());
+            collapsedProfileFile.close();
 
-        interpreter->lAssigner=lAssigner;
-        interpreter->rAssigner=rAssigner;
+            delete lAssigner;
+            delete rAssigner;
+            delete profiler;
+            delete interpreter;
 
-        */
+            return 0;
+        }
 
         auto compiler=new Compiler;
+        compiler->isAvx2Enabled=avx2OptionUsed;
         auto compilerVarsOffsetSetter=new CompilerVarsOffsetSetter(&compiler->offsets);
 
         PackageScope::AIN_PACKAGE->accept(compilerVarsOffsetSetter);
 
         delete compilerVarsOffsetSetter;
-        
-        auto main=PackageScope::AIN_PACKAGE->
-            findFileByPath(toWstring(filesStack[0]))->
-            findPublicFunction(L"البداية()");
 
         main->accept(compiler);
 
-        auto generatedAsm=compiler->getAssemblyFile();
+        if(asmOptionUsed){
+            std::vector<char> buffer(64*1024);
+            std::ofstream outputAsmFile;
+            outputAsmFile.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+            outputAsmFile.open(outputBinName+".asm", std::ios::binary|std::ios::trunc);
+            compiler->writeAssemblyFile(outputAsmFile);
+            outputAsmFile.close();
+        }
 
-        // ainprint(generatedAsm, false);
+        // The machine code is encoded and linked in the compiler, so nasm and ld aren't needed
+        auto executable=compiler->getExecutableFile();
 
         delete compiler;
 
-        auto outputBinName=removeExtension(filesStack[0]);
-        auto outputObjFileName=outputBinName+".o";
-        auto outputAsmFileName=outputBinName+".asm";
-
-        std::ofstream outputAsmFile(outputAsmFileName);
-        outputAsmFile<<toCharPointer(generatedAsm);
-        outputAsmFile.close();
-
-        auto command=
-            "nasm -felf64 -o "+outputObjFileName+" -gdwarf "+outputAsmFileName
-            +"; ld "+outputObjFileName+" -o "+outputBinName
-            +"; rm "+outputObjFileName+" "+outputAsmFileName;
-        system(command.c_str());
-        
-        /*
-        PackageScope::AIN_PACKAGE->accept(interpreter); // To init global vars
-        main->accept(interpreter);
-
-        delete lAssigner;
-        delete rAssigner;
-        delete interpreter;
-        */
+        std::ofstream outputBinFile(outputBinName, std::ios::binary|std::ios::trunc);
+        outputBinFile.write(executable.data(), executable.size());
+        outputBinFile.close();
+
+        std::filesystem::permissions(
+            outputBinName,
+            std::filesystem::perms::owner_all|
+            std::filesystem::perms::group_read|std::filesystem::perms::group_exec|
+            std::filesystem::perms::others_read|std::filesystem::perms::others_exec
+        );
 
     }
     catch(std::exception& e){
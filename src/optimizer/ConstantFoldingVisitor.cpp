@@ -0,0 +1,440 @@
+#include "ConstantFoldingVisitor.hpp"
+#include "BuiltInFunScope.hpp"
+#include "LiteralExpression.hpp"
+#include "BoolValue.hpp"
+#include "ByteValue.hpp"
+#include "UByteValue.hpp"
+#include "ShortValue.hpp"
+#include "UShortValue.hpp"
+#include "IntValue.hpp"
+#include "UIntValue.hpp"
+#include "LongValue.hpp"
+#include "ULongValue.hpp"
+#include "CharValue.hpp"
+#include "FloatValue.hpp"
+#include "DoubleValue.hpp"
+#include "Type.hpp"
+#include "Variable.hpp"
+#include <memory>
+
+SharedIExpression ConstantFoldingVisitor::fold(SharedIExpression ex){
+    replacement=nullptr;
+    ex->accept(this);
+    auto folded=(replacement)?replacement:ex;
+    replacement=nullptr;
+    return folded;
+}
+
+void ConstantFoldingVisitor::foldArgs(SharedVector<SharedIExpression> args){
+    for(auto &arg:*args){
+        arg=fold(arg);
+    }
+}
+
+void ConstantFoldingVisitor::foldStmList(StmListScope* scope){
+    auto stmList=scope->getStmList();
+    for(auto stmIt=stmList->begin();stmIt!=stmList->end();){
+        removeStatement=false;
+        (*stmIt)->accept(this);
+        if(removeStatement)
+            stmIt=stmList->erase(stmIt);
+        else
+            stmIt++;
+    }
+    removeStatement=false;
+}
+
+bool ConstantFoldingVisitor::foldGlobals(PackageScope* scope){
+    auto changed=false;
+
+    for(auto fileIt:scope->getFiles()){
+        for(auto stm:*fileIt.second->getGlobalVarsInitStmList()->getStmList()){
+            auto varStm=std::dynamic_pointer_cast<VarStm>(stm);
+            if(!varStm)
+                continue;
+
+            varStm->setEx(fold(varStm->getEx()));
+
+            auto var=varStm->getVar();
+            auto lit=std::dynamic_pointer_cast<LiteralExpression>(varStm->getEx());
+            
+            if(
+                !*var->isValue()||!lit
+                ||
+                // Strings are allocated on every access, so they're not inlined
+                *var->getType()==*Type::STRING
+                ||
+                *lit->getValue()->getType()!=*var->getType()
+                ||
+                constantGlobals.find(var.get())!=constantGlobals.end()
+            )
+                continue;
+
+            constantGlobals[var.get()]=lit->getValue();
+            changed=true;
+        }
+    }
+
+    for(auto packageIt:scope->getPackages()){
+        changed=foldGlobals(packageIt.second.get())||changed;
+    }
+
+    return changed;
+}
+
+void ConstantFoldingVisitor::visit(PackageScope* scope){
+    
+    // A global may be initialized with another global from a file that is not folded yet
+    while(foldGlobals(scope));
+
+    for(auto fileIt:scope->getFiles()){
+        fileIt.second->accept(this);
+    }
+    for(auto packageIt:scope->getPackages()){
+        packageIt.second->accept(this);
+    }
+}
+
+void ConstantFoldingVisitor::visit(FileScope* scope){
+    for(auto classIt:*scope->getPublicClasses()){
+        classIt.second->accept(this);
+    }
+    for(auto classIt:*scope->getPrivateClasses()){
+        classIt.second->accept(this);
+    }
+    for(auto funIt:*scope->getPublicFunctions()){
+        funIt.second->accept(this);
+    }
+    for(auto funIt:*scope->getPrivateFunctions()){
+        funIt.second->accept(this);
+    }
+}
+
+void ConstantFoldingVisitor::visit(ClassScope* scope){
+    // Built-in classes don't have vars init statements
+    if(auto varsInitStmList=scope->getVarsInitStmList())
+        varsInitStmList->accept(this);
+
+    for(auto constructorIt:*scope->getPublicConstructors()){
+        constructorIt.second->accept(this);
+    }
+    for(auto constructorIt:*scope->getPrivateConstructors()){
+        constructorIt.second->accept(this);
+    }
+    for(auto funIt:*scope->getPublicFunctions()){
+        funIt.second->accept(this);
+    }
+    for(auto funIt:*scope->getPrivateFunctions()){
+        funIt.second->accept(this);
+    }
+}
+
+void ConstantFoldingVisitor::visit(FunScope* scope){
+    foldStmList(scope);
+}
+
+void ConstantFoldingVisitor::visit(LoopScope* scope){
+    foldStmList(scope);
+}
+
+void ConstantFoldingVisitor::visit(StmListScope* scope){
+    foldStmList(scope);
+}
+
+void ConstantFoldingVisitor::visit(VarStm* stm){
+    stm->setEx(fold(stm->getEx()));
+}
+
+void ConstantFoldingVisitor::visit(AssignStatement* stm){
+    stm->setRight(fold(stm->getRight()));
+}
+
+void ConstantFoldingVisitor::visit(AugmentedAssignStatement* stm){
+    stm->setRight(fold(stm->getRight()));
+}
+
+void ConstantFoldingVisitor::visit(IfStatement* stm){
+    stm->setIfCondition(fold(stm->getIfCondition()));
+
+    stm->getIfScope()->accept(this);
+
+    auto elseScope=stm->getElseScope();
+
+    if(elseScope)
+        elseScope->accept(this);
+    
+    if(isBoolLiteral(stm->getIfCondition(), true)){
+        stm->setElseScope(nullptr);
+    }
+    else if(isBoolLiteral(stm->getIfCondition(), false)){
+        if(!elseScope){
+            removeStatement=true;
+            return;
+        }
+        stm->setIfCondition(std::make_shared<LiteralExpression>(
+            stm->getLineNumber(),
+            std::make_shared<BoolValue>(true)
+        ));
+        stm->setIfScope(elseScope);
+        stm->setElseScope(nullptr);
+    }
+}
+
+void ConstantFoldingVisitor::visit(WhileStatement* stm){
+    stm->setCondition(fold(stm->getCondition()));
+    stm->getLoopScope()->accept(this);
+}
+
+void ConstantFoldingVisitor::visit(DoWhileStatement* stm){
+    stm->setCondition(fold(stm->getCondition()));
+    stm->getLoopScope()->accept(this);
+}
+
+void ConstantFoldingVisitor::visit(ReturnStatement* stm){
+    stm->setEx(fold(stm->getEx()));
+}
+
+void ConstantFoldingVisitor::visit(ExpressionStatement* stm){
+    stm->setEx(fold(stm->getEx()));
+}
+
+void ConstantFoldingVisitor::visit(VarAccessExpression* ex){
+    auto constantIt=constantGlobals.find(ex->getVar().get());
+    if(constantIt!=constantGlobals.end())
+        replacement=std::make_shared<LiteralExpression>(ex->getLineNumber(),constantIt->second);
+}
+
+void ConstantFoldingVisitor::visit(FunInvokeExpression* ex){
+    foldArgs(ex->getArgs());
+}
+
+void ConstantFoldingVisitor::visit(NewObjectExpression* ex){
+    foldArgs(ex->getArgs());
+}
+
+void ConstantFoldingVisitor::visit(NewArrayExpression* ex){
+    // The elements of a constant array must be literals, so the negative numbers are folded too
+    if(ex->isConstant())
+        foldArgs(ex->getValues());
+}
+
+void ConstantFoldingVisitor::visit(LogicalExpression* ex){
+    ex->setLeft(fold(ex->getLeft()));
+    ex->setRight(fold(ex->getRight()));
+
+    auto isOr=ex->getLogicalOp()==LogicalExpression::Operation::OR;
+    
+    // صواب أو س = صواب، خطأ أو س = س
+    // خطأ و س = خطأ، صواب و س = س
+    if(isBoolLiteral(ex->getLeft(), isOr))
+        replacement=ex->getLeft();
+    else if(isBoolLiteral(ex->getLeft(), !isOr))
+        replacement=ex->getRight();
+    
+    // س أو خطأ = س، س و صواب = س
+    else if(isBoolLiteral(ex->getRight(), !isOr))
+        replacement=ex->getLeft();
+}
+
+void ConstantFoldingVisitor::visit(NonStaticFunInvokeExpression* ex){
+    ex->setInside(fold(ex->getInside()));
+    foldArgs(ex->getArgs());
+}
+
+void ConstantFoldingVisitor::visit(OperatorFunInvokeExpression* ex){
+    ex->setInside(fold(ex->getInside()));
+    
+    auto args=ex->getArgs();
+    foldArgs(args);
+
+    if(!std::dynamic_pointer_cast<BuiltInFunScope>(ex->getFun()))
+        return;
+
+    auto insideLit=std::dynamic_pointer_cast<LiteralExpression>(ex->getInside());
+    if(!insideLit||args->size()>1)
+        return;
+    
+    SharedIValue argValue;
+    if(args->size()==1){
+        auto argLit=std::dynamic_pointer_cast<LiteralExpression>((*args)[0]);
+        if(!argLit)
+            return;
+        argValue=argLit->getValue();
+    }
+
+    if(auto value=foldBuiltInOp(ex->getOp(), insideLit->getValue(), argValue, ex->getReturnType()))
+        replacement=std::make_shared<LiteralExpression>(ex->getLineNumber(),value);
+}
+
+void ConstantFoldingVisitor::visit(SetOperatorExpression* ex){
+    // The get operator has an assignable ex inside, so it's never folded itself
+    fold(ex->getExOfGet());
+    if(auto valueEx=ex->getValueEx())
+        ex->setValueEx(fold(valueEx));
+}
+
+void ConstantFoldingVisitor::visit(ThisFunInvokeExpression* ex){
+    foldArgs(ex->getArgs());
+}
+
+bool ConstantFoldingVisitor::isBoolLiteral(SharedIExpression ex, bool value){
+    auto lit=std::dynamic_pointer_cast<LiteralExpression>(ex);
+    if(!lit)
+        return false;
+    auto boolVal=std::dynamic_pointer_cast<BoolValue>(lit->getValue());
+    return boolVal&&boolVal->getValue()==value;
+}
+
+bool ConstantFoldingVisitor::toInteger(SharedIValue value, IntegerValue& integer){
+    if(auto val=std::dynamic_pointer_cast<ByteValue>(value))
+        integer={(unsigned long long)(long long)val->getValue(), false};
+    else if(auto val=std::dynamic_pointer_cast<UByteValue>(value))
+        integer={(unsigned long long)val->getValue(), true};
+    else if(auto val=std::dynamic_pointer_cast<ShortValue>(value))
+        integer={(unsigned long long)(long long)val->getValue(), false};
+    else if(auto val=std::dynamic_pointer_cast<UShortValue>(value))
+        integer={(unsigned long long)val->getValue(), true};
+    else if(auto val=std::dynamic_pointer_cast<IntValue>(value))
+        integer={(unsigned long long)(long long)val->getValue(), false};
+    else if(auto val=std::dynamic_pointer_cast<UIntValue>(value))
+        integer={(unsigned long long)val->getValue(), true};
+    else if(auto val=std::dynamic_pointer_cast<LongValue>(value))
+        integer={(unsigned long long)val->getValue(), false};
+    else if(auto val=std::dynamic_pointer_cast<ULongValue>(value))
+        integer={val->getValue(), true};
+    else
+        return false;
+    return true;
+}
+
+SharedIValue ConstantFoldingVisitor::toValue(SharedType type, unsigned long long bits){
+    if(*type==*Type::BYTE)
+        return std::make_shared<ByteValue>((signed char)bits);
+    if(*type==*Type::UBYTE)
+        return std::make_shared<UByteValue>((unsigned char)bits);
+    if(*type==*Type::SHORT)
+        return std::make_shared<ShortValue>((short)bits);
+    if(*type==*Type::USHORT)
+        return std::make_shared<UShortValue>((unsigned short)bits);
+    if(*type==*Type::INT)
+        return std::make_shared<IntValue>((int)bits);
+    if(*type==*Type::UINT)
+        return std::make_shared<UIntValue>((unsigned int)bits);
+    if(*type==*Type::LONG)
+        return std::make_shared<LongValue>((long long)bits);
+    if(*type==*Type::ULONG)
+        return std::make_shared<ULongValue>(bits);
+    return nullptr;
+}
+
+SharedIValue ConstantFoldingVisitor::foldBuiltInOp(
+    OperatorFunInvokeExpression::Operator op,
+    SharedIValue insideValue,
+    SharedIValue argValue,
+    SharedType returnType
+){
+    using Operator=OperatorFunInvokeExpression::Operator;
+
+    if(auto boolVal=std::dynamic_pointer_cast<BoolValue>(insideValue)){
+        if(op==Operator::LOGICAL_NOT)
+            return std::make_shared<BoolValue>(!boolVal->getValue());
+        auto argBoolVal=std::dynamic_pointer_cast<BoolValue>(argValue);
+        if(!argBoolVal)
+            return nullptr;
+        if(op==Operator::EQUAL_EQUAL)
+            return std::make_shared<BoolValue>(boolVal->getValue()==argBoolVal->getValue());
+        if(op==Operator::NOT_EQUAL)
+            return std::make_shared<BoolValue>(boolVal->getValue()!=argBoolVal->getValue());
+        return nullptr;
+    }
+
+    if(auto charVal=std::dynamic_pointer_cast<CharValue>(insideValue)){
+        auto argCharVal=std::dynamic_pointer_cast<CharValue>(argValue);
+        if(!argCharVal)
+            return nullptr;
+        if(op==Operator::EQUAL_EQUAL)
+            return std::make_shared<BoolValue>(charVal->getValue()==argCharVal->getValue());
+        if(op==Operator::NOT_EQUAL)
+            return std::make_shared<BoolValue>(charVal->getValue()!=argCharVal->getValue());
+        return nullptr;
+    }
+
+    if(op==Operator::UNARY_MINUS){
+        if(auto floatVal=std::dynamic_pointer_cast<FloatValue>(insideValue))
+            return std::make_shared<FloatValue>(-floatVal->getValue());
+        if(auto doubleVal=std::dynamic_pointer_cast<DoubleValue>(insideValue))
+            return std::make_shared<DoubleValue>(-doubleVal->getValue());
+    }
+
+    IntegerValue a;
+    if(!toInteger(insideValue, a))
+        return nullptr;
+
+    switch(op){
+        case Operator::UNARY_PLUS:
+            return toValue(returnType, a.bits);
+        case Operator::UNARY_MINUS:
+            return toValue(returnType, -a.bits);
+        case Operator::BIT_NOT:
+            return toValue(returnType, ~a.bits);
+        default:
+            break;
+    }
+
+    IntegerValue b;
+    if(!argValue||!toInteger(argValue, b))
+        return nullptr;
+
+    // Mixed signedness depends on how the operands are extended at runtime, so it's left as is
+    if(a.isUnsigned!=b.isUnsigned)
+        return nullptr;
+
+    auto isUnsigned=a.isUnsigned;
+    auto aIsNegative=!isUnsigned&&(long long)a.bits<0;
+    auto bIsNegative=!isUnsigned&&(long long)b.bits<0;
+
+    switch(op){
+        case Operator::PLUS:
+            return toValue(returnType, a.bits+b.bits);
+        case Operator::MINUS:
+            return toValue(returnType, a.bits-b.bits);
+        case Operator::TIMES:
+            return toValue(returnType, a.bits*b.bits);
+        case Operator::BIT_AND:
+            return toValue(returnType, a.bits&b.bits);
+        case Operator::BIT_OR:
+            return toValue(returnType, a.bits|b.bits);
+        case Operator::XOR:
+            return toValue(returnType, a.bits^b.bits);
+        case Operator::SHL:
+            if(bIsNegative||b.bits>=64)
+                return nullptr;
+            return toValue(returnType, a.bits<<b.bits);
+        case Operator::SHR:
+            if(aIsNegative||bIsNegative||b.bits>=64)
+                return nullptr;
+            return toValue(returnType, a.bits>>b.bits);
+        case Operator::DIV:
+            if(aIsNegative||bIsNegative||b.bits==0)
+                return nullptr;
+            return toValue(returnType, a.bits/b.bits);
+        case Operator::MOD:
+            if(aIsNegative||bIsNegative||b.bits==0)
+                return nullptr;
+            return toValue(returnType, a.bits%b.bits);
+        case Operator::EQUAL_EQUAL:
+            return std::make_shared<BoolValue>(a.bits==b.bits);
+        case Operator::NOT_EQUAL:
+            return std::make_shared<BoolValue>(a.bits!=b.bits);
+        case Operator::LESS:
+            return std::make_shared<BoolValue>(isUnsigned?a.bits<b.bits:(long long)a.bits<(long long)b.bits);
+        case Operator::LESS_EQUAL:
+            return std::make_shared<BoolValue>(isUnsigned?a.bits<=b.bits:(long long)a.bits<=(long long)b.bits);
+        case Operator::GREATER:
+            return std::make_shared<BoolValue>(isUnsigned?a.bits>b.bits:(long long)a.bits>(long long)b.bits);
+        case Operator::GREATER_EQUAL:
+            return std::make_shared<BoolValue>(isUnsigned?a.bits>=b.bits:(long long)a.bits>=(long long)b.bits);
+        default:
+            return nullptr;
+    }
+}
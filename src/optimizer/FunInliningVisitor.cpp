@@ -0,0 +1,503 @@
+#include "FunInliningVisitor.hpp"
+#include "BuiltInFunScope.hpp"
+#include "ByteValue.hpp"
+#include "IntValue.hpp"
+#include "LiteralExpression.hpp"
+#include "ShortValue.hpp"
+#include "VarAccessExpression.hpp"
+#include "FunDecl.hpp"
+#include "FunParam.hpp"
+#include "Type.hpp"
+#include "Variable.hpp"
+#include <memory>
+
+SharedIExpression FunInliningVisitor::inlineCalls(SharedIExpression ex){
+    replacement=nullptr;
+    ex->accept(this);
+    auto inlined=(replacement)?replacement:ex;
+    replacement=nullptr;
+    return inlined;
+}
+
+void FunInliningVisitor::inlineCallsInArgs(SharedVector<SharedIExpression> args){
+    for(auto &arg:*args){
+        arg=inlineCalls(arg);
+    }
+}
+
+void FunInliningVisitor::collectGlobals(PackageScope* scope){
+    for(auto fileIt:scope->getFiles()){
+        for(auto varIt:*fileIt.second->getPublicVariables()){
+            globals.insert(varIt.second.get());
+        }
+        for(auto varIt:*fileIt.second->getPrivateVariables()){
+            globals.insert(varIt.second.get());
+        }
+    }
+    for(auto packageIt:scope->getPackages()){
+        collectGlobals(packageIt.second.get());
+    }
+}
+
+void FunInliningVisitor::visit(PackageScope* scope){
+
+    // A function may access globals of a package that is not visited yet
+    if(!globalsCollected){
+        collectGlobals(scope);
+        globalsCollected=true;
+    }
+
+    for(auto fileIt:scope->getFiles()){
+        fileIt.second->accept(this);
+    }
+    for(auto packageIt:scope->getPackages()){
+        packageIt.second->accept(this);
+    }
+}
+
+void FunInliningVisitor::visit(FileScope* scope){
+    scope->getGlobalVarsInitStmList()->accept(this);
+
+    for(auto classIt:*scope->getPublicClasses()){
+        classIt.second->accept(this);
+    }
+    for(auto classIt:*scope->getPrivateClasses()){
+        classIt.second->accept(this);
+    }
+    for(auto funIt:*scope->getPublicFunctions()){
+        funIt.second->accept(this);
+    }
+    for(auto funIt:*scope->getPrivateFunctions()){
+        funIt.second->accept(this);
+    }
+}
+
+void FunInliningVisitor::visit(ClassScope* scope){
+    // Built-in classes don't have vars init statements
+    if(auto varsInitStmList=scope->getVarsInitStmList())
+        varsInitStmList->accept(this);
+
+    for(auto constructorIt:*scope->getPublicConstructors()){
+        constructorIt.second->accept(this);
+    }
+    for(auto constructorIt:*scope->getPrivateConstructors()){
+        constructorIt.second->accept(this);
+    }
+    for(auto funIt:*scope->getPublicFunctions()){
+        funIt.second->accept(this);
+    }
+    for(auto funIt:*scope->getPrivateFunctions()){
+        funIt.second->accept(this);
+    }
+}
+
+void FunInliningVisitor::visit(FunScope* scope){
+
+    // The fun may be visited earlier to inline it in a caller
+    if(!visitedFuns.insert(scope).second)
+        return;
+
+    funsInProgress.insert(scope);
+
+    for(auto stm:*scope->getStmList()){
+        stm->accept(this);
+    }
+
+    funsInProgress.erase(scope);
+}
+
+void FunInliningVisitor::visit(LoopScope* scope){
+    for(auto stm:*scope->getStmList()){
+        stm->accept(this);
+    }
+}
+
+void FunInliningVisitor::visit(StmListScope* scope){
+    for(auto stm:*scope->getStmList()){
+        stm->accept(this);
+    }
+}
+
+void FunInliningVisitor::visit(VarStm* stm){
+    stm->setEx(inlineCalls(stm->getEx()));
+}
+
+void FunInliningVisitor::visit(AssignStatement* stm){
+    // The left ex is assignable, so only the exs inside it are inlined
+    inlineCalls(stm->getLeft());
+    stm->setRight(inlineCalls(stm->getRight()));
+}
+
+void FunInliningVisitor::visit(AugmentedAssignStatement* stm){
+    inlineCalls(stm->getLeft());
+    stm->setRight(inlineCalls(stm->getRight()));
+}
+
+void FunInliningVisitor::visit(IfStatement* stm){
+    stm->setIfCondition(inlineCalls(stm->getIfCondition()));
+    stm->getIfScope()->accept(this);
+    if(auto elseScope=stm->getElseScope())
+        elseScope->accept(this);
+}
+
+void FunInliningVisitor::visit(WhileStatement* stm){
+    stm->setCondition(inlineCalls(stm->getCondition()));
+    stm->getLoopScope()->accept(this);
+}
+
+void FunInliningVisitor::visit(DoWhileStatement* stm){
+    stm->setCondition(inlineCalls(stm->getCondition()));
+    stm->getLoopScope()->accept(this);
+}
+
+void FunInliningVisitor::visit(ReturnStatement* stm){
+    stm->setEx(inlineCalls(stm->getEx()));
+}
+
+void FunInliningVisitor::visit(ExpressionStatement* stm){
+    stm->setEx(inlineCalls(stm->getEx()));
+}
+
+void FunInliningVisitor::visit(FunInvokeExpression* ex){
+    auto args=ex->getArgs();
+    inlineCallsInArgs(args);
+
+    auto candidate=getCandidate(ex->getFun());
+    if(!candidate||!canSubstitute(*candidate, args))
+        return;
+
+    std::unordered_map<Variable*, SharedIExpression> paramsArgs;
+    for(int i=0;i<candidate->params.size();i++){
+        paramsArgs[candidate->params[i]]=(*args)[i];
+    }
+
+    replacement=clone(candidate->body, paramsArgs, ex->getLineNumber());
+}
+
+void FunInliningVisitor::visit(NewObjectExpression* ex){
+    inlineCallsInArgs(ex->getArgs());
+}
+
+void FunInliningVisitor::visit(LogicalExpression* ex){
+    ex->setLeft(inlineCalls(ex->getLeft()));
+    ex->setRight(inlineCalls(ex->getRight()));
+}
+
+void FunInliningVisitor::visit(NonStaticVarAccessExpression* ex){
+    ex->setInside(inlineCalls(ex->getInside()));
+}
+
+void FunInliningVisitor::visit(NonStaticFunInvokeExpression* ex){
+    ex->setInside(inlineCalls(ex->getInside()));
+    inlineCallsInArgs(ex->getArgs());
+}
+
+void FunInliningVisitor::visit(OperatorFunInvokeExpression* ex){
+    ex->setInside(inlineCalls(ex->getInside()));
+    inlineCallsInArgs(ex->getArgs());
+}
+
+void FunInliningVisitor::visit(SetOperatorExpression* ex){
+    inlineCalls(ex->getExOfGet());
+    if(auto valueEx=ex->getValueEx())
+        ex->setValueEx(inlineCalls(valueEx));
+}
+
+void FunInliningVisitor::visit(ThisFunInvokeExpression* ex){
+    inlineCallsInArgs(ex->getArgs());
+}
+
+std::shared_ptr<FunInliningVisitor::InlineCandidate> FunInliningVisitor::getCandidate(SharedFunScope fun){
+    if(!fun||std::dynamic_pointer_cast<BuiltInFunScope>(fun))
+        return nullptr;
+
+    auto candidateIt=candidates.find(fun.get());
+    if(candidateIt!=candidates.end())
+        return candidateIt->second;
+
+    // The fun calls itself directly or through other funs
+    if(funsInProgress.find(fun.get())!=funsInProgress.end())
+        return nullptr;
+
+    // Calls inside the fun are inlined first, so the cost is of the inlined body
+    fun->accept(this);
+
+    auto& candidate=candidates[fun.get()];
+
+    auto decl=fun->getDecl();
+
+    // Only global functions are inlined, as methods may access the object
+    if(decl->isConstructor()||BaseScope::getContainingClass(fun->getParentScope()))
+        return candidate;
+
+    auto stmList=fun->getStmList();
+    if(stmList->size()!=1||!fun->getNonParamsFromLocals()->empty())
+        return candidate;
+
+    auto returnStm=std::dynamic_pointer_cast<ReturnStatement>((*stmList)[0]);
+    if(!returnStm||*returnStm->getEx()->getReturnType()!=*fun->getReturnType())
+        return candidate;
+
+    auto newCandidate=std::make_shared<InlineCandidate>();
+    newCandidate->fun=fun.get();
+    newCandidate->body=returnStm->getEx();
+    newCandidate->hasSideEffects=false;
+
+    auto locals=fun->getLocals();
+    for(auto param:*decl->params){
+        newCandidate->params.push_back((*locals)[*param->name].get());
+        newCandidate->paramsUses.push_back(0);
+        newCandidate->paramsUsedAfterSideEffects.push_back(false);
+    }
+
+    auto cost=0;
+    if(!analyze(newCandidate->body, *newCandidate, cost, 1)||cost>MAX_INLINE_COST)
+        return candidate;
+
+    candidate=newCandidate;
+
+    return candidate;
+}
+
+bool FunInliningVisitor::analyze(SharedIExpression ex, InlineCandidate& candidate, int& cost, int useWeight){
+    cost++;
+
+    // The exs are analyzed in the order of evaluation, so it's known if a param is accessed after a side effect
+
+    if(std::dynamic_pointer_cast<LiteralExpression>(ex))
+        return true;
+
+    if(auto varAccess=std::dynamic_pointer_cast<VarAccessExpression>(ex)){
+        auto var=varAccess->getVar().get();
+        for(int i=0;i<candidate.params.size();i++){
+            if(candidate.params[i]!=var)
+                continue;
+            candidate.paramsUses[i]+=useWeight;
+            if(candidate.hasSideEffects)
+                candidate.paramsUsedAfterSideEffects[i]=true;
+            return true;
+        }
+        if(globals.find(var)==globals.end())
+            return false;
+        candidate.hasSideEffects=true;
+        return true;
+    }
+
+    if(auto logicalEx=std::dynamic_pointer_cast<LogicalExpression>(ex)){
+        // The right ex may not be evaluated, so an arg used there is like an arg used more than once
+        return
+            analyze(logicalEx->getLeft(), candidate, cost, useWeight)
+            &&
+            analyze(logicalEx->getRight(), candidate, cost, useWeight*2)
+        ;
+    }
+
+    if(auto funEx=std::dynamic_pointer_cast<FunInvokeExpression>(ex)){
+        if(funEx->getFun().get()==candidate.fun)
+            return false;
+        for(auto arg:*funEx->getArgs()){
+            if(!analyze(arg, candidate, cost, useWeight))
+                return false;
+        }
+        if(!std::dynamic_pointer_cast<BuiltInFunScope>(funEx->getFun()))
+            cost+=CALL_COST;
+        candidate.hasSideEffects=true;
+        return true;
+    }
+
+    auto nonStaticFunEx=std::dynamic_pointer_cast<NonStaticFunInvokeExpression>(ex);
+    if(!nonStaticFunEx)
+        return false;
+
+    auto opEx=std::dynamic_pointer_cast<OperatorFunInvokeExpression>(ex);
+
+    // It would assign to a param or a global
+    if(opEx&&isIncOrDec(opEx->getOp()))
+        return false;
+
+    if(!analyze(nonStaticFunEx->getInside(), candidate, cost, useWeight))
+        return false;
+    for(auto arg:*nonStaticFunEx->getArgs()){
+        if(!analyze(arg, candidate, cost, useWeight))
+            return false;
+    }
+
+    auto isBuiltIn=std::dynamic_pointer_cast<BuiltInFunScope>(nonStaticFunEx->getFun())!=nullptr;
+
+    if(!isBuiltIn)
+        cost+=CALL_COST;
+
+    // Built-in operators of primitives don't have side effects, except for reading from the heap by the get operator
+    if(!opEx||!isBuiltIn||opEx->getOp()==OperatorFunInvokeExpression::Operator::GET)
+        candidate.hasSideEffects=true;
+
+    return true;
+}
+
+bool FunInliningVisitor::canSubstitute(InlineCandidate& candidate, SharedVector<SharedIExpression> args){
+    auto impureArgsSize=0;
+    auto impureArgIndex=0;
+    auto nonLiteralArgsSize=0;
+
+    for(int i=0;i<args->size();i++){
+        auto arg=(*args)[i];
+        auto uses=candidate.paramsUses[i];
+
+        if(*arg->getReturnType()!=*candidate.params[i]->getType())
+            return false;
+
+        if(Type::getSize(arg->getReturnType().get())<8&&!keepsUpperBits(arg))
+            return false;
+
+        if(!std::dynamic_pointer_cast<LiteralExpression>(arg))
+            nonLiteralArgsSize++;
+
+        if(isTrivial(arg))
+            continue;
+
+        // The arg would be evaluated more than once
+        if(uses>1)
+            return false;
+
+        if(isPure(arg))
+            continue;
+
+        // The side effects of the arg would be lost
+        if(uses==0)
+            return false;
+
+        impureArgsSize++;
+        impureArgIndex=i;
+    }
+
+    if(impureArgsSize==0)
+        return true;
+
+    // The arg is evaluated where its param is accessed, so nothing else may observe or cause side effects before it
+    return impureArgsSize==1&&nonLiteralArgsSize==1&&!candidate.paramsUsedAfterSideEffects[impureArgIndex];
+}
+
+bool FunInliningVisitor::isTrivial(SharedIExpression ex){
+    if(std::dynamic_pointer_cast<LiteralExpression>(ex))
+        return true;
+
+    // Locals of the caller can't be changed by the inlined body
+    auto varAccess=std::dynamic_pointer_cast<VarAccessExpression>(ex);
+    return varAccess&&globals.find(varAccess->getVar().get())==globals.end();
+}
+
+bool FunInliningVisitor::keepsUpperBits(SharedIExpression ex){
+    if(std::dynamic_pointer_cast<VarAccessExpression>(ex))
+        return true;
+
+    auto lit=std::dynamic_pointer_cast<LiteralExpression>(ex);
+    if(!lit)
+        return false;
+
+    // Negative literals are moved sign extended to RAX
+    auto value=lit->getValue();
+    if(auto val=std::dynamic_pointer_cast<ByteValue>(value))
+        return val->getValue()>=0;
+    if(auto val=std::dynamic_pointer_cast<ShortValue>(value))
+        return val->getValue()>=0;
+    if(auto val=std::dynamic_pointer_cast<IntValue>(value))
+        return val->getValue()>=0;
+    return true;
+}
+
+bool FunInliningVisitor::isPure(SharedIExpression ex){
+    if(isTrivial(ex))
+        return true;
+
+    if(auto logicalEx=std::dynamic_pointer_cast<LogicalExpression>(ex))
+        return isPure(logicalEx->getLeft())&&isPure(logicalEx->getRight());
+
+    auto opEx=std::dynamic_pointer_cast<OperatorFunInvokeExpression>(ex);
+    if(!opEx||isIncOrDec(opEx->getOp())||!std::dynamic_pointer_cast<BuiltInFunScope>(opEx->getFun()))
+        return false;
+
+    if(!isPure(opEx->getInside()))
+        return false;
+
+    for(auto arg:*opEx->getArgs()){
+        if(!isPure(arg))
+            return false;
+    }
+
+    return true;
+}
+
+SharedIExpression FunInliningVisitor::clone(
+    SharedIExpression ex,
+    std::unordered_map<Variable*, SharedIExpression>& args,
+    int lineNumber
+){
+    if(auto literalEx=std::dynamic_pointer_cast<LiteralExpression>(ex))
+        return std::make_shared<LiteralExpression>(lineNumber, literalEx->getValue());
+
+    if(auto varAccess=std::dynamic_pointer_cast<VarAccessExpression>(ex)){
+        auto argIt=args.find(varAccess->getVar().get());
+        if(argIt==args.end())
+            return std::make_shared<VarAccessExpression>(lineNumber, varAccess->getVarName(), varAccess->getVar());
+
+        // A trivial arg may be accessed more than once, so it's copied
+        if(isTrivial(argIt->second)){
+            std::unordered_map<Variable*, SharedIExpression> noArgs;
+            return clone(argIt->second, noArgs, lineNumber);
+        }
+        return argIt->second;
+    }
+
+    if(auto logicalEx=std::dynamic_pointer_cast<LogicalExpression>(ex))
+        return std::make_shared<LogicalExpression>(
+            lineNumber,
+            logicalEx->getLogicalOp(),
+            clone(logicalEx->getLeft(), args, lineNumber),
+            clone(logicalEx->getRight(), args, lineNumber)
+        );
+
+    if(auto funEx=std::dynamic_pointer_cast<FunInvokeExpression>(ex)){
+        auto clonedArgs=std::make_shared<std::vector<SharedIExpression>>();
+        for(auto arg:*funEx->getArgs()){
+            clonedArgs->push_back(clone(arg, args, lineNumber));
+        }
+        auto clonedEx=std::make_shared<FunInvokeExpression>(lineNumber, funEx->getFunName(), clonedArgs);
+        clonedEx->setFun(funEx->getFun());
+        clonedEx->setReturnType(funEx->getReturnType());
+        return clonedEx;
+    }
+
+    auto nonStaticFunEx=std::dynamic_pointer_cast<NonStaticFunInvokeExpression>(ex);
+
+    auto clonedArgs=std::make_shared<std::vector<SharedIExpression>>();
+    for(auto arg:*nonStaticFunEx->getArgs()){
+        clonedArgs->push_back(clone(arg, args, lineNumber));
+    }
+    auto clonedInside=clone(nonStaticFunEx->getInside(), args, lineNumber);
+
+    std::shared_ptr<NonStaticFunInvokeExpression> clonedEx;
+
+    if(auto opEx=std::dynamic_pointer_cast<OperatorFunInvokeExpression>(ex))
+        clonedEx=std::make_shared<OperatorFunInvokeExpression>(lineNumber, opEx->getOp(), clonedArgs, clonedInside);
+    else
+        clonedEx=std::make_shared<NonStaticFunInvokeExpression>(
+            lineNumber, nonStaticFunEx->getFunName(), clonedArgs, clonedInside
+        );
+
+    clonedEx->setFun(nonStaticFunEx->getFun());
+    clonedEx->setReturnType(nonStaticFunEx->getReturnType());
+
+    return clonedEx;
+}
+
+bool FunInliningVisitor::isIncOrDec(OperatorFunInvokeExpression::Operator op){
+    return
+        op==OperatorFunInvokeExpression::Operator::PRE_INC
+        ||
+        op==OperatorFunInvokeExpression::Operator::PRE_DEC
+        ||
+        op==OperatorFunInvokeExpression::Operator::POST_INC
+        ||
+        op==OperatorFunInvokeExpression::Operator::POST_DEC
+    ;
+}
@@ -336,6 +336,14 @@ SharedIExpression ExpressionParser::parseNewExpression(){
 
     auto type=typeParserProvider(iterator,scope)->parse();
 
+    // A constant array of its elements between braces, like إنشاء م8{1م8، 2م8}
+    if(iterator->currentMatch(SymbolToken::LEFT_CURLY_BRACES))
+        return std::make_shared<NewArrayExpression>(
+            lineNumber,
+            type,
+            expectArrayValues()
+        );
+
     // The capacity expressions for a multi-dimensional array
     auto arraysCapacities=std::vector<SharedIExpression>();
 
@@ -699,6 +707,33 @@ SharedVector<SharedIExpression> ExpressionParser::expectFunArgs(){
     return args;
 }
 
+SharedVector<SharedIExpression> ExpressionParser::expectArrayValues(){
+
+    expectSymbol(SymbolToken::LEFT_CURLY_BRACES);
+
+    SharedVector<SharedIExpression> values=std::make_shared<std::vector<SharedIExpression>>();
+
+    do{
+
+        if(nextMatch(SymbolToken::RIGHT_CURLY_BRACES))
+            break;
+
+        auto value=parse();
+
+        if(!value)
+            throw ExpressionExpectedException(iterator->lineNumber);
+
+        values->push_back(value);
+
+    }while(iterator->currentMatch(SymbolToken::COMMA));
+
+    expectSymbol(SymbolToken::RIGHT_CURLY_BRACES);
+
+    next();
+
+    return values;
+}
+
 void ExpressionParser::next(){
     prevLineNumber=iterator->lineNumber;
     iterator->next();
@@ -43,6 +43,10 @@ bool Type::operator==(const Type& type)const{
 
     auto otherArray=type.asArray();
 
+    // A constant array can't be passed where its elements may be set
+    if(thisArray->isReadOnly()!=otherArray->isReadOnly())
+        return false;
+
     return *thisArray->getType()==*otherArray->getType();
 }
 
@@ -77,6 +81,7 @@ SharedWString Type::CHAR_NAME=std::make_shared<std::wstring>(L"حرف");
 SharedWString Type::STRING_NAME=std::make_shared<std::wstring>(L"نص");
 SharedWString Type::BOOL_NAME=std::make_shared<std::wstring>(L"منطقي");
 SharedWString Type::ARRAY_NAME=std::make_shared<std::wstring>(L"مصفوفة");
+SharedWString Type::READ_ONLY_NAME=std::make_shared<std::wstring>(L"ثابتة");
 
 SharedType Type::VOID=std::make_shared<Type>(
     VOID_NAME,
@@ -169,19 +174,24 @@ void Type::addBuiltInClassesTo(SharedFileScope fileScope) {
 
 Type::~Type(){}
 
-Type::Array::Array(SharedType type):
+Type::Array::Array(SharedType type, bool readOnly):
     Type(
         std::make_shared<std::wstring>(
-            L"["+*type->getName()+L"]"
+            L"["+*type->getName()+L"]"+(readOnly?L" "+*READ_ONLY_NAME:L"")
         ),
         Type::ARRAY_CLASS
     ),
-    type(type){}
+    type(type),
+    readOnly(readOnly){}
 
 SharedType Type::Array::getType()const{
     return this->type;
 }
 
+bool Type::Array::isReadOnly()const{
+    return this->readOnly;
+}
+
 SharedClassScope Type::Array::getClassScope(){
 
     auto funs=ARRAY_CLASS->getPublicFunctions();
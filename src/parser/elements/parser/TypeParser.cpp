@@ -25,7 +25,14 @@ SharedType TypeParser::parse(){
         auto type=parse();
         expectSymbol(SymbolToken::RIGHT_SQUARE_BRACKET);
         iterator->next();
-        return std::make_shared<Type::Array>(type);
+        auto readOnly=
+            iterator->currentTokenType()==LexerToken::IDENTIFIER_TOKEN
+            &&
+            iterator->currentVal()==*Type::READ_ONLY_NAME
+        ;
+        if(readOnly)
+            iterator->next();
+        return std::make_shared<Type::Array>(type, readOnly);
     }
 
     auto typeId=expectIdentifier();
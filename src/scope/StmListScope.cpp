@@ -43,4 +43,12 @@ SharedVariable StmListScope::getLocalByName(std::wstring varName){
         var=stmListScope->getLocalByName(varName);
     
     return var;
+}
+
+bool StmListScope::hasJumpStatements(){
+    return jumpStatements;
+}
+
+void StmListScope::setHasJumpStatements(bool jumpStatements){
+    this->jumpStatements=jumpStatements;
 }
\ No newline at end of file
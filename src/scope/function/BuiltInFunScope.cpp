@@ -19,6 +19,7 @@
 #include "KeywordToken.hpp"
 #include "LongClassScope.hpp"
 #include "LongValue.hpp"
+#include "NotInterpretableFunException.hpp"
 #include "OperatorFunctions.hpp"
 #include "PackageScope.hpp"
 #include "FunDecl.hpp"
@@ -93,6 +94,9 @@ std::shared_ptr<BuiltInFunScope> BuiltInFunScope::INLINE_ASM=NULL;
 std::shared_ptr<BuiltInFunScope> BuiltInFunScope::INT_TO_CHAR=NULL;
 
 void BuiltInFunScope::invokeOnInterpreter(Interpreter* interpreter){
+    // The built-ins that are only implemented in asm have no interpreter body
+    if(!invokeOnInterpreterFun)
+        throw NotInterpretableFunException(getDecl()->toString());
     invokeOnInterpreterFun(interpreter);
 }
 
@@ -100,6 +104,250 @@ std::vector<Assembler::AsmInstruction> BuiltInFunScope::getGeneratedAsm(Compiler
     return onGenerateAsm(compiler);
 }
 
+bool BuiltInFunScope::isReadFromAddress(){
+    auto name=*getDecl()->name;
+    return name==READ_BYTE_FROM_ADDRESS_NAME||name==READ_LONG_FROM_ADDRESS_NAME;
+}
+
+bool BuiltInFunScope::isWriteToAddress(){
+    return *getDecl()->name==WRITE_TO_ADDRESS_NAME;
+}
+
+/*
+ * The bytes before the first 16 bytes aligned address of the destination are copied one by one,
+ * so the stores of the loop are aligned and "rep movsb" starts from an aligned destination.
+ * Then the small sizes are copied 16 bytes at a time in XMM0 then 8 bytes in RAX, and the rest with "rep movsb",
+ * the large sizes are copied all with "rep movsb" as it's faster than the loop on the processors with fast strings.
+ * The copy is from the first byte, so it's safe when the destination is before the source as in إعادة_حجز
+*/
+std::vector<Assembler::AsmInstruction> BuiltInFunScope::getMemcpyAsm(Compiler* compiler){
+    auto numStr=std::to_wstring(++compiler->currentIfLabelsSize);
+    auto alignLabelStr=L"copyalign"+numStr;
+    auto alignedLabelStr=L"copyaligned"+numStr;
+    auto xmmLabelStr=L"copyxmm"+numStr;
+    auto qwordLabelStr=L"copyqword"+numStr;
+    auto repLabelStr=L"copyrep"+numStr;
+
+    return{
+        Assembler::pop(Assembler::RCX()), // The size
+        Assembler::pop(Assembler::RDI()), // to
+        Assembler::pop(Assembler::RSI()), // from
+        Assembler::localLabel(alignLabelStr),
+        Assembler::test(Assembler::RDI(), Assembler::imm(L"15")),
+        Assembler::jz(Assembler::label(L"."+alignedLabelStr)),
+        Assembler::test(Assembler::RCX(), Assembler::RCX()),
+        Assembler::jz(Assembler::label(L"."+repLabelStr)), // Nothing is left for "rep movsb"
+        Assembler::mov(Assembler::RAX(Assembler::AsmInstruction::BYTE), Assembler::addressMov(Assembler::RSI())),
+        Assembler::mov(Assembler::addressMov(Assembler::RDI()), Assembler::RAX(Assembler::AsmInstruction::BYTE)),
+        Assembler::inc(Assembler::RSI()),
+        Assembler::inc(Assembler::RDI()),
+        Assembler::dec(Assembler::RCX()),
+        Assembler::jmp(Assembler::label(L"."+alignLabelStr)),
+        Assembler::localLabel(alignedLabelStr),
+        Assembler::cmp(Assembler::RCX(), Assembler::imm(std::to_wstring(REP_STRING_MIN_SIZE))),
+        Assembler::jae(Assembler::label(L"."+repLabelStr)),
+        Assembler::localLabel(xmmLabelStr),
+        Assembler::cmp(Assembler::RCX(), Assembler::imm(L"16")),
+        Assembler::jb(Assembler::label(L"."+qwordLabelStr)),
+        Assembler::movdqu(Assembler::XMM0(), Assembler::addressMov(Assembler::RSI())),
+        Assembler::movdqa(Assembler::addressMov(Assembler::RDI()), Assembler::XMM0()),
+        Assembler::add(Assembler::RSI(), Assembler::imm(L"16")),
+        Assembler::add(Assembler::RDI(), Assembler::imm(L"16")),
+        Assembler::sub(Assembler::RCX(), Assembler::imm(L"16")),
+        Assembler::jmp(Assembler::label(L"."+xmmLabelStr)),
+        Assembler::localLabel(qwordLabelStr),
+        Assembler::cmp(Assembler::RCX(), Assembler::imm(L"8")),
+        Assembler::jb(Assembler::label(L"."+repLabelStr)),
+        Assembler::mov(Assembler::RAX(), Assembler::addressMov(Assembler::RSI())),
+        Assembler::mov(Assembler::addressMov(Assembler::RDI()), Assembler::RAX()),
+        Assembler::add(Assembler::RSI(), Assembler::imm(L"8")),
+        Assembler::add(Assembler::RDI(), Assembler::imm(L"8")),
+        Assembler::sub(Assembler::RCX(), Assembler::imm(L"8")),
+        Assembler::localLabel(repLabelStr),
+        Assembler::repMovsb(),
+    };
+}
+
+// The string is appended to the output buffer of ainio.ain with its size, as it's written when the buffer is flushed
+std::vector<Assembler::AsmInstruction> BuiltInFunScope::getPrintAsm(Compiler* compiler, bool isLine){
+    auto writeLabel=compiler->addAinWriteAsm(isLine);
+    return{
+        Assembler::pop(Assembler::RAX()),
+        Assembler::lea(Assembler::RSI(), Assembler::addressLea(Assembler::RAX().value+L"+8")), // first char
+        Assembler::mov(Assembler::RDX(), Assembler::addressMov(Assembler::RAX())), // size
+        Assembler::push(Assembler::RSI(), L"مُعامل العنوان"),
+        Assembler::push(Assembler::RDX(), L"مُعامل الحجم"),
+        Assembler::call(
+            Assembler::label(writeLabel),
+            (isLine)?L"استدعاء دالة اكتب_سطرا_للإخراج(كبير، كبير)":L"استدعاء دالة اكتب_للإخراج(كبير، كبير)"
+        ),
+        Assembler::removeReservedSpaceFromStack(16),
+    };
+}
+
+// The byte is repeated in all bytes of RAX and XMM0, then the memory is filled like getMemcpyAsm
+std::vector<Assembler::AsmInstruction> BuiltInFunScope::getMemsetAsm(Compiler* compiler){
+    auto numStr=std::to_wstring(++compiler->currentIfLabelsSize);
+    auto alignLabelStr=L"fillalign"+numStr;
+    auto alignedLabelStr=L"fillaligned"+numStr;
+    auto xmmLabelStr=L"fillxmm"+numStr;
+    auto qwordLabelStr=L"fillqword"+numStr;
+    auto repLabelStr=L"fillrep"+numStr;
+
+    return{
+        Assembler::pop(Assembler::RAX()), // The value
+        Assembler::pop(Assembler::RCX()), // The size
+        Assembler::pop(Assembler::RDI()), // The address
+        Assembler::movzx(Assembler::RAX(Assembler::AsmInstruction::DWORD), Assembler::RAX(Assembler::AsmInstruction::BYTE)),
+        Assembler::mov(Assembler::RDX(), Assembler::imm(L"0x0101010101010101")),
+        Assembler::imul(Assembler::RAX(), Assembler::RDX()),
+        Assembler::localLabel(alignLabelStr),
+        Assembler::test(Assembler::RDI(), Assembler::imm(L"15")),
+        Assembler::jz(Assembler::label(L"."+alignedLabelStr)),
+        Assembler::test(Assembler::RCX(), Assembler::RCX()),
+        Assembler::jz(Assembler::label(L"."+repLabelStr)), // Nothing is left for "rep stosb"
+        Assembler::mov(Assembler::addressMov(Assembler::RDI()), Assembler::RAX(Assembler::AsmInstruction::BYTE)),
+        Assembler::inc(Assembler::RDI()),
+        Assembler::dec(Assembler::RCX()),
+        Assembler::jmp(Assembler::label(L"."+alignLabelStr)),
+        Assembler::localLabel(alignedLabelStr),
+        Assembler::cmp(Assembler::RCX(), Assembler::imm(std::to_wstring(REP_STRING_MIN_SIZE))),
+        Assembler::jae(Assembler::label(L"."+repLabelStr)),
+        Assembler::movq(Assembler::XMM0(), Assembler::RAX()),
+        Assembler::pshufd(Assembler::XMM0(), Assembler::XMM0(), 0x44),
+        Assembler::localLabel(xmmLabelStr),
+        Assembler::cmp(Assembler::RCX(), Assembler::imm(L"16")),
+        Assembler::jb(Assembler::label(L"."+qwordLabelStr)),
+        Assembler::movdqa(Assembler::addressMov(Assembler::RDI()), Assembler::XMM0()),
+        Assembler::add(Assembler::RDI(), Assembler::imm(L"16")),
+        Assembler::sub(Assembler::RCX(), Assembler::imm(L"16")),
+        Assembler::jmp(Assembler::label(L"."+xmmLabelStr)),
+        Assembler::localLabel(qwordLabelStr),
+        Assembler::cmp(Assembler::RCX(), Assembler::imm(L"8")),
+        Assembler::jb(Assembler::label(L"."+repLabelStr)),
+        Assembler::mov(Assembler::addressMov(Assembler::RDI()), Assembler::RAX()),
+        Assembler::add(Assembler::RDI(), Assembler::imm(L"8")),
+        Assembler::sub(Assembler::RCX(), Assembler::imm(L"8")),
+        Assembler::localLabel(repLabelStr),
+        Assembler::repStosb(),
+    };
+}
+
+std::vector<Assembler::AsmInstruction> BuiltInFunScope::getDivAsm(SharedType type){
+    auto size=Type::getSize(type.get());
+    auto isUnsigned=*type==*Type::UBYTE||*type==*Type::USHORT||*type==*Type::UINT||*type==*Type::ULONG;
+    auto rax=Assembler::RAX(size);
+    auto rcx=Assembler::RCX(size);
+
+    std::vector<Assembler::AsmInstruction> instructions={
+        Assembler::mov(Assembler::RCX(), Assembler::RAX()),
+        Assembler::pop(Assembler::RAX())
+    };
+
+    // Bytes are divided as words to have the remainder in DX instead of AH
+    if(size==Assembler::AsmInstruction::BYTE){
+        rax=Assembler::RAX(Assembler::AsmInstruction::WORD);
+        rcx=Assembler::RCX(Assembler::AsmInstruction::WORD);
+        if(isUnsigned){
+            instructions.push_back(Assembler::movzx(rax, Assembler::RAX(Assembler::AsmInstruction::BYTE)));
+            instructions.push_back(Assembler::movzx(rcx, Assembler::RCX(Assembler::AsmInstruction::BYTE)));
+        }
+        else{
+            instructions.push_back(Assembler::cbw());
+            instructions.push_back(Assembler::movsx(rcx, Assembler::RCX(Assembler::AsmInstruction::BYTE)));
+        }
+        size=Assembler::AsmInstruction::WORD;
+    }
+
+    if(isUnsigned){
+        instructions.push_back(Assembler::zero(Assembler::RDX()));
+        instructions.push_back(Assembler::div(rcx));
+        return instructions;
+    }
+
+    // The dividend is sign extended to RDX in its size
+    switch(size){
+        case Assembler::AsmInstruction::WORD:
+            instructions.push_back(Assembler::cwd());
+            break;
+        case Assembler::AsmInstruction::DWORD:
+            instructions.push_back(Assembler::cdq());
+            break;
+        default:
+            instructions.push_back(Assembler::cqo());
+            break;
+    }
+    instructions.push_back(Assembler::idiv(rcx));
+
+    return instructions;
+}
+
+std::vector<Assembler::AsmInstruction> BuiltInFunScope::getShrAsm(SharedType type){
+    auto size=Type::getSize(type.get());
+
+    std::vector<Assembler::AsmInstruction> instructions={
+        Assembler::mov(Assembler::RCX(), Assembler::RAX()),
+        Assembler::pop(Assembler::RAX())
+    };
+
+    // Writing to the low 32 bits clears the upper half of the register
+    if(size==Assembler::AsmInstruction::DWORD)
+        instructions.push_back(Assembler::mov(Assembler::RAX(size), Assembler::RAX(size)));
+    else if(size<Assembler::AsmInstruction::DWORD)
+        instructions.push_back(Assembler::movzx(Assembler::RAX(Assembler::AsmInstruction::DWORD), Assembler::RAX(size)));
+
+    instructions.push_back(Assembler::shr(Assembler::RAX(), Assembler::RCX(Assembler::AsmInstruction::BYTE)));
+
+    return instructions;
+}
+
+// The byte is repeated in XMM0 and compared with 16 bytes at a time, then the remaining bytes are compared one by one
+std::vector<Assembler::AsmInstruction> BuiltInFunScope::getMemchrAsm(Compiler* compiler){
+    auto numStr=std::to_wstring(++compiler->currentIfLabelsSize);
+    auto xmmLabelStr=L"findxmm"+numStr;
+    auto xmmFoundLabelStr=L"findxmmfound"+numStr;
+    auto byteLabelStr=L"findbyte"+numStr;
+    auto doneLabelStr=L"finddone"+numStr;
+
+    return{
+        Assembler::pop(Assembler::RAX()), // The value
+        Assembler::pop(Assembler::RDX()), // The size
+        Assembler::pop(Assembler::RDI()), // The address
+        Assembler::movzx(Assembler::RAX(Assembler::AsmInstruction::DWORD), Assembler::RAX(Assembler::AsmInstruction::BYTE)),
+        Assembler::mov(Assembler::RCX(), Assembler::imm(L"0x0101010101010101")),
+        Assembler::imul(Assembler::RAX(), Assembler::RCX()),
+        Assembler::movq(Assembler::XMM0(), Assembler::RAX()),
+        Assembler::pshufd(Assembler::XMM0(), Assembler::XMM0(), 0x44),
+        Assembler::zero(Assembler::RCX()), // The index
+        Assembler::localLabel(xmmLabelStr),
+        Assembler::lea(Assembler::RSI(), Assembler::addressLea(Assembler::RCX().value+L"+16")),
+        Assembler::cmp(Assembler::RSI(), Assembler::RDX()),
+        Assembler::ja(Assembler::label(L"."+byteLabelStr)),
+        Assembler::movdqu(Assembler::XMM1(), Assembler::addressMov(Assembler::RDI())),
+        Assembler::packed(Assembler::AsmInstruction::PCMPEQB, Assembler::XMM1(), Assembler::XMM0()),
+        Assembler::pmovmskb(Assembler::RSI(Assembler::AsmInstruction::DWORD), Assembler::XMM1()),
+        Assembler::test(Assembler::RSI(Assembler::AsmInstruction::DWORD), Assembler::RSI(Assembler::AsmInstruction::DWORD)),
+        Assembler::jnz(Assembler::label(L"."+xmmFoundLabelStr)),
+        Assembler::add(Assembler::RDI(), Assembler::imm(L"16")),
+        Assembler::add(Assembler::RCX(), Assembler::imm(L"16")),
+        Assembler::jmp(Assembler::label(L"."+xmmLabelStr)),
+        Assembler::localLabel(xmmFoundLabelStr),
+        Assembler::bsf(Assembler::RSI(Assembler::AsmInstruction::DWORD), Assembler::RSI(Assembler::AsmInstruction::DWORD)),
+        Assembler::add(Assembler::RCX(), Assembler::RSI()),
+        Assembler::jmp(Assembler::label(L"."+doneLabelStr)),
+        Assembler::localLabel(byteLabelStr),
+        Assembler::cmp(Assembler::RCX(), Assembler::RDX()),
+        Assembler::jae(Assembler::label(L"."+doneLabelStr)),
+        Assembler::cmp(Assembler::addressMov(Assembler::RDI()), Assembler::RAX(Assembler::AsmInstruction::BYTE)),
+        Assembler::jz(Assembler::label(L"."+doneLabelStr)),
+        Assembler::inc(Assembler::RDI()),
+        Assembler::inc(Assembler::RCX()),
+        Assembler::jmp(Assembler::label(L"."+byteLabelStr)),
+        Assembler::localLabel(doneLabelStr),
+        Assembler::mov(Assembler::RAX(), Assembler::RCX()),
+    };
+}
+
 void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
 
     if(!INLINE_ASM)
@@ -109,7 +357,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
             std::vector<std::pair<std::wstring, SharedType>>{
                 {STRING_PARAM_NAME,Type::STRING},
             },
-            [](Interpreter* interpreter){}
+            nullptr
         );
     
     auto SYSCALL0=std::make_shared<BuiltInFunScope>(
@@ -118,7 +366,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         std::vector<std::pair<std::wstring, SharedType>>{
             {L"_RAX_",Type::LONG}, // rax
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -135,7 +383,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
             {L"_RAX_",Type::LONG}, // rax
             {L"_RDI_",Type::LONG}, // rdi
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -154,7 +402,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
             {L"_RDI_",Type::LONG}, // rdi
             {L"_RSI_",Type::LONG}, // rsi
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -175,7 +423,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
             {L"_RSI_",Type::LONG}, // rsi
             {L"_RDX_",Type::LONG}, // rdx
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -198,7 +446,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
             {L"_RDX_",Type::LONG}, // rdx
             {L"_R10_",Type::LONG}, // r10
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -223,7 +471,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
             {L"_R10_",Type::LONG}, // r10
             {L"_R8_",Type::LONG} , // r8
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -250,7 +498,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
             {L"_R8_",Type::LONG} , // r8
             {L"_R9_",Type::LONG} , // r9
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -272,7 +520,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         std::vector<std::pair<std::wstring, SharedType>>{
             {L"الإزاحة",Type::LONG},
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -286,6 +534,104 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         }
     );
 
+    auto MEMCPY=std::make_shared<BuiltInFunScope>(
+        MEMCPY_NAME,
+        Type::VOID,
+        std::vector<std::pair<std::wstring, SharedType>>{
+            {L"من",Type::LONG},
+            {L"إلى",Type::LONG},
+            {L"العدد",Type::LONG},
+        },
+        nullptr,
+        false,
+        [](Compiler* compiler){
+            return getMemcpyAsm(compiler);
+        }
+    );
+
+    auto MEMSET=std::make_shared<BuiltInFunScope>(
+        MEMSET_NAME,
+        Type::VOID,
+        std::vector<std::pair<std::wstring, SharedType>>{
+            {ADDRESS_PARAM_NAME,Type::LONG},
+            {L"العدد",Type::LONG},
+            {VALUE_PARAM_NAME,Type::LONG},
+        },
+        nullptr,
+        false,
+        [](Compiler* compiler){
+            return getMemsetAsm(compiler);
+        }
+    );
+
+    auto MEMCHR=std::make_shared<BuiltInFunScope>(
+        MEMCHR_NAME,
+        Type::LONG,
+        std::vector<std::pair<std::wstring, SharedType>>{
+            {ADDRESS_PARAM_NAME,Type::LONG},
+            {L"العدد",Type::LONG},
+            {VALUE_PARAM_NAME,Type::LONG},
+        },
+        nullptr,
+        false,
+        [](Compiler* compiler){
+            return getMemchrAsm(compiler);
+        }
+    );
+
+    // The high 64 bits of the 128 bits product of two unsigned longs
+    auto MUL_HIGH=std::make_shared<BuiltInFunScope>(
+        MUL_HIGH_NAME,
+        Type::ULONG,
+        std::vector<std::pair<std::wstring, SharedType>>{
+            {L"أ",Type::ULONG},
+            {L"ب",Type::ULONG},
+        },
+        nullptr,
+        false,
+        [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
+            return{
+                Assembler::pop(Assembler::RCX()),
+                Assembler::pop(Assembler::RAX()),
+                Assembler::mul(Assembler::RCX()),
+                Assembler::mov(Assembler::RAX(), Assembler::RDX()),
+            };
+        }
+    );
+
+    // The address of the first byte in the string, the size is before it
+    auto STRING_ADDRESS=std::make_shared<BuiltInFunScope>(
+        STRING_ADDRESS_NAME,
+        Type::LONG,
+        std::vector<std::pair<std::wstring, SharedType>>{
+            {STRING_PARAM_NAME,Type::STRING},
+        },
+        nullptr,
+        false,
+        [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
+            return{
+                Assembler::pop(Assembler::RAX()),
+                Assembler::add(Assembler::RAX(), Assembler::imm(L"8")),
+            };
+        }
+    );
+
+    // The address has the size of the array in 8 bytes followed by its bytes, they're used as the array without copying
+    auto ARRAY_AT_ADDRESS=std::make_shared<BuiltInFunScope>(
+        ARRAY_AT_ADDRESS_NAME,
+        std::make_shared<Type::Array>(Type::UBYTE),
+        std::vector<std::pair<std::wstring, SharedType>>{
+            {ADDRESS_PARAM_NAME,Type::LONG},
+        },
+        nullptr,
+        false,
+        [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
+            return{
+                Assembler::pop(Assembler::RAX()),
+            };
+        }
+    );
+
     auto WRITE_CHAR_TO_ADDRESS=std::make_shared<BuiltInFunScope>(
         WRITE_TO_ADDRESS_NAME,
         Type::VOID,
@@ -293,7 +639,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
             {ADDRESS_PARAM_NAME,Type::LONG},
             {CHAR_PARAM_NAME,Type::CHAR},
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -313,7 +659,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
             {ADDRESS_PARAM_NAME,Type::LONG},
             {BYTE_PARAM_NAME,Type::BYTE},
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -333,7 +679,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
             {ADDRESS_PARAM_NAME,Type::LONG},
             {LONG_PARAM_NAME,Type::LONG},
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -352,7 +698,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
             {ADDRESS_PARAM_NAME,Type::LONG},
             {ULONG_PARAM_NAME,Type::ULONG},
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -370,7 +716,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         std::vector<std::pair<std::wstring, SharedType>>{
             {ADDRESS_PARAM_NAME,Type::LONG},
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -386,7 +732,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         std::vector<std::pair<std::wstring, SharedType>>{
             {ADDRESS_PARAM_NAME,Type::LONG},
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -402,7 +748,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         std::vector<std::pair<std::wstring, SharedType>>{
             {ADDRESS_PARAM_NAME,Type::LONG},
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
             return{
@@ -419,6 +765,15 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         [](Interpreter* interpreter){
             auto input=ainread(false);
             interpreter->AX=std::make_shared<StringValue>(input);
+        },
+        false,
+        [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
+            return{
+                Assembler::call(
+                    Assembler::label(compiler->addAinReadAsm(false)),
+                    L"استدعاء دالة أدخل_كلمة()"
+                )
+            };
         }
     );
 
@@ -429,6 +784,15 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         [](Interpreter* interpreter){
             auto input=ainread(true);
             interpreter->AX=std::make_shared<StringValue>(input);
+        },
+        false,
+        [](Compiler* compiler)->std::vector<Assembler::AsmInstruction>{
+            return{
+                Assembler::call(
+                    Assembler::label(compiler->addAinReadAsm(true)),
+                    L"استدعاء دالة أدخل_سطرا()"
+                )
+            };
         }
     );
 
@@ -443,14 +807,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         },
         false,
         [](Compiler* compiler){
-            return std::vector{
-                Assembler::pop(Assembler::RAX()),
-                Assembler::mov(Assembler::RDI(), Assembler::imm(L"1")),
-                Assembler::lea(Assembler::RSI(), Assembler::addressLea(Assembler::RAX().value+L"+8")), // first char
-                Assembler::mov(Assembler::RDX(), Assembler::addressMov(Assembler::RAX())), // size
-                Assembler::mov(Assembler::RAX(), Assembler::imm(L"1")), // sys_write
-                Assembler::syscall(L"طباعة نص")
-            };
+            return getPrintAsm(compiler, false);
         }
     );
 
@@ -465,19 +822,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         },
         false,
         [](Compiler* compiler){
-            return std::vector{
-                Assembler::pop(Assembler::RAX()),
-                Assembler::mov(Assembler::RDI(), Assembler::imm(L"1")),
-                Assembler::lea(Assembler::RSI(), Assembler::addressLea(Assembler::RAX().value+L"+8")), // first char
-                Assembler::mov(Assembler::RDX(), Assembler::addressMov(Assembler::RAX())), // size
-                Assembler::lea(Assembler::R8(), Assembler::addressLea(Assembler::RAX().value+L"+8+"+Assembler::RDX().value)), // The address of the byte after the last char
-                Assembler::mov(Assembler::R9(Assembler::AsmInstruction::BYTE), Assembler::addressMov(Assembler::R8())), // The byte after the last char
-                Assembler::mov(Assembler::addressMov(Assembler::R8()), Assembler::imm(L"0x0a"), Assembler::AsmInstruction::BYTE), // mov '\n' to the address of that byte
-                Assembler::add(Assembler::RDX(), Assembler::imm(L"1")), // add 1 for size for the '\n' char
-                Assembler::mov(Assembler::RAX(), Assembler::imm(L"1")), // sys_write
-                Assembler::syscall(L"طباعة نص"),
-                Assembler::mov(Assembler::addressMov(Assembler::R8()), Assembler::R9(Assembler::AsmInstruction::BYTE)) // restore the byte after the last char
-            };
+            return getPrintAsm(compiler, true);
         }
     );
 
@@ -485,7 +830,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         ROUND_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME,Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler){
             return std::vector{
@@ -500,7 +845,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         ROUND_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME,Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler){
             return std::vector{
@@ -515,7 +860,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         FLOOR_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME,Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler){
             return std::vector{
@@ -530,7 +875,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         FLOOR_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME,Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler){
             return std::vector{
@@ -545,7 +890,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         CEILING_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME,Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler){
             return std::vector{
@@ -560,7 +905,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         CEILING_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME,Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler){
             return std::vector{
@@ -575,7 +920,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         TRUNCATE_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME,Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler){
             return std::vector{
@@ -590,7 +935,7 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         TRUNCATE_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME,Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [](Compiler* compiler){
             return std::vector{
@@ -610,6 +955,12 @@ void BuiltInFunScope::addBuiltInFunctionsTo(SharedFileScope fileScope){
         SYSCALL5,
         SYSCALL6,
         BRK,
+        MEMCPY,
+        MEMSET,
+        MEMCHR,
+        MUL_HIGH,
+        STRING_ADDRESS,
+        ARRAY_AT_ADDRESS,
         WRITE_CHAR_TO_ADDRESS,
         WRITE_BYTE_TO_ADDRESS,
         WRITE_LONG_TO_ADDRESS,
@@ -655,7 +1006,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         LZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -682,7 +1033,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         LOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -710,7 +1061,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         TZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -736,7 +1087,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         TOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -791,7 +1142,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         OperatorFunctions::PLUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -811,7 +1162,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         OperatorFunctions::PLUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -859,7 +1210,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         OperatorFunctions::MINUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -879,7 +1230,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         OperatorFunctions::MINUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -927,7 +1278,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         OperatorFunctions::TIMES_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -947,7 +1298,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         OperatorFunctions::TIMES_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -995,7 +1346,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         OperatorFunctions::DIV_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -1015,7 +1366,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         OperatorFunctions::DIV_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -1105,7 +1456,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         TO_SHORT_NAME,
         Type::SHORT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1118,7 +1469,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         TO_USHORT_NAME,
         Type::USHORT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1131,7 +1482,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         TO_INT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1145,7 +1496,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         TO_UINT_NAME,
         Type::UINT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1159,7 +1510,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         TO_LONG_NAME,
         Type::LONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1174,7 +1525,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         TO_ULONG_NAME,
         Type::ULONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1189,7 +1540,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         TO_FLOAT_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1205,7 +1556,7 @@ void BuiltInFunScope::addBuiltInFunctionsToByteClass(){
         TO_DOUBLE_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1281,7 +1632,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUByteClass(){
         LZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -1308,7 +1659,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUByteClass(){
         LOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -1336,7 +1687,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUByteClass(){
         TZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -1362,7 +1713,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUByteClass(){
         TOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -1567,7 +1918,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUByteClass(){
         TO_SHORT_NAME,
         Type::SHORT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1580,7 +1931,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUByteClass(){
         TO_USHORT_NAME,
         Type::USHORT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1593,7 +1944,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUByteClass(){
         TO_INT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1606,7 +1957,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUByteClass(){
         TO_UINT_NAME,
         Type::UINT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1619,7 +1970,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUByteClass(){
         TO_LONG_NAME,
         Type::LONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1632,7 +1983,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUByteClass(){
         TO_ULONG_NAME,
         Type::ULONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1645,7 +1996,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUByteClass(){
         TO_FLOAT_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1660,7 +2011,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUByteClass(){
         TO_DOUBLE_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -1733,7 +2084,7 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         LZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -1760,7 +2111,7 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         LOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -1788,7 +2139,7 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         TZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -1814,7 +2165,7 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         TOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -1869,14 +2220,13 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         OperatorFunctions::PLUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::movd(Assembler::XMM1(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // 2nd arg
                 Assembler::pop(Assembler::RAX()), // 1st arg
                 // convert 1st arg to float
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2ss(Assembler::XMM0(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::addss(Assembler::XMM0(), Assembler::XMM1()),
@@ -1889,14 +2239,13 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         OperatorFunctions::PLUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::movq(Assembler::XMM1(), Assembler::RAX()), // 2nd arg
                 Assembler::pop(Assembler::RAX()), // 1st arg
                 // convert 1st arg to double
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2sd(Assembler::XMM0(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::addsd(Assembler::XMM0(), Assembler::XMM1()),
@@ -1937,14 +2286,13 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         OperatorFunctions::MINUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::movd(Assembler::XMM1(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // 2nd arg
                 Assembler::pop(Assembler::RAX()), // 1st arg
                 // convert 1st arg to float
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2ss(Assembler::XMM0(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::subss(Assembler::XMM0(), Assembler::XMM1()),
@@ -1957,14 +2305,13 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         OperatorFunctions::MINUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::movq(Assembler::XMM1(), Assembler::RAX()), // 2nd arg
                 Assembler::pop(Assembler::RAX()), // 1st arg
                 // convert 1st arg to double
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2sd(Assembler::XMM0(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::subsd(Assembler::XMM0(), Assembler::XMM1()),
@@ -2005,14 +2352,13 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         OperatorFunctions::TIMES_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::movd(Assembler::XMM1(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // 2nd arg
                 Assembler::pop(Assembler::RAX()), // 1st arg
                 // convert 1st arg to float
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2ss(Assembler::XMM0(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::mulss(Assembler::XMM0(), Assembler::XMM1()),
@@ -2025,14 +2371,13 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         OperatorFunctions::TIMES_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::movq(Assembler::XMM1(), Assembler::RAX()), // 2nd arg
                 Assembler::pop(Assembler::RAX()), // 1st arg
                 // convert 1st arg to double
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2sd(Assembler::XMM0(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::mulsd(Assembler::XMM0(), Assembler::XMM1()),
@@ -2073,14 +2418,13 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         OperatorFunctions::DIV_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::movd(Assembler::XMM1(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // 2nd arg
                 Assembler::pop(Assembler::RAX()), // 1st arg
                 // convert 1st arg to float
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2ss(Assembler::XMM0(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::divss(Assembler::XMM0(), Assembler::XMM1()),
@@ -2093,14 +2437,13 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         OperatorFunctions::DIV_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::movq(Assembler::XMM1(), Assembler::RAX()), // 2nd arg
                 Assembler::pop(Assembler::RAX()), // 1st arg
                 // convert 1st arg to double
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2sd(Assembler::XMM0(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::divsd(Assembler::XMM0(), Assembler::XMM1()),
@@ -2187,11 +2530,10 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         TO_INT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
-                Assembler::cbw(),
                 Assembler::cwde()
             };
         }
@@ -2201,11 +2543,10 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         TO_UINT_NAME,
         Type::UINT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
-                Assembler::cbw(),
                 Assembler::cwde()
             };
         }
@@ -2215,11 +2556,10 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         TO_LONG_NAME,
         Type::LONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cdqe()
             };
@@ -2230,11 +2570,10 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         TO_ULONG_NAME,
         Type::ULONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cdqe()
             };
@@ -2245,11 +2584,10 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         TO_FLOAT_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2ss(Assembler::XMM0(), Assembler::RAX(Assembler::AsmInstruction::DWORD)),
                 Assembler::movd(Assembler::RAX(Assembler::AsmInstruction::DWORD), Assembler::XMM0())
@@ -2261,11 +2599,10 @@ void BuiltInFunScope::addBuiltInFunctionsToShortClass(){
         TO_DOUBLE_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2sd(Assembler::XMM0(), Assembler::RAX(Assembler::AsmInstruction::DWORD)),
                 Assembler::movq(Assembler::RAX(), Assembler::XMM0())
@@ -2337,7 +2674,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUShortClass(){
         LZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -2364,7 +2701,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUShortClass(){
         LOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -2392,7 +2729,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUShortClass(){
         TZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -2418,7 +2755,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUShortClass(){
         TOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -2627,7 +2964,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUShortClass(){
         TO_INT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -2640,7 +2977,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUShortClass(){
         TO_UINT_NAME,
         Type::UINT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -2653,7 +2990,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUShortClass(){
         TO_LONG_NAME,
         Type::LONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -2666,7 +3003,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUShortClass(){
         TO_ULONG_NAME,
         Type::ULONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -2679,7 +3016,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUShortClass(){
         TO_FLOAT_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -2694,7 +3031,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUShortClass(){
         TO_DOUBLE_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -2767,7 +3104,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         LZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -2779,7 +3116,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
                 Assembler::localLabel(ifLabelStr),
                 Assembler::test(Assembler::RAX(), Assembler::RAX()),
                 Assembler::jz(Assembler::label(L"."+elseLabelStr)),
-                Assembler::_and(Assembler::RAX(), Assembler::imm(L"0xFFFFFFFF")),
+                Assembler::mov(Assembler::RAX(Assembler::AsmInstruction::DWORD), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // Clears the upper half
                 Assembler::bsr(Assembler::RAX(), Assembler::RAX()),
                 Assembler::_xor(Assembler::RAX(), Assembler::imm(L"31")),
                 Assembler::jmp(Assembler::label(L"."+endLabelStr)),
@@ -2794,7 +3131,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         LOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -2807,7 +3144,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
                 Assembler::_not(Assembler::RAX()),
                 Assembler::test(Assembler::RAX(), Assembler::RAX()),
                 Assembler::jz(Assembler::label(L"."+elseLabelStr)),
-                Assembler::_and(Assembler::RAX(), Assembler::imm(L"0xFFFFFFFF")),
+                Assembler::mov(Assembler::RAX(Assembler::AsmInstruction::DWORD), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // Clears the upper half
                 Assembler::bsr(Assembler::RAX(), Assembler::RAX()),
                 Assembler::_xor(Assembler::RAX(), Assembler::imm(L"31")),
                 Assembler::jmp(Assembler::label(L"."+endLabelStr)),
@@ -2822,7 +3159,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         TZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -2834,7 +3171,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
                 Assembler::localLabel(ifLabelStr),
                 Assembler::test(Assembler::RAX(), Assembler::RAX()),
                 Assembler::jz(Assembler::label(L"."+elseLabelStr)),
-                Assembler::_and(Assembler::RAX(), Assembler::imm(L"0xFFFFFFFF")),
+                Assembler::mov(Assembler::RAX(Assembler::AsmInstruction::DWORD), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // Clears the upper half
                 Assembler::bsf(Assembler::RAX(), Assembler::RAX()),
                 Assembler::jmp(Assembler::label(L"."+endLabelStr)),
                 Assembler::localLabel(elseLabelStr),
@@ -2848,7 +3185,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         TOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -2861,7 +3198,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
                 Assembler::_not(Assembler::RAX()),
                 Assembler::test(Assembler::RAX(), Assembler::RAX()),
                 Assembler::jz(Assembler::label(L"."+elseLabelStr)),
-                Assembler::_and(Assembler::RAX(), Assembler::imm(L"0xFFFFFFFF")),
+                Assembler::mov(Assembler::RAX(Assembler::AsmInstruction::DWORD), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // Clears the upper half
                 Assembler::bsf(Assembler::RAX(), Assembler::RAX()),
                 Assembler::jmp(Assembler::label(L"."+endLabelStr)),
                 Assembler::localLabel(elseLabelStr),
@@ -2903,7 +3240,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         OperatorFunctions::PLUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -2921,7 +3258,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         OperatorFunctions::PLUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -2967,7 +3304,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         OperatorFunctions::MINUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -2985,7 +3322,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         OperatorFunctions::MINUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -3032,7 +3369,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         OperatorFunctions::TIMES_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -3050,7 +3387,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         OperatorFunctions::TIMES_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -3096,7 +3433,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         OperatorFunctions::DIV_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -3114,7 +3451,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         OperatorFunctions::DIV_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -3210,7 +3547,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         TO_LONG_NAME,
         Type::LONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -3223,7 +3560,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         TO_ULONG_NAME,
         Type::ULONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -3236,7 +3573,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         TO_FLOAT_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -3250,7 +3587,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         TO_DOUBLE_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -3312,7 +3649,7 @@ void BuiltInFunScope::addBuiltInFunctionsToIntClass(){
         BIN_REPRESENTATION_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){}
+        nullptr
     );
 
     auto funs={
@@ -3353,7 +3690,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUIntClass(){
         LZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -3365,7 +3702,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUIntClass(){
                 Assembler::localLabel(ifLabelStr),
                 Assembler::test(Assembler::RAX(), Assembler::RAX()),
                 Assembler::jz(Assembler::label(L"."+elseLabelStr)),
-                Assembler::_and(Assembler::RAX(), Assembler::imm(L"0xFFFFFFFF")),
+                Assembler::mov(Assembler::RAX(Assembler::AsmInstruction::DWORD), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // Clears the upper half
                 Assembler::bsr(Assembler::RAX(), Assembler::RAX()),
                 Assembler::_xor(Assembler::RAX(), Assembler::imm(L"31")),
                 Assembler::jmp(Assembler::label(L"."+endLabelStr)),
@@ -3380,7 +3717,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUIntClass(){
         LOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -3393,7 +3730,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUIntClass(){
                 Assembler::_not(Assembler::RAX()),
                 Assembler::test(Assembler::RAX(), Assembler::RAX()),
                 Assembler::jz(Assembler::label(L"."+elseLabelStr)),
-                Assembler::_and(Assembler::RAX(), Assembler::imm(L"0xFFFFFFFF")),
+                Assembler::mov(Assembler::RAX(Assembler::AsmInstruction::DWORD), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // Clears the upper half
                 Assembler::bsr(Assembler::RAX(), Assembler::RAX()),
                 Assembler::_xor(Assembler::RAX(), Assembler::imm(L"31")),
                 Assembler::jmp(Assembler::label(L"."+endLabelStr)),
@@ -3408,7 +3745,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUIntClass(){
         TZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -3420,7 +3757,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUIntClass(){
                 Assembler::localLabel(ifLabelStr),
                 Assembler::test(Assembler::RAX(), Assembler::RAX()),
                 Assembler::jz(Assembler::label(L"."+elseLabelStr)),
-                Assembler::_and(Assembler::RAX(), Assembler::imm(L"0xFFFFFFFF")),
+                Assembler::mov(Assembler::RAX(Assembler::AsmInstruction::DWORD), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // Clears the upper half
                 Assembler::bsf(Assembler::RAX(), Assembler::RAX()),
                 Assembler::jmp(Assembler::label(L"."+endLabelStr)),
                 Assembler::localLabel(elseLabelStr),
@@ -3434,7 +3771,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUIntClass(){
         TOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -3447,7 +3784,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUIntClass(){
                 Assembler::_not(Assembler::RAX()),
                 Assembler::test(Assembler::RAX(), Assembler::RAX()),
                 Assembler::jz(Assembler::label(L"."+elseLabelStr)),
-                Assembler::_and(Assembler::RAX(), Assembler::imm(L"0xFFFFFFFF")),
+                Assembler::mov(Assembler::RAX(Assembler::AsmInstruction::DWORD), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // Clears the upper half
                 Assembler::bsf(Assembler::RAX(), Assembler::RAX()),
                 Assembler::jmp(Assembler::label(L"."+endLabelStr)),
                 Assembler::localLabel(elseLabelStr),
@@ -3647,7 +3984,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUIntClass(){
         TO_LONG_NAME,
         Type::LONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -3663,7 +4000,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUIntClass(){
         TO_ULONG_NAME,
         Type::ULONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -3679,7 +4016,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUIntClass(){
         TO_FLOAT_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -3693,7 +4030,7 @@ void BuiltInFunScope::addBuiltInFunctionsToUIntClass(){
         TO_DOUBLE_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -3766,7 +4103,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         LZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -3792,7 +4129,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         LOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -3819,7 +4156,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         TZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -3844,7 +4181,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         TOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -3898,7 +4235,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         OperatorFunctions::PLUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -3916,7 +4253,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         OperatorFunctions::PLUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -3962,7 +4299,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         OperatorFunctions::MINUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -3980,7 +4317,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         OperatorFunctions::MINUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4026,7 +4363,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         OperatorFunctions::TIMES_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4044,7 +4381,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         OperatorFunctions::TIMES_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4090,7 +4427,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         OperatorFunctions::DIV_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4108,7 +4445,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         OperatorFunctions::DIV_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4208,7 +4545,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         TO_FLOAT_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -4222,7 +4559,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         TO_DOUBLE_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -4263,7 +4600,7 @@ void BuiltInFunScope::addBuiltInFunctionsToLongClass(){
         BIN_REPRESENTATION_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){}
+        nullptr
     );
 
     auto funs={
@@ -4304,7 +4641,7 @@ void BuiltInFunScope::addBuiltInFunctionsToULongClass(){
         LZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -4330,7 +4667,7 @@ void BuiltInFunScope::addBuiltInFunctionsToULongClass(){
         LOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -4357,7 +4694,7 @@ void BuiltInFunScope::addBuiltInFunctionsToULongClass(){
         TZCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -4382,7 +4719,7 @@ void BuiltInFunScope::addBuiltInFunctionsToULongClass(){
         TOCNT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             auto ifNumStr=std::to_wstring(++compiler->currentIfLabelsSize);
@@ -4598,7 +4935,7 @@ void BuiltInFunScope::addBuiltInFunctionsToULongClass(){
         TO_FLOAT_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -4612,7 +4949,7 @@ void BuiltInFunScope::addBuiltInFunctionsToULongClass(){
         TO_DOUBLE_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -4685,7 +5022,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::PLUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{BYTE_PARAM_NAME, Type::BYTE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4705,14 +5042,13 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::PLUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{SHORT_PARAM_NAME, Type::SHORT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::pop(Assembler::RCX()),
                 Assembler::movd(Assembler::XMM0(), Assembler::RCX(Assembler::AsmInstruction::DWORD)), // first arg
                 // convert 2nd arg to float
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2ss(Assembler::XMM1(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::addss(Assembler::XMM0(), Assembler::XMM1()),
@@ -4725,7 +5061,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::PLUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{INT_PARAM_NAME, Type::INT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4743,7 +5079,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::PLUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{LONG_PARAM_NAME, Type::LONG}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4761,7 +5097,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::PLUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4778,7 +5114,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::PLUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4796,7 +5132,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::MINUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{BYTE_PARAM_NAME, Type::BYTE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4816,14 +5152,13 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::MINUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{SHORT_PARAM_NAME, Type::SHORT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::pop(Assembler::RCX()),
                 Assembler::movd(Assembler::XMM0(), Assembler::RCX(Assembler::AsmInstruction::DWORD)), // first arg
                 // convert 2nd arg to float
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2ss(Assembler::XMM1(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::subss(Assembler::XMM0(), Assembler::XMM1()),
@@ -4836,7 +5171,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::MINUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{INT_PARAM_NAME, Type::INT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4854,7 +5189,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::MINUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{LONG_PARAM_NAME, Type::LONG}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4872,7 +5207,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::MINUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4889,7 +5224,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::MINUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4907,7 +5242,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::TIMES_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{BYTE_PARAM_NAME, Type::BYTE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4927,14 +5262,13 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::TIMES_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{SHORT_PARAM_NAME, Type::BYTE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::pop(Assembler::RCX()),
                 Assembler::movd(Assembler::XMM0(), Assembler::RCX(Assembler::AsmInstruction::DWORD)), // first arg
                 // convert 2nd arg to float
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2ss(Assembler::XMM1(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::mulss(Assembler::XMM0(), Assembler::XMM1()),
@@ -4947,7 +5281,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::TIMES_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{INT_PARAM_NAME, Type::INT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4965,7 +5299,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::TIMES_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{LONG_PARAM_NAME, Type::LONG}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -4983,7 +5317,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::TIMES_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5000,7 +5334,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::TIMES_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5018,7 +5352,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::DIV_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{BYTE_PARAM_NAME, Type::BYTE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5038,14 +5372,13 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::DIV_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{SHORT_PARAM_NAME, Type::BYTE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::pop(Assembler::RCX()),
                 Assembler::movd(Assembler::XMM0(), Assembler::RCX(Assembler::AsmInstruction::DWORD)), // first arg
                 // convert 2nd arg to float
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2ss(Assembler::XMM1(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::divss(Assembler::XMM0(), Assembler::XMM1()),
@@ -5058,7 +5391,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::DIV_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{INT_PARAM_NAME, Type::INT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5076,7 +5409,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::DIV_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{LONG_PARAM_NAME, Type::LONG}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5094,7 +5427,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::DIV_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5111,7 +5444,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::DIV_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5173,7 +5506,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         OperatorFunctions::UNARY_MINUS_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>(),
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5190,7 +5523,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         TO_BYTE_NAME,
         Type::BYTE,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5204,7 +5537,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         TO_UBYTE_NAME,
         Type::UBYTE,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5218,7 +5551,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         TO_SHORT_NAME,
         Type::SHORT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5232,7 +5565,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         TO_USHORT_NAME,
         Type::USHORT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5246,7 +5579,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         TO_INT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5260,7 +5593,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         TO_UINT_NAME,
         Type::UINT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5274,7 +5607,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         TO_LONG_NAME,
         Type::LONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5288,7 +5621,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         TO_ULONG_NAME,
         Type::LONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5304,7 +5637,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         TO_DOUBLE_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5319,7 +5652,7 @@ void BuiltInFunScope::addBuiltInFunctionsToFloatClass(){
         BIN_REPRESENTATION_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){}
+        nullptr
     );
 
     auto funs={
@@ -5353,7 +5686,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::PLUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{BYTE_PARAM_NAME, Type::BYTE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5373,14 +5706,13 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::PLUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{SHORT_PARAM_NAME, Type::SHORT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::pop(Assembler::RCX()),
                 Assembler::movq(Assembler::XMM0(), Assembler::RCX()), // first arg
                 // convert 2nd arg to double
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2sd(Assembler::XMM1(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::addsd(Assembler::XMM0(), Assembler::XMM1()),
@@ -5393,7 +5725,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::PLUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{INT_PARAM_NAME, Type::INT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5411,7 +5743,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::PLUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{LONG_PARAM_NAME, Type::LONG}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5429,7 +5761,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::PLUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5447,7 +5779,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::PLUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5464,7 +5796,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::MINUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{BYTE_PARAM_NAME, Type::BYTE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5484,14 +5816,13 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::MINUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{SHORT_PARAM_NAME, Type::SHORT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::pop(Assembler::RCX()),
                 Assembler::movq(Assembler::XMM0(), Assembler::RCX()), // first arg
                 // convert 2nd arg to double
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2sd(Assembler::XMM1(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::subsd(Assembler::XMM0(), Assembler::XMM1()),
@@ -5504,7 +5835,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::MINUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{INT_PARAM_NAME, Type::INT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5522,7 +5853,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::MINUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{LONG_PARAM_NAME, Type::LONG}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5540,7 +5871,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::MINUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5558,7 +5889,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::MINUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5575,7 +5906,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::TIMES_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{BYTE_PARAM_NAME, Type::BYTE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5595,14 +5926,13 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::TIMES_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{SHORT_PARAM_NAME, Type::SHORT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::pop(Assembler::RCX()),
                 Assembler::movq(Assembler::XMM0(), Assembler::RCX()), // first arg
                 // convert 2nd arg to double
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2sd(Assembler::XMM1(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::mulsd(Assembler::XMM0(), Assembler::XMM1()),
@@ -5615,7 +5945,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::TIMES_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{INT_PARAM_NAME, Type::INT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5633,7 +5963,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::TIMES_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{LONG_PARAM_NAME, Type::LONG}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5651,7 +5981,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::TIMES_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5669,7 +5999,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::TIMES_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5686,7 +6016,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::DIV_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{BYTE_PARAM_NAME, Type::BYTE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5706,14 +6036,13 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::DIV_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{SHORT_PARAM_NAME, Type::SHORT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
                 Assembler::pop(Assembler::RCX()),
                 Assembler::movq(Assembler::XMM0(), Assembler::RCX()), // first arg
                 // convert 2nd arg to double
-                Assembler::cbw(),
                 Assembler::cwde(),
                 Assembler::cvtsi2sd(Assembler::XMM1(), Assembler::RAX(Assembler::AsmInstruction::DWORD)), // dword for optimization
                 Assembler::divsd(Assembler::XMM0(), Assembler::XMM1()),
@@ -5726,7 +6055,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::DIV_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{INT_PARAM_NAME, Type::INT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5744,7 +6073,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::DIV_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{LONG_PARAM_NAME, Type::LONG}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5762,7 +6091,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::DIV_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{FLOAT_PARAM_NAME, Type::FLOAT}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5780,7 +6109,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::DIV_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>{{DOUBLE_PARAM_NAME, Type::DOUBLE}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5841,7 +6170,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         OperatorFunctions::UNARY_MINUS_NAME,
         Type::DOUBLE,
         std::vector<std::pair<std::wstring, SharedType>>(),
-        [](Interpreter* interpreter){},
+        nullptr,
         true,
         [=](Compiler* compiler){
             return std::vector{
@@ -5859,7 +6188,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         TO_BYTE_NAME,
         Type::BYTE,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5873,7 +6202,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         TO_UBYTE_NAME,
         Type::UBYTE,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5887,7 +6216,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         TO_SHORT_NAME,
         Type::SHORT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5901,7 +6230,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         TO_USHORT_NAME,
         Type::USHORT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5915,7 +6244,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         TO_INT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5929,7 +6258,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         TO_UINT_NAME,
         Type::UINT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5943,7 +6272,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         TO_LONG_NAME,
         Type::LONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5957,7 +6286,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         TO_ULONG_NAME,
         Type::ULONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5971,7 +6300,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         TO_FLOAT_NAME,
         Type::FLOAT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -5988,7 +6317,7 @@ void BuiltInFunScope::addBuiltInFunctionsToDoubleClass(){
         BIN_REPRESENTATION_NAME,
         Type::LONG,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){}
+        nullptr
     );
 
     auto funs={
@@ -6043,7 +6372,7 @@ void BuiltInFunScope::addBuiltInFunctionsToBoolClass(){
         TO_INT_NAME,
         Type::INT,
         std::vector<std::pair<std::wstring, SharedType>>{},
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
             return std::vector{
@@ -6120,10 +6449,9 @@ void BuiltInFunScope::addBuiltInFunctionsToStringClass() {
         },
         true,
         [=](Compiler* compiler){
-            auto memcpyLabel=compiler->addAinMemcpyAsm();
             auto allocLabel=compiler->addAinAllocAsm();
 
-            return std::vector{
+            auto _asm=std::vector{
                 Assembler::pop(Assembler::R10()), // The call address
                 Assembler::pop(Assembler::RDI()), // The address of first string (from the stack)
                 Assembler::mov(Assembler::R8(), Assembler::addressMov(Assembler::RDI())), // The size of first string
@@ -6158,16 +6486,18 @@ void BuiltInFunScope::addBuiltInFunctionsToStringClass() {
                 Assembler::add(Assembler::RAX(), Assembler::addressMov(Assembler::RSP(), 24)), // The pointer of (the prev pointer + first string size)
                 Assembler::mov(Assembler::addressMov(Assembler::RSP(),8), Assembler::RAX()), // write 'to' arg for second memcpy
 
-                // second memcpy
-                Assembler::call(Assembler::label(memcpyLabel), L"استدعاء دالة انسخ(كبير، كبير، كبير)"),
-                Assembler::removeReservedSpaceFromStack(24),
-                // first memcpy
-                Assembler::call(Assembler::label(memcpyLabel), L"استدعاء دالة انسخ(كبير، كبير، كبير)"),
-                Assembler::removeReservedSpaceFromStack(24),
-
-                Assembler::pop(Assembler::RAX()), // final return
-                Assembler::ret()
             };
+
+            // second memcpy
+            auto memcpyAsm=getMemcpyAsm(compiler);
+            _asm.insert(_asm.end(), memcpyAsm.begin(), memcpyAsm.end());
+            // first memcpy
+            memcpyAsm=getMemcpyAsm(compiler);
+            _asm.insert(_asm.end(), memcpyAsm.begin(), memcpyAsm.end());
+
+            _asm.push_back(Assembler::pop(Assembler::RAX())); // final return
+            _asm.push_back(Assembler::ret());
+            return _asm;
         }
     );
 
@@ -6182,11 +6512,10 @@ void BuiltInFunScope::addBuiltInFunctionsToStringClass() {
         },
         true,
         [=](Compiler* compiler){
-            auto memcpyLabel=compiler->addAinMemcpyAsm();
             auto allocLabel=compiler->addAinAllocAsm();
             std::wstring cntCharDoneLabel=L"cntCharDone";
 
-            return std::vector{
+            auto _asm=std::vector{
                 Assembler::pop(Assembler::R10()), // The call address
                 Assembler::pop(Assembler::RDI()), // The address of the string (from the stack)
                 
@@ -6227,17 +6556,16 @@ void BuiltInFunScope::addBuiltInFunctionsToStringClass() {
                 Assembler::lea(Assembler::RAX(), Assembler::addressLea(Assembler::RAX().value+L"+8")), // The pointer of first char in new allocated string
                 Assembler::mov(Assembler::addressMov(Assembler::RSP(),8), Assembler::RAX()), // write 'to' arg for memcpy
 
-                // memcpy first string
-                Assembler::call(Assembler::label(memcpyLabel), L"استدعاء دالة انسخ(كبير، كبير، كبير)"),
-                Assembler::pop(Assembler::RDX()), // size of string
-                Assembler::pop(Assembler::RDI()), // to arg
-                Assembler::pop(Assembler::RSI()), // from arg
+            };
+
+            // memcpy first string, RDI will be the address to write the char in it
+            auto memcpyAsm=getMemcpyAsm(compiler);
+            _asm.insert(_asm.end(), memcpyAsm.begin(), memcpyAsm.end());
 
+            auto writeCharAsm=std::vector{
                 Assembler::pop(Assembler::RCX()), // char size
                 Assembler::pop(Assembler::RAX()), // char
 
-                // The address to write the char in it
-                Assembler::lea(Assembler::RDI(), Assembler::addressLea(Assembler::RDI().value+L"+"+Assembler::RDX().value)),
                 // The address of char address + char size to preserve the content of it, as when writing a 3-byte char, this maybe destroy what after the char
                 Assembler::lea(Assembler::RSI(), Assembler::addressLea(Assembler::RDI().value+L"+"+Assembler::RCX().value)),
                 // Preserve what after the char address
@@ -6250,6 +6578,8 @@ void BuiltInFunScope::addBuiltInFunctionsToStringClass() {
                 Assembler::pop(Assembler::RAX()), // final return the new string
                 Assembler::ret()
             };
+            _asm.insert(_asm.end(), writeCharAsm.begin(), writeCharAsm.end());
+            return _asm;
         }
     );
 
@@ -6257,7 +6587,7 @@ void BuiltInFunScope::addBuiltInFunctionsToStringClass() {
         OperatorFunctions::GET_NAME,
         Type::UBYTE,
         std::vector<std::pair<std::wstring, SharedType>>{{INDEX_PARAM_NAME,Type::ULONG}},
-        [](Interpreter* interpreter){},
+        nullptr,
         true
         // The compilation is same as array
     );
@@ -6330,12 +6660,11 @@ void BuiltInFunScope::addBuiltInFunctionsToStringClass() {
         std::vector<std::pair<std::wstring, SharedType>>{
             {L"مصفوفة_م1",std::make_shared<Type>(Type::Array(Type::UBYTE))}
         },
-        [](Interpreter* interpreter){},
+        nullptr,
         false,
         [=](Compiler* compiler){
-            auto memcpyLabel=compiler->addAinMemcpyAsm();
             auto allocLabel=compiler->addAinAllocAsm();
-            return std::vector{
+            auto _asm=std::vector{
                 Assembler::mov(Assembler::RDX(), Assembler::addressMov(Assembler::RAX())), // The size of array
                 Assembler::push(Assembler::imm(L"0")), // preserve space for new string for final return
                 Assembler::push(Assembler::RAX()), // preserve 'from' arg for memcpy
@@ -6345,12 +6674,13 @@ void BuiltInFunScope::addBuiltInFunctionsToStringClass() {
                 Assembler::call(Assembler::label(allocLabel), L"استدعاء دالة احجز(كبير)"),
                 Assembler::mov(Assembler::addressMov(Assembler::RSP(),8), Assembler::RAX()), // 'to' arg for memcpy
                 Assembler::mov(Assembler::addressMov(Assembler::RSP(),24), Assembler::RAX()), // final return string
-                // memcpy
-                Assembler::call(Assembler::label(memcpyLabel), L"استدعاء دالة انسخ(كبير، كبير، كبير)"),
-                Assembler::removeReservedSpaceFromStack(24),
-                Assembler::pop(Assembler::RAX()), // final return
-                Assembler::ret()
             };
+            // memcpy
+            auto memcpyAsm=getMemcpyAsm(compiler);
+            _asm.insert(_asm.end(), memcpyAsm.begin(), memcpyAsm.end());
+            _asm.push_back(Assembler::pop(Assembler::RAX())); // final return
+            _asm.push_back(Assembler::ret());
+            return _asm;
         }
     );
 
@@ -6376,9 +6706,9 @@ void BuiltInFunScope::addBuiltInFunctionsToArrayClass(){
         std::vector<std::pair<std::wstring, SharedType>>{{INDEX_PARAM_NAME,Type::ULONG}},
         [](Interpreter* interpreter){
             auto arrayAddress=std::dynamic_pointer_cast<RefValue>(interpreter->AX)->getAddress();
-            auto index=std::dynamic_pointer_cast<IntValue>(interpreter->CX)->getValue();
+            auto index=std::dynamic_pointer_cast<ULongValue>(interpreter->CX)->getValue();
             auto arraySize=std::dynamic_pointer_cast<IntValue>(interpreter->memory[arrayAddress])->getValue();
-            if(index>=arraySize)
+            if(index>=static_cast<unsigned long long>(arraySize))
                 throw ArrayIndexOutOfRangeException(arraySize,index);
             interpreter->AX=interpreter->memory[arrayAddress+index+1];
         },
@@ -6394,9 +6724,9 @@ void BuiltInFunScope::addBuiltInFunctionsToArrayClass(){
         },
         [](Interpreter* interpreter){
             auto arrayAddress=std::dynamic_pointer_cast<RefValue>(interpreter->AX)->getAddress();
-            auto index=std::dynamic_pointer_cast<IntValue>(interpreter->CX)->getValue();
+            auto index=std::dynamic_pointer_cast<ULongValue>(interpreter->CX)->getValue();
             auto arraySize=std::dynamic_pointer_cast<IntValue>(interpreter->memory[arrayAddress])->getValue();
-            if(index>=arraySize)
+            if(index>=static_cast<unsigned long long>(arraySize))
                 throw ArrayIndexOutOfRangeException(arraySize,index);
             auto value=interpreter->DX;
             interpreter->memory[arrayAddress+index+1]=value;
@@ -6441,6 +6771,20 @@ void BuiltInFunScope::addBuiltInFunctionsToArrayClass(){
         }
     );
 
+    // The elements are after the size of the array in 8 bytes
+    auto ELEMENTS_ADDRESS=std::make_shared<BuiltInFunScope>(
+        ELEMENTS_ADDRESS_NAME,
+        Type::LONG,
+        std::vector<std::pair<std::wstring, SharedType>>{},
+        nullptr,
+        false,
+        [](Compiler* compiler){
+            return std::vector{
+                Assembler::add(Assembler::RAX(), Assembler::imm(L"8"))
+            };
+        }
+    );
+
     ArrayClassScope::GET=GET;
     ArrayClassScope::SET=SET;
 
@@ -6448,7 +6792,8 @@ void BuiltInFunScope::addBuiltInFunctionsToArrayClass(){
         GET,
         SET,
         IS_EMPTY,
-        IS_NOT_EMPTY
+        IS_NOT_EMPTY,
+        ELEMENTS_ADDRESS
     };
 
     auto publicFuns=classScope->getPublicFunctions();
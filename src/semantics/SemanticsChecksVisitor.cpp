@@ -9,6 +9,7 @@
 #include "MustHaveExplicitTypeException.hpp"
 #include "OnlyVariablesAreAssignableException.hpp"
 #include "OperatorFunctions.hpp"
+#include "ReadOnlyArrayException.hpp"
 #include "SharedPtrTypes.hpp"
 #include "Type.hpp"
 #include "TypeMismatchException.hpp"
@@ -468,6 +469,21 @@ void SemanticsChecksVisitor::visit(NewObjectExpression* ex){
 }
 
 void SemanticsChecksVisitor::visit(NewArrayExpression* ex){
+    if(ex->isConstant()){
+        auto elementType=ex->getReturnType()->asArray()->getType();
+        for(auto value:*ex->getValues()){
+            value->accept(this);
+            auto valueType=value->getReturnType();
+            if(valueType->getClassScope()!=elementType->getClassScope())
+                throw UnexpectedTypeException(
+                    value->getLineNumber(),
+                    *elementType->getName(),
+                    *valueType->getName()
+                );
+        }
+        return;
+    }
+
     for(auto cap:ex->getCapacities()){
         cap->accept(this);
         auto capType=cap->getReturnType();
@@ -1056,6 +1072,10 @@ SharedFunScope SemanticsChecksVisitor::findOpFunInType(
     std::vector<SharedType> paramsTypes,
     int traceLineNumber
 ){
+    auto array=type->asArray();
+    if(funName==OperatorFunctions::SET_NAME&&array&&array->isReadOnly())
+        throw ReadOnlyArrayException(traceLineNumber, *type->getName());
+
     auto fun=findFunInType(
         type,
         funName,
@@ -18,4 +18,8 @@ SharedIExpression AssignStatement::getLeft()const{
 
 SharedIExpression AssignStatement::getRight()const{
     return right;
+}
+
+void AssignStatement::setRight(SharedIExpression right){
+    this->right=right;
 }
\ No newline at end of file
@@ -11,4 +11,8 @@ ExpressionStatement::ExpressionStatement(
 
 SharedIExpression ExpressionStatement::getEx()const{
     return ex;
+}
+
+void ExpressionStatement::setEx(SharedIExpression ex){
+    this->ex=ex;
 }
\ No newline at end of file
@@ -29,4 +29,16 @@ SharedStmListScope IfStatement::getIfScope()const{
 
 SharedStmListScope IfStatement::getElseScope()const{
     return elseScope;
+}
+
+void IfStatement::setIfCondition(SharedIExpression ifCondition){
+    this->ifCondition=ifCondition;
+}
+
+void IfStatement::setIfScope(SharedStmListScope ifScope){
+    this->ifScope=ifScope;
+}
+
+void IfStatement::setElseScope(SharedStmListScope elseScope){
+    this->elseScope=elseScope;
 }
\ No newline at end of file
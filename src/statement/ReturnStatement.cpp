@@ -17,4 +17,8 @@ ReturnStatement::ReturnStatement(
 
 SharedIExpression ReturnStatement::getEx()const{
     return ex;
+}
+
+void ReturnStatement::setEx(SharedIExpression ex){
+    this->ex=ex;
 }
\ No newline at end of file
@@ -20,4 +20,21 @@ SharedVariable VarStm::getVar()const{
 
 SharedIExpression VarStm::getEx()const{
     return ex;
+}
+
+void VarStm::setEx(SharedIExpression ex){
+    this->ex=ex;
+}
+
+int* VarStm::getSlotReg()const{
+    return slotReg;
+}
+
+int VarStm::getSlotOffset()const{
+    return slotOffset;
+}
+
+void VarStm::setSlot(int* reg,int offset){
+    this->slotReg=reg;
+    this->slotOffset=offset;
 }
\ No newline at end of file
@@ -23,4 +23,8 @@ SharedIExpression WhileStatement::getCondition()const{
 
 SharedLoopScope WhileStatement::getLoopScope()const{
     return loopScope;
+}
+
+void WhileStatement::setCondition(SharedIExpression condition){
+    this->condition=condition;
 }
\ No newline at end of file
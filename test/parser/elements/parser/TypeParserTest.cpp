@@ -94,6 +94,26 @@ TEST_CASE("TypeParser tests","[TypeParserTest.cpp]"){
 
     }
 
+    SECTION("parsing a read-only array"){
+        TypeParser parser(
+            getTokensIterator({
+                SymbolToken::LEFT_SQUARE_BRACKET,
+                LexerToken::IdentifierToken(*Type::INT->getName()),
+                SymbolToken::RIGHT_SQUARE_BRACKET,
+                LexerToken::IdentifierToken(*Type::READ_ONLY_NAME)
+            }),
+            scope,
+            fakeTypeChecker
+        );
+
+        auto type=parser.parse();
+
+        REQUIRE(*type==Type::Array(Type::INT, true));
+        REQUIRE(*type!=Type::Array(Type::INT));
+        REQUIRE(fakeTypeChecker->calledTimes==1);
+
+    }
+
     SECTION("Throw UnexpectedTokenException when no type for array"){
         TypeParser parser(
             getTokensIterator({
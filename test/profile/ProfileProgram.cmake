@@ -0,0 +1,38 @@
+# Runs an Ain program on the interpreter with the sampling profiler and checks that the expected text
+# is found in what it printed or in the flat profile it wrote
+# cmake -DAIN=<ain> -DAIN_STD=<ainstd/> -DPROGRAM=<name.ain> -DEXPECTED=<name.expected> -DWORK_DIR=<dir> -P ProfileProgram.cmake
+
+get_filename_component(NAME ${PROGRAM} NAME_WE)
+set(SOURCE ${WORK_DIR}/${NAME}.ain)
+set(PROFILE ${WORK_DIR}/${NAME}.profile)
+
+file(MAKE_DIRECTORY ${WORK_DIR})
+file(COPY_FILE ${PROGRAM} ${SOURCE})
+file(REMOVE ${PROFILE})
+
+set(ENV{AIN_STD} ${AIN_STD})
+execute_process(
+    COMMAND ${AIN} --profile ${SOURCE}
+    OUTPUT_VARIABLE OUTPUT
+    ERROR_VARIABLE OUTPUT
+    RESULT_VARIABLE RESULT
+    TIMEOUT 60
+)
+
+# The errors are printed without failing, so a non zero result means that the interpreter crashed
+if(NOT RESULT EQUAL 0)
+    message(FATAL_ERROR "Profiling ${NAME}.ain exited with ${RESULT}:\n${OUTPUT}")
+endif()
+
+if(EXISTS ${PROFILE})
+    file(READ ${PROFILE} FLAT_PROFILE)
+    string(APPEND OUTPUT ${FLAT_PROFILE})
+endif()
+
+file(READ ${EXPECTED} EXPECTED_OUTPUT)
+string(STRIP "${EXPECTED_OUTPUT}" EXPECTED_OUTPUT)
+string(FIND "${OUTPUT}" "${EXPECTED_OUTPUT}" EXPECTED_INDEX)
+
+if(EXPECTED_INDEX EQUAL -1)
+    message(FATAL_ERROR "Profiling ${NAME}.ain output:\n${OUTPUT}\nExpected to find:\n${EXPECTED_OUTPUT}")
+endif()
@@ -0,0 +1,49 @@
+# Compiles an Ain program, runs it and compares its output with the expected output
+# A program that is expected to stop with an error has its exit code in a .result file next to the .expected file
+# cmake -DAIN=<ain> -DAIN_STD=<ainstd/> -DPROGRAM=<name.ain> -DEXPECTED=<name.expected> -DWORK_DIR=<dir> [-DFLAGS=<flags>] -P RunProgram.cmake
+
+get_filename_component(NAME ${PROGRAM} NAME_WE)
+set(SOURCE ${WORK_DIR}/${NAME}.ain)
+set(EXECUTABLE ${WORK_DIR}/${NAME})
+
+# The executable is written next to the source, so the program is copied to the build directory
+file(MAKE_DIRECTORY ${WORK_DIR})
+file(COPY_FILE ${PROGRAM} ${SOURCE})
+file(REMOVE ${EXECUTABLE})
+
+set(ENV{AIN_STD} ${AIN_STD})
+execute_process(
+    COMMAND ${AIN} ${FLAGS} ${SOURCE}
+    OUTPUT_VARIABLE COMPILE_OUTPUT
+    ERROR_VARIABLE COMPILE_OUTPUT
+)
+
+# The compiler prints its errors without failing, so the executable is checked instead
+if(NOT EXISTS ${EXECUTABLE})
+    message(FATAL_ERROR "Compiling ${NAME}.ain failed:\n${COMPILE_OUTPUT}")
+endif()
+
+execute_process(
+    COMMAND ${EXECUTABLE}
+    OUTPUT_VARIABLE OUTPUT
+    ERROR_VARIABLE OUTPUT
+    RESULT_VARIABLE RESULT
+    TIMEOUT 60
+)
+
+get_filename_component(EXPECTED_DIR ${EXPECTED} DIRECTORY)
+set(EXPECTED_RESULT 0)
+if(EXISTS ${EXPECTED_DIR}/${NAME}.result)
+    file(READ ${EXPECTED_DIR}/${NAME}.result EXPECTED_RESULT)
+    string(STRIP "${EXPECTED_RESULT}" EXPECTED_RESULT)
+endif()
+
+if(NOT RESULT EQUAL EXPECTED_RESULT)
+    message(FATAL_ERROR "${NAME} exited with ${RESULT} instead of ${EXPECTED_RESULT}:\n${OUTPUT}")
+endif()
+
+file(READ ${EXPECTED} EXPECTED_OUTPUT)
+
+if(NOT OUTPUT STREQUAL EXPECTED_OUTPUT)
+    message(FATAL_ERROR "${NAME} output:\n${OUTPUT}\nExpected:\n${EXPECTED_OUTPUT}")
+endif()